@@ -0,0 +1,68 @@
+#include "AdmissionControl.h"
+#include <algorithm>
+#include <cmath>
+
+using namespace std;
+
+
+AdmissionControl::AdmissionControl() {
+    drainRate = 0;
+    windowStart = chrono::steady_clock::now();
+    windowCompleted = 0;
+    windowShed = 0;
+    recentShed = 0;
+}
+
+
+bool AdmissionControl::admit(size_t depth, unsigned int &retryAfter) {
+    stats.depth = depth;
+    stats.maximumDepth = max(stats.maximumDepth, depth);
+    if (depth < stats.limit) {
+        stats.admitted++;
+        return true;
+    }
+
+    // the client comes back once the journal drained the registrations in flight and the ones refused lately,
+    // which come back as well, so the retries of a burst are spread instead of arriving together
+    double milliseconds = drainRate > 0 ? (depth + recentShed) / drainRate : ADMISSION_WINDOW_MS;
+    retryAfter = (unsigned int) min<double>(ADMISSION_MAXIMUM_RETRY_MS, max(1.0, ceil(milliseconds)));
+    stats.shed++;
+    windowShed++;
+    return false;
+}
+
+
+void AdmissionControl::completed() {
+    windowCompleted++;
+}
+
+
+void AdmissionControl::update(chrono::steady_clock::time_point now) {
+    double elapsed = chrono::duration<double, milli>(now - windowStart).count();
+    if (elapsed < ADMISSION_WINDOW_MS)
+        return;
+
+    // a window without registrations says nothing of the journal, the rate of the busy ones is kept
+    if (windowCompleted > 0) {
+        double rate = windowCompleted / elapsed;
+        drainRate = drainRate > 0 ? (drainRate + rate) / 2 : rate;
+
+        // only a window which refused registrations kept the journal busy, its rate is what the journal can take;
+        // the queue it drains in the target is the limit (Little's law), moved by at most a factor 2 per window
+        if (windowShed > 0) {
+            double limit = rate * ADMISSION_TARGET_MICROSECONDS / 1000;
+            limit = min<double>(stats.limit * 2, max<double>(stats.limit / 2, limit));
+            stats.limit = min(ADMISSION_MAXIMUM_LIMIT, max(ADMISSION_MINIMUM_LIMIT, (size_t) limit));
+        }
+    }
+
+    windowStart = now;
+    windowCompleted = 0;
+    recentShed = windowShed;
+    windowShed = 0;
+}
+
+
+const AdmissionStats &AdmissionControl::getStats() const {
+    return stats;
+}
@@ -0,0 +1,127 @@
+/**
+
+    @file AdmissionControl.h
+    @brief Declaration of the AdmissionControl class and its member functions.
+
+    This file contains the declaration of the AdmissionControl class, which bounds the registrations in flight on
+    the server and refuses the others with a time after which the client should try again.
+
+    date 18 Oct 2026
+
+    When the registration opens, the clients send far more registrations than the journal can make durable. Without
+    a bound every one of them is applied and waits in the group commits, the queue of the waiter grows and every
+    answer, the lookups too, takes as long as the whole queue. The server asks its AdmissionControl before each
+    registration (through the AdmissionHook of the processors): the registration is applied only while fewer than
+    the limit are waiting for the journal, otherwise it is answered ERR RETRY_AFTER <ms> (BINARY_RETRY_AFTER in
+    the binary protocol) without touching the registry, which costs less than a lookup.
+
+    The limit adapts to the disk. Past its capacity the journal makes a steady number of registrations durable per
+    millisecond, whatever the number waiting, so the wait grows with the queue (Little's law: wait = queue / rate).
+    Every ADMISSION_WINDOW_MS in which registrations were refused, the journal was kept busy and the registrations
+    it made durable give its rate: the limit becomes the queue drained in ADMISSION_TARGET_MICROSECONDS. The
+    registrations let in then wait about the target however many more are sent, and the journal still makes as
+    many durable. The retry-after is the time the journal needs, at the same rate, to drain the queue and the
+    registrations refused in the last window, which will come back too: the retries of a burst ten times what the
+    journal takes are spread over about ten windows instead of coming back together.
+
+    Public Member Functions:
+        1. AdmissionControl()
+        2. admit(size_t, unsigned int &): bool
+        3. completed(): void
+        4. update(chrono::steady_clock::time_point): void
+        5. getStats() const: const AdmissionStats &
+*/
+
+#ifndef DSPROJ_ADMISSIONCONTROL_H
+#define DSPROJ_ADMISSIONCONTROL_H
+
+#include <chrono>
+#include <cstddef>
+#include <functional>
+
+using namespace std;
+
+// registrations let in at once before the first window is measured
+const size_t ADMISSION_INITIAL_LIMIT = 1024;
+
+// bounds of the adapted limit
+const size_t ADMISSION_MINIMUM_LIMIT = 16;
+const size_t ADMISSION_MAXIMUM_LIMIT = 64 * 1024;
+
+// the registrations let in should wait about this long on average for the journal; more than the group commit of
+// an idle journal, or the limit would shrink the groups and the journal with them
+const double ADMISSION_TARGET_MICROSECONDS = 5000;
+
+// the limit is adapted this often
+const int ADMISSION_WINDOW_MS = 100;
+
+// a client is never told to wait longer than this
+const unsigned int ADMISSION_MAXIMUM_RETRY_MS = 1000;
+
+// called by a processor before a registration: true to apply it, false with the milliseconds after which the
+// client should try again
+typedef function<bool(unsigned int &)> AdmissionHook;
+
+// what the admission control did since it started
+struct AdmissionStats {
+    unsigned long long admitted = 0;    // registrations let in
+    unsigned long long shed = 0;        // registrations answered with a retry-after
+    size_t depth = 0;                   // registrations waiting for the journal at the last admission
+    size_t maximumDepth = 0;
+    size_t limit = ADMISSION_INITIAL_LIMIT;
+};
+
+class AdmissionControl {
+public:
+
+    /**
+ * @brief Constructor for the AdmissionControl class.
+ *
+ * @pre None.
+ *
+ * @post The limit is ADMISSION_INITIAL_LIMIT and the first window starts.
+ */
+    AdmissionControl();
+
+    /**
+ * @brief Decide if a registration is applied.
+ *
+ * @param depth The registrations waiting for the journal now.
+ * @param retryAfter Set, when refused, to the milliseconds after which the client should try again, from 1 to
+ *        ADMISSION_MAXIMUM_RETRY_MS.
+ * @return bool True if fewer registrations than the limit are waiting.
+ */
+    bool admit(size_t, unsigned int &);
+
+    /**
+ * @brief Count a registration made durable.
+ */
+    void completed();
+
+    /**
+ * @brief Adapt the limit when the window is over.
+ *
+ * @param now The current time, the window ends ADMISSION_WINDOW_MS after it started.
+ *
+ * @post The limit stays between ADMISSION_MINIMUM_LIMIT and ADMISSION_MAXIMUM_LIMIT.
+ */
+    void update(chrono::steady_clock::time_point);
+
+    /**
+ * @brief Get the counters and the limit.
+ *
+ * @return const AdmissionStats & The counters since the construction.
+ */
+    const AdmissionStats &getStats() const;
+
+private:
+    AdmissionStats stats;
+    double drainRate;                                   // registrations made durable per millisecond, 0 until known
+    chrono::steady_clock::time_point windowStart;
+    unsigned long long windowCompleted;                 // registrations made durable in the window
+    unsigned long long windowShed;                      // registrations refused in the window
+    unsigned long long recentShed;                      // registrations refused in the window before
+
+};
+
+#endif //DSPROJ_ADMISSIONCONTROL_H
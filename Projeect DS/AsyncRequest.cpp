@@ -0,0 +1,172 @@
+#include "AsyncRequest.h"
+#include <algorithm>
+#include <cmath>
+#include <map>
+#include <iostream>
+#include <csignal>
+#include <unistd.h>
+#include <sys/eventfd.h>
+
+using namespace std;
+
+
+bool JournalWaiter::DurableAwaiter::await_ready() const {
+    return sequence == 0 || registry.getJournal().getDurableSequence() >= sequence;
+}
+
+
+void JournalWaiter::DurableAwaiter::await_suspend(coroutine_handle<> handle) {
+    lock_guard<mutex> lock(waiter.waiterMutex);
+    waiter.queued.push_back(Waiting{&registry, sequence, handle, &isDurable});
+    waiter.waiting++;
+    waiter.queuedReady.notify_one();
+}
+
+
+JournalWaiter::JournalWaiter() {
+    waiting = 0;
+    stopping = false;
+    eventDescriptor = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    if (eventDescriptor == -1)
+        cerr << "The event descriptor of the journal waiter can't be created." << endl;
+    syncThread = thread(&JournalWaiter::sync, this);
+}
+
+
+JournalWaiter::~JournalWaiter() {
+    {
+        lock_guard<mutex> lock(waiterMutex);
+        stopping = true;
+    }
+    queuedReady.notify_one();
+    syncThread.join();
+    if (eventDescriptor != -1)
+        close(eventDescriptor);
+}
+
+
+JournalWaiter::DurableAwaiter JournalWaiter::durable(Registry &registry, unsigned long long sequence) {
+    return DurableAwaiter{*this, registry, sequence};
+}
+
+
+int JournalWaiter::getEventDescriptor() const {
+    return eventDescriptor;
+}
+
+
+int JournalWaiter::resumeCompleted() {
+    // the counter of the eventfd is reset, it is already 0 when drain() took the coroutines signaled
+    unsigned long long signals;
+    ssize_t length = read(eventDescriptor, &signals, sizeof(signals));
+    (void) length;
+
+    vector<Waiting> ready;
+    {
+        lock_guard<mutex> lock(waiterMutex);
+        ready.swap(completed);
+        waiting -= ready.size();
+    }
+
+    // a resumed coroutine may suspend again, it is then queued behind the ones taken here
+    for (Waiting &item: ready)
+        item.handle.resume();
+    return ready.size();
+}
+
+
+void JournalWaiter::drain() {
+    while (true) {
+        {
+            unique_lock<mutex> lock(waiterMutex);
+            if (waiting == 0)
+                return;
+            completedReady.wait(lock, [this]() { return !completed.empty(); });
+        }
+        resumeCompleted();
+    }
+}
+
+
+size_t JournalWaiter::getWaiting() const {
+    lock_guard<mutex> lock(waiterMutex);
+    return waiting;
+}
+
+
+void JournalWaiter::sync() {
+    // SIGINT and SIGTERM are read by the loop of the server from a signalfd, they must never stop this thread
+    sigset_t signals;
+    sigfillset(&signals);
+    pthread_sigmask(SIG_BLOCK, &signals, nullptr);
+
+    unique_lock<mutex> lock(waiterMutex);
+    while (true) {
+        queuedReady.wait(lock, [this]() { return stopping || !queued.empty(); });
+        if (queued.empty())
+            return;
+
+        vector<Waiting> group;
+        group.swap(queued);
+        lock.unlock();
+
+        // the records of a journal are synced in order, so waiting for the highest sequence covers the others; the
+        // registrations applied meanwhile join the group commit of the journal and are taken at the next round
+        map<Registry *, unsigned long long> highest;
+        for (const Waiting &item: group)
+            highest[item.registry] = max(highest[item.registry], item.sequence);
+        // when a sync fails, the journal stops and only the records synced before it are durable
+        for (auto itr = highest.begin(); itr != highest.end(); ++itr)
+            itr->first->waitDurable(itr->second);
+        for (const Waiting &item: group)
+            *item.isDurable = item.registry->getJournal().getDurableSequence() >= item.sequence;
+
+        lock.lock();
+        completed.insert(completed.end(), group.begin(), group.end());
+        completedReady.notify_all();
+        unsigned long long signal = 1;
+        if (write(eventDescriptor, &signal, sizeof(signal)) < 0)
+            cerr << "The journal waiter can't signal the loop." << endl;
+    }
+}
+
+
+LatencyHistogram::LatencyHistogram() : buckets(LATENCY_BUCKETS_PER_DOUBLING * LATENCY_DOUBLINGS + 1, 0) {
+    count = 0;
+}
+
+
+void LatencyHistogram::record(double microseconds, unsigned long long requests) {
+    size_t bucket = 0;
+    if (microseconds > 1)
+        bucket = min(buckets.size() - 1, (size_t) (log2(microseconds) * LATENCY_BUCKETS_PER_DOUBLING) + 1);
+    buckets[bucket] += requests;
+    count += requests;
+}
+
+
+double LatencyHistogram::percentile(double percent) const {
+    if (count == 0)
+        return 0;
+
+    unsigned long long rank = max(1.0, ceil(count * percent / 100));
+    unsigned long long seen = 0;
+    size_t bucket = 0;
+    for (; bucket + 1 < buckets.size(); bucket++) {
+        seen += buckets[bucket];
+        if (seen >= rank)
+            break;
+    }
+    return exp2((double) bucket / LATENCY_BUCKETS_PER_DOUBLING);
+}
+
+
+unsigned long long LatencyHistogram::getCount() const {
+    return count;
+}
+
+
+void LatencyHistogram::clear() {
+    fill(buckets.begin(), buckets.end(), 0);
+    count = 0;
+}
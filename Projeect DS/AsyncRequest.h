@@ -0,0 +1,247 @@
+/**
+
+    @file AsyncRequest.h
+    @brief Declaration of the coroutines answering requests after the journal, and of the latency histogram.
+
+    This file contains RequestTask, the return type of the coroutines of the server, the JournalWaiter class which
+    suspends them until the journal records of a registration are durable, and the LatencyHistogram class which
+    gives the percentiles of the time taken to answer the requests.
+
+    date 18 Oct 2026
+
+    A registration applied by the loop of the server is answered only once its journal records are synced, but the
+    loop must not wait for the fsync: every other connection would wait with it, and the registrations of the
+    other connections could never join the same group commit. The registration is applied without waiting (the
+    pendingSequence of Registry) and its answer is given to a coroutine which co_awaits JournalWaiter::durable.
+    The coroutine is suspended while a thread of the waiter syncs the journal for every registration waiting,
+    then it is resumed on the loop by resumeCompleted, when the event descriptor of the waiter is readable, and
+    releases its answer. Thousands of registrations are in flight this way on the single thread of the loop.
+
+    A RequestTask starts running at once, like a function, and frees itself when it ends, so a coroutine which
+    doesn't wait costs no more than a call.
+
+    Public Member Functions:
+        JournalWaiter:
+        1. JournalWaiter()
+        2. ~JournalWaiter()
+        3. durable(Registry &, unsigned long long): DurableAwaiter
+        4. getEventDescriptor() const: int
+        5. resumeCompleted(): int
+        6. drain(): void
+        7. getWaiting() const: size_t
+
+        LatencyHistogram:
+        1. LatencyHistogram()
+        2. record(double, unsigned long long): void
+        3. percentile(double) const: double
+        4. getCount() const: unsigned long long
+        5. clear(): void
+*/
+
+#ifndef DSPROJ_ASYNCREQUEST_H
+#define DSPROJ_ASYNCREQUEST_H
+
+#include "Registry.h"
+
+#include <coroutine>
+#include <condition_variable>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace std;
+
+// number of buckets of a LatencyHistogram per doubling of the latency, each bucket is about 2% wide
+const int LATENCY_BUCKETS_PER_DOUBLING = 32;
+
+// a LatencyHistogram counts latencies up to 2^LATENCY_DOUBLINGS microseconds (about 18 minutes)
+const int LATENCY_DOUBLINGS = 30;
+
+// called by a processor when the answer it just appended to output, from answerStart to the end, must only be
+// sent once the journal records of the registration are durable: registry, sequence, output, answerStart
+typedef function<void(Registry &, unsigned long long, string &, size_t)> DurabilityHook;
+
+// return type of a coroutine answering a request: it starts at once and frees itself at its end
+struct RequestTask {
+    struct promise_type {
+        RequestTask get_return_object() {
+            return RequestTask();
+        }
+
+        suspend_never initial_suspend() noexcept {
+            return suspend_never();
+        }
+
+        suspend_never final_suspend() noexcept {
+            return suspend_never();
+        }
+
+        void return_void() {}
+
+        void unhandled_exception() {
+            terminate();
+        }
+    };
+};
+
+class JournalWaiter {
+public:
+
+    // co_awaited by a coroutine until the records of a registration are durable, gives false if the journal
+    // failed to write them
+    struct DurableAwaiter {
+        JournalWaiter &waiter;
+        Registry &registry;
+        unsigned long long sequence;
+        bool isDurable = true;      // set by the thread of the waiter before the coroutine is resumed
+
+        // no suspension when nothing was journaled or the records were already synced
+        bool await_ready() const;
+
+        void await_suspend(coroutine_handle<>);
+
+        bool await_resume() const {
+            return isDurable;
+        }
+    };
+
+    /**
+ * @brief Constructor for the JournalWaiter class.
+ *
+ * @pre None.
+ *
+ * @post The thread syncing the journals is started and waits for coroutines.
+ */
+    JournalWaiter();
+
+    /**
+ * @brief Destructor for the JournalWaiter class.
+ *
+ * @pre No coroutine waits, see drain().
+ *
+ * @post The thread is stopped and joined, the event descriptor is closed.
+ */
+    ~JournalWaiter();
+
+    JournalWaiter(const JournalWaiter &) = delete;
+    JournalWaiter &operator=(const JournalWaiter &) = delete;
+
+    /**
+ * @brief Get an awaiter suspending a coroutine until journal records are durable.
+ *
+ * @param registry The registry which journaled the records.
+ * @param sequence The pendingSequence of the registration, 0 when nothing was journaled.
+ * @return DurableAwaiter To co_await, the coroutine is then resumed by resumeCompleted(). The co_await gives
+ *         true if the records are durable, false if writing the journal failed and they may be lost.
+ */
+    DurableAwaiter durable(Registry &, unsigned long long);
+
+    /**
+ * @brief Get the descriptor which is readable when suspended coroutines can be resumed.
+ *
+ * @return int An eventfd, to register in the epoll instance of the loop.
+ */
+    int getEventDescriptor() const;
+
+    /**
+ * @brief Resume the coroutines whose records are durable, on the calling thread.
+ *
+ * @return int The number of coroutines resumed.
+ *
+ * @pre Called by the thread which suspended the coroutines.
+ *
+ * @post The coroutines resumed ran until their end or their next suspension, in the order they were suspended.
+ */
+    int resumeCompleted();
+
+    /**
+ * @brief Wait for every suspended coroutine and resume them.
+ *
+ * @pre Called by the thread which suspended the coroutines, eg: when the server stops.
+ *
+ * @post getWaiting() returns 0.
+ */
+    void drain();
+
+    /**
+ * @brief Get the number of suspended coroutines.
+ *
+ * @return size_t The coroutines waiting for the journal or to be resumed.
+ */
+    size_t getWaiting() const;
+
+private:
+    // a suspended coroutine and what it waits for
+    struct Waiting {
+        Registry *registry;
+        unsigned long long sequence;
+        coroutine_handle<> handle;
+        bool *isDurable;           // in the awaiter, which lives in the frame of the suspended coroutine
+    };
+
+    // Loop of the thread: wait for the highest sequence of each registry, then hand the coroutines to the loop
+    void sync();
+
+    int eventDescriptor;
+    vector<Waiting> queued;        // suspended, their records may not be durable yet
+    vector<Waiting> completed;     // durable, waiting for resumeCompleted
+    size_t waiting;                // queued, being synced or completed
+    bool stopping;
+    mutable mutex waiterMutex;     // protects the four fields above
+    condition_variable queuedReady;
+    condition_variable completedReady;
+    thread syncThread;
+
+};
+
+class LatencyHistogram {
+public:
+
+    /**
+ * @brief Constructor for the LatencyHistogram class.
+ *
+ * @pre None.
+ *
+ * @post No latency is counted.
+ */
+    LatencyHistogram();
+
+    /**
+ * @brief Count latencies.
+ *
+ * @param microseconds The latency.
+ * @param count The number of requests which took this long.
+ */
+    void record(double, unsigned long long count = 1);
+
+    /**
+ * @brief Get a percentile of the latencies counted.
+ *
+ * @param percent The percentage of the requests, eg: 50, 99 or 99.9.
+ * @return double The latency in microseconds that this percentage of the requests didn't exceed, rounded up
+ *         to the bound of its bucket, 0 when nothing was counted.
+ */
+    double percentile(double) const;
+
+    /**
+ * @brief Get the number of latencies counted.
+ *
+ * @return unsigned long long The sum of the counts given to record().
+ */
+    unsigned long long getCount() const;
+
+    /**
+ * @brief Forget every latency counted, eg: every second for the report of the server.
+ */
+    void clear();
+
+private:
+    vector<unsigned long long> buckets;    // bucket i > 0 counts [2^((i - 1) / 32), 2^(i / 32)) microseconds
+    unsigned long long count;
+
+};
+
+#endif //DSPROJ_ASYNCREQUEST_H
@@ -0,0 +1,311 @@
+#include "BinaryProtocol.h"
+#include <cctype>
+#include <algorithm>
+
+using namespace std;
+
+
+// Reads the fields of a request frame, failing instead of reading past its end
+struct FrameReader {
+    const unsigned char *data;
+    size_t length;
+    size_t position;
+    bool failed;
+
+    FrameReader(const unsigned char *data, size_t length) : data(data), length(length) {
+        position = 0;
+        failed = false;
+    }
+
+    unsigned long long read(size_t bytes) {
+        if (failed || length - position < bytes) {
+            failed = true;
+            return 0;
+        }
+        unsigned long long value = 0;
+        for (size_t i = 0; i < bytes; i++)
+            value |= (unsigned long long) data[position + i] << (8 * i);
+        position += bytes;
+        return value;
+    }
+
+    // the whole frame was read and nothing is left
+    bool complete() const {
+        return !failed && position == length;
+    }
+};
+
+
+// Append an integer of a number of bytes, little endian
+static void appendInteger(string &output, unsigned long long value, size_t bytes) {
+    for (size_t i = 0; i < bytes; i++)
+        output += (char) (value >> (8 * i) & 0xFF);
+}
+
+
+// Start a response frame, its length is written by endFrame
+static size_t beginFrame(string &output, unsigned char status) {
+    size_t start = output.length();
+    appendInteger(output, 0, BINARY_LENGTH_BYTES);
+    output += (char) status;
+    return start;
+}
+
+
+static void endFrame(string &output, size_t start) {
+    unsigned long long length = output.length() - start - BINARY_LENGTH_BYTES;
+    for (size_t i = 0; i < BINARY_LENGTH_BYTES; i++)
+        output[start + i] = (char) (length >> (8 * i) & 0xFF);
+}
+
+
+bool packStudentId(const string &studentId, unsigned int &packed) {
+    if (studentId.length() < 2 || studentId.length() > 8 || studentId[0] < 'A' || studentId[0] > 'Z')
+        return false;
+
+    unsigned int number = 0;
+    for (size_t i = 1; i < studentId.length(); i++) {
+        if (!isdigit((unsigned char) studentId[i]))
+            return false;
+        number = number * 10 + (studentId[i] - '0');
+    }
+    packed = (unsigned int) (studentId[0] - 'A') << 27 | number;
+    return true;
+}
+
+
+string unpackStudentId(unsigned int packed) {
+    string studentId(8, '0');
+    studentId[0] = (char) ('A' + (packed >> 27));
+    unsigned int number = packed & ((1u << 27) - 1);
+    for (int i = 7; i >= 1; i--, number /= 10)
+        studentId[i] = (char) ('0' + number % 10);
+    return studentId;
+}
+
+
+bool packCourseCode(const string &courseCode, unsigned long long &packed) {
+    if (courseCode.empty() || courseCode.length() > 8)
+        return false;
+
+    packed = 0;
+    for (size_t i = 0; i < courseCode.length(); i++)
+        packed |= (unsigned long long) (unsigned char) courseCode[i] << (8 * i);
+    return true;
+}
+
+
+string unpackCourseCode(unsigned long long packed) {
+    string courseCode;
+    for (; packed != 0; packed >>= 8)
+        courseCode += (char) (packed & 0xFF);
+    return courseCode;
+}
+
+
+void appendStatusFrame(string &output, unsigned char status) {
+    endFrame(output, beginFrame(output, status));
+}
+
+
+BinaryProcessor::BinaryProcessor(TermDirectory &terms) : pool(terms.getPool()) {
+    term = &terms.getCurrentTerm();
+    requests = 0;
+    broken = false;
+}
+
+
+size_t BinaryProcessor::consume(const char *data, size_t length, string &output) {
+    const unsigned char *bytes = (const unsigned char *) data;
+    size_t position = 0;
+    vector<pair<size_t, size_t>> frames;   // start and length of every complete frame, without its length
+
+    while (!broken && length - position >= BINARY_LENGTH_BYTES) {
+        FrameReader header(bytes + position, BINARY_LENGTH_BYTES);
+        unsigned long long frameLength = header.read(BINARY_LENGTH_BYTES);
+        if (frameLength == 0 || frameLength > BINARY_FRAME_LIMIT) {
+            broken = true;
+            break;
+        }
+        if (length - position - BINARY_LENGTH_BYTES < frameLength)
+            break; // the rest of the frame is still on its way
+
+        frames.emplace_back(position + BINARY_LENGTH_BYTES, frameLength);
+        position += BINARY_LENGTH_BYTES + frameLength;
+    }
+
+    size_t next = 0;
+    while (next < frames.size()) {
+        size_t end = next;
+        while (end < frames.size() && isLookup(bytes + frames[end].first))
+            end++;
+
+        if (end - next >= PARALLEL_RUN_LENGTH && pool.getNumberOfThreads() > 1) {
+            vector<string> responses(end - next);
+            size_t first = next;
+            pool.parallelFor(end - next, PARALLEL_CHUNK_REQUESTS, [&](size_t begin, size_t last) {
+                for (size_t i = begin; i < last; i++)
+                    answer(bytes + frames[first + i].first, frames[first + i].second, responses[i]);
+            });
+            for (const string &response: responses)
+                output += response;
+            next = end;
+            continue;
+        }
+
+        // a short run of lookups, or a registration, is answered on this thread
+        for (end = max(end, next + 1); next < end; next++) {
+            size_t answerStart = output.length();
+            unsigned long long pendingSequence = 0;
+            answer(bytes + frames[next].first, frames[next].second, output,
+                   durabilityHook ? &pendingSequence : nullptr);
+            if (pendingSequence != 0)
+                durabilityHook(*term->registry, pendingSequence, output, answerStart);
+        }
+    }
+
+    requests += frames.size();
+    return position;
+}
+
+
+unsigned long long BinaryProcessor::getRequests() const {
+    return requests;
+}
+
+
+bool BinaryProcessor::isBroken() const {
+    return broken;
+}
+
+
+void BinaryProcessor::setDurabilityHook(const DurabilityHook &hook) {
+    durabilityHook = hook;
+}
+
+
+void BinaryProcessor::setAdmissionHook(const AdmissionHook &hook) {
+    admissionHook = hook;
+}
+
+
+bool BinaryProcessor::isLookup(const unsigned char *frame) {
+    return frame[0] == BINARY_PING || frame[0] == BINARY_STUDENT || frame[0] == BINARY_COURSE ||
+           frame[0] == BINARY_ROSTER;
+}
+
+
+bool BinaryProcessor::isShed(string &output) const {
+    unsigned int retryAfter = 0;
+    if (!admissionHook || admissionHook(retryAfter))
+        return false;
+    size_t start = beginFrame(output, BINARY_RETRY_AFTER);
+    appendInteger(output, retryAfter, 4);
+    endFrame(output, start);
+    return true;
+}
+
+
+void BinaryProcessor::answer(const unsigned char *frame, size_t length, string &output,
+                             unsigned long long *pendingSequence) const {
+    Registry &registry = *term->registry;
+    FrameReader request(frame, length);
+    unsigned char opcode = request.read(1);
+
+    switch (opcode) {
+        case BINARY_PING: {
+            if (!request.complete())
+                break;
+            endFrame(output, beginFrame(output, REGISTRATION_OK));
+            return;
+        }
+        case BINARY_STUDENT: {
+            string studentId = unpackStudentId(request.read(4));
+            if (!request.complete())
+                break;
+
+            Student *student = registry.findStudent(studentId);
+            size_t start = beginFrame(output, student == nullptr ? STUDENT_NOT_FOUND : REGISTRATION_OK);
+            if (student != nullptr) {
+                vector<string> &courseCodes = student->getRegisteredCourse();
+                appendInteger(output, (unsigned long long) (student->getGpa() * 100 + 0.5), 2);
+                appendInteger(output, student->getNumberOfcredits(), 2);
+                appendInteger(output, courseCodes.size(), 1);
+                for (const string &courseCode: courseCodes) {
+                    unsigned long long packed = 0;
+                    packCourseCode(courseCode, packed);
+                    appendInteger(output, packed, 8);
+                }
+            }
+            endFrame(output, start);
+            return;
+        }
+        case BINARY_COURSE:
+        case BINARY_ROSTER: {
+            string courseCode = unpackCourseCode(request.read(8));
+            if (!request.complete())
+                break;
+
+            Course *course = registry.findCourse(courseCode);
+            size_t start = beginFrame(output, course == nullptr ? COURSE_NOT_FOUND : REGISTRATION_OK);
+            if (course != nullptr && opcode == BINARY_COURSE) {
+                appendInteger(output, course->getNumberOfEnrolled(), 4);
+                appendInteger(output, course->getCapacity(), 4);
+                appendInteger(output, course->getNumberOfCredits(), 2);
+            } else if (course != nullptr) {
+                const map<string, string> &registeredStudents = course->getRegisteredStudents();
+                appendInteger(output, registeredStudents.size(), 4);
+                for (auto itr = registeredStudents.begin(); itr != registeredStudents.end(); ++itr) {
+                    unsigned int packed = UNPACKABLE_STUDENT_ID;
+                    packStudentId(itr->first, packed);
+                    appendInteger(output, packed, 4);
+                }
+            }
+            endFrame(output, start);
+            return;
+        }
+        case BINARY_REGISTER: {
+            string studentId = unpackStudentId(request.read(4));
+            unsigned int count = request.read(1);
+            vector<string> bundle;
+            for (unsigned int i = 0; i < count; i++)
+                bundle.push_back(unpackCourseCode(request.read(8)));
+            if (!request.complete() || bundle.empty())
+                break;
+            if (isShed(output))
+                return;
+
+            string failedCourse;
+            RegistrationResult result = registry.registerBundle(studentId, bundle, failedCourse, pendingSequence);
+            size_t start = beginFrame(output, result);
+            if (result != REGISTRATION_OK && result != JOURNAL_FAILED) {
+                unsigned long long packed = 0;
+                packCourseCode(failedCourse, packed);
+                appendInteger(output, packed, 8);
+            }
+            endFrame(output, start);
+            return;
+        }
+        case BINARY_ADD:
+        case BINARY_DROP: {
+            string studentId = unpackStudentId(request.read(4));
+            string courseCode = unpackCourseCode(request.read(8));
+            if (!request.complete())
+                break;
+            if (isShed(output))
+                return;
+
+            RegistrationResult result = opcode == BINARY_ADD ? registry.addCourse(studentId, courseCode, pendingSequence)
+                                                             : registry.dropCourse(studentId, courseCode,
+                                                                                   pendingSequence);
+            endFrame(output, beginFrame(output, result));
+            return;
+        }
+        default:
+            endFrame(output, beginFrame(output, BINARY_UNKNOWN_OPCODE));
+            return;
+    }
+
+    // the fields didn't match the opcode
+    endFrame(output, beginFrame(output, BINARY_BAD_REQUEST));
+}
@@ -0,0 +1,220 @@
+/**
+
+    @file BinaryProtocol.h
+    @brief Declaration of the binary protocol of the registration server and of the BinaryProcessor class.
+
+    This file contains the frames of the binary protocol, the functions packing student IDs and course codes in
+    integers, and the BinaryProcessor class which answers the frames against the open terms.
+
+    date 18 Oct 2026
+
+    A client chooses the binary protocol by sending the byte BINARY_PROTOCOL_HELLO first, instead of a text
+    command. Every request and every response is then a frame: a 4 byte length of the rest of the frame, a one
+    byte opcode (request) or status (response), and the fields of the operation. The integers are little endian,
+    a student ID is packed in 4 bytes (packStudentId) and a course code in 8 (packCourseCode).
+
+    The frames carry no request number: the responses come back in the order of the requests, so a client can
+    write thousands of requests at once and read the responses as they come (pipelining). The server answers
+    every complete frame of what it read and writes the responses with one send. A run of at least
+    PARALLEL_RUN_LENGTH lookups in a row (BINARY_PING to BINARY_ROSTER) is answered on the WorkStealingPool of the
+    directory, each thread into its own responses, which are then appended in the order of the requests. With a
+    DurabilityHook the registrations don't wait for the journal, their responses are given to the hook. With an
+    AdmissionHook a registration refused by the hook is answered BINARY_RETRY_AFTER and changes nothing.
+
+        opcode                   request fields                      response fields when the status is OK
+        BINARY_PING              -                                   -
+        BINARY_STUDENT           student                             gpa * 100 (2), credits (2), n (1), n courses
+        BINARY_COURSE            course                              enrolled (4), capacity (4), credits (2)
+        BINARY_ROSTER            course                              n (4), n students
+        BINARY_REGISTER          student, n (1), n courses           -
+        BINARY_ADD               student, course                     -
+        BINARY_DROP              student, course                     -
+
+    The status is a RegistrationResult, or BINARY_BAD_REQUEST / BINARY_UNKNOWN_OPCODE / BINARY_RETRY_AFTER. A
+    refused BINARY_REGISTER is followed by the course that was refused, BINARY_RETRY_AFTER by the milliseconds
+    after which the client should send the registration again (4). JOURNAL_FAILED is followed by nothing, it also
+    replaces the answer of a change whose records the journal failed to sync, see RegistrationServer.
+
+    Free Functions:
+        1. packStudentId(const string &, unsigned int &): bool
+        2. unpackStudentId(unsigned int): string
+        3. packCourseCode(const string &, unsigned long long &): bool
+        4. unpackCourseCode(unsigned long long): string
+        5. appendStatusFrame(string &, unsigned char): void
+
+    Public Member Functions:
+        1. BinaryProcessor(TermDirectory &)
+        2. consume(const char *, size_t, string &): size_t
+        3. getRequests() const: unsigned long long
+        4. isBroken() const: bool
+        5. setDurabilityHook(const DurabilityHook &): void
+        6. setAdmissionHook(const AdmissionHook &): void
+*/
+
+#ifndef DSPROJ_BINARYPROTOCOL_H
+#define DSPROJ_BINARYPROTOCOL_H
+
+#include "TermDirectory.h"
+#include "Registry.h"
+#include "AsyncRequest.h"
+#include "AdmissionControl.h"
+
+#include <string>
+
+using namespace std;
+
+// first byte sent by a client speaking the binary protocol, it can't start a text command
+const unsigned char BINARY_PROTOCOL_HELLO = 0xB1;
+
+// a frame announcing more bytes than this is a protocol error, the connection is closed
+const unsigned int BINARY_FRAME_LIMIT = 64 * 1024;
+
+// bytes of the length at the start of every frame
+const size_t BINARY_LENGTH_BYTES = 4;
+
+// operation of a request frame
+enum BinaryOpcode {
+    BINARY_PING = 1,
+    BINARY_STUDENT = 2,
+    BINARY_COURSE = 3,
+    BINARY_ROSTER = 4,
+    BINARY_REGISTER = 5,
+    BINARY_ADD = 6,
+    BINARY_DROP = 7
+};
+
+// statuses of the binary protocol which are not a RegistrationResult
+const unsigned char BINARY_BAD_REQUEST = 100;      // the fields don't match the opcode
+const unsigned char BINARY_UNKNOWN_OPCODE = 101;
+const unsigned char BINARY_RETRY_AFTER = 102;      // the registration was shed, see AdmissionControl
+
+// packed student ID of a student whose ID can't be packed, eg: in a roster
+const unsigned int UNPACKABLE_STUDENT_ID = 0xFFFFFFFF;
+
+/**
+ * @brief Pack a student ID in 4 bytes.
+ *
+ * @param studentId A capital letter followed by at most 7 digits, eg: A2101324.
+ * @param packed Set to the letter in the 5 high bits and the number in the 27 low bits.
+ * @return bool True if the ID has this format.
+ */
+bool packStudentId(const string &studentId, unsigned int &packed);
+
+/**
+ * @brief Unpack a student ID packed by packStudentId.
+ *
+ * @param packed The packed ID.
+ * @return string The student ID with its 7 digits, eg: A2101324.
+ */
+string unpackStudentId(unsigned int packed);
+
+/**
+ * @brief Pack a course code in 8 bytes.
+ *
+ * @param courseCode At most 8 characters, eg: CSIS200.
+ * @param packed Set to the characters from the low byte, the unused bytes are 0.
+ * @return bool True if the code fits.
+ */
+bool packCourseCode(const string &courseCode, unsigned long long &packed);
+
+/**
+ * @brief Unpack a course code packed by packCourseCode.
+ *
+ * @param packed The packed code.
+ * @return string The course code.
+ */
+string unpackCourseCode(unsigned long long packed);
+
+/**
+ * @brief Append a response frame made of a status only.
+ *
+ * @param output The bytes to send.
+ * @param status The status of the frame, eg: JOURNAL_FAILED.
+ */
+void appendStatusFrame(string &output, unsigned char status);
+
+class BinaryProcessor {
+public:
+
+    /**
+ * @brief Constructor for the BinaryProcessor class.
+ *
+ * @param terms The open terms, the frames work on the current one.
+ *
+ * @pre At least one term is open.
+ *
+ * @post No frame was answered yet.
+ */
+    BinaryProcessor(TermDirectory &);
+
+    /**
+ * @brief Answer every complete frame at the start of a buffer.
+ *
+ * @param data The bytes received, starting at a frame.
+ * @param length The number of bytes.
+ * @param output Receives the response frames, in the order of the requests.
+ * @return size_t The number of bytes of the complete frames answered, the rest starts a frame not yet received.
+ *
+ * @pre None.
+ *
+ * @post A frame longer than BINARY_FRAME_LIMIT stops the reading and isBroken() returns true.
+ */
+    size_t consume(const char *, size_t, string &);
+
+    /**
+ * @brief Get the number of frames answered.
+ *
+ * @return unsigned long long The number of requests since the construction.
+ */
+    unsigned long long getRequests() const;
+
+    /**
+ * @brief Check if the client broke the protocol.
+ *
+ * @return bool True if a frame was too long, the connection must be closed.
+ */
+    bool isBroken() const;
+
+    /**
+ * @brief Let consume answer the registrations before their journal records are durable.
+ *
+ * @param hook Called after the response frame of each registration which journaled records is appended.
+ *
+ * @pre None.
+ *
+ * @post The registrations don't wait for the journal.
+ */
+    void setDurabilityHook(const DurabilityHook &);
+
+    /**
+ * @brief Let a hook refuse the registrations when too many are in flight.
+ *
+ * @param hook Called before BINARY_REGISTER, BINARY_ADD and BINARY_DROP are applied.
+ *
+ * @pre None.
+ *
+ * @post A registration refused by the hook is answered BINARY_RETRY_AFTER and changes nothing.
+ */
+    void setAdmissionHook(const AdmissionHook &);
+
+private:
+    // Answer one request frame, without its length, and append the response frame; a registration doesn't wait
+    // for the journal when given a pending sequence
+    void answer(const unsigned char *, size_t, string &, unsigned long long * = nullptr) const;
+
+    // Check if a request frame, without its length, only reads the registry
+    static bool isLookup(const unsigned char *);
+
+    // Append a BINARY_RETRY_AFTER response when the admission hook refuses a registration
+    bool isShed(string &) const;
+
+    Term *term;            // the current term of the directory when the client connected
+    WorkStealingPool &pool;
+    DurabilityHook durabilityHook;   // empty: the registrations wait for the journal
+    AdmissionHook admissionHook;     // empty: every registration is applied
+    unsigned long long requests;
+    bool broken;
+
+};
+
+#endif //DSPROJ_BINARYPROTOCOL_H
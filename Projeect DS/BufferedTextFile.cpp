@@ -0,0 +1,131 @@
+#include "BufferedTextFile.h"
+#include <iostream>
+#include <cstring>
+#include <cstdio>
+#include <cmath>
+#include <algorithm>
+#include <fcntl.h>
+#include <unistd.h>
+
+using namespace std;
+
+
+BufferedTextFile::BufferedTextFile(const string &path) : path(path), temporaryPath(path + ".tmp"),
+                                                         buffer(EXPORT_BUFFER_SIZE) {
+    used = 0;
+    failed = false;
+    fileDescriptor = open(temporaryPath.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    if (fileDescriptor == -1) {
+        cerr << "The file " << temporaryPath << " can't be created." << endl;
+        failed = true;
+    }
+}
+
+
+BufferedTextFile::~BufferedTextFile() {
+    // the file was not committed: the target keeps its previous content
+    if (fileDescriptor != -1) {
+        close(fileDescriptor);
+        remove(temporaryPath.c_str());
+    }
+}
+
+
+bool BufferedTextFile::isOpen() const {
+    return fileDescriptor != -1;
+}
+
+
+void BufferedTextFile::write(const string &text) {
+    write(text.data(), text.length());
+}
+
+
+void BufferedTextFile::write(const char *text, size_t length) {
+    // a text larger than the free space is cut in pieces that fill the buffer
+    while (length > 0) {
+        if (used == buffer.size())
+            flush();
+
+        size_t piece = min(length, buffer.size() - used);
+        memcpy(buffer.data() + used, text, piece);
+        used += piece;
+        text += piece;
+        length -= piece;
+    }
+}
+
+
+void BufferedTextFile::write(char character) {
+    if (used == buffer.size())
+        flush();
+    buffer[used++] = character;
+}
+
+
+void BufferedTextFile::writeInteger(long long value) {
+    char digits[24];
+    int length = 0;
+    unsigned long long magnitude = value < 0 ? -(unsigned long long) value : value;
+
+    // the digits come out from the last one
+    do {
+        digits[length++] = '0' + magnitude % 10;
+        magnitude /= 10;
+    } while (magnitude > 0);
+    if (value < 0)
+        write('-');
+
+    while (length > 0)
+        write(digits[--length]);
+}
+
+
+void BufferedTextFile::writeDecimal(double value) {
+    long long hundredths = llround(value * 100);
+    if (hundredths < 0) {
+        write('-');
+        hundredths = -hundredths;
+    }
+
+    writeInteger(hundredths / 100);
+    write('.');
+    write((char) ('0' + hundredths / 10 % 10));
+    if (hundredths % 10 != 0)
+        write((char) ('0' + hundredths % 10));
+}
+
+
+bool BufferedTextFile::commit() {
+    if (fileDescriptor == -1)
+        return false;
+
+    flush();
+    bool synced = !failed && fsync(fileDescriptor) == 0;
+    close(fileDescriptor);
+    fileDescriptor = -1;
+
+    if (!synced || rename(temporaryPath.c_str(), path.c_str()) != 0) {
+        cerr << "Writing the file " << path << " failed, its previous content is kept." << endl;
+        remove(temporaryPath.c_str());
+        return false;
+    }
+    return true;
+}
+
+
+void BufferedTextFile::flush() {
+    const char *text = buffer.data();
+    size_t length = used;
+    used = 0;
+
+    while (!failed && length > 0) {
+        ssize_t written = ::write(fileDescriptor, text, length);
+        if (written < 0) {
+            failed = true;
+            break;
+        }
+        text += written;
+        length -= written;
+    }
+}
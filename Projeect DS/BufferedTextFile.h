@@ -0,0 +1,132 @@
+/**
+
+    @file BufferedTextFile.h
+    @brief Declaration of the BufferedTextFile class and its member functions.
+
+    This file contains the declaration of the BufferedTextFile class, which writes a text file through one large
+    buffer and puts it in place atomically.
+
+    date 18 Oct 2026
+
+    Writing a data file with operator<< and endl flushes the stream on every line, which means one system call per
+    student. This class collects the text in a buffer of EXPORT_BUFFER_SIZE bytes and only writes it when it is
+    full, and formats the numbers itself. The text goes to a temporary file next to the target, which is synced
+    and renamed over the target by commit(): a reader of the target sees either the previous file or the new
+    complete one, never a half written file.
+
+    Public Member Functions:
+        1. BufferedTextFile(const string &)
+        2. ~BufferedTextFile()
+        3. isOpen() const: bool
+        4. write(const string &): void
+        5. write(const char *, size_t): void
+        6. write(char): void
+        7. writeInteger(long long): void
+        8. writeDecimal(double): void
+        9. commit(): bool
+*/
+
+#ifndef DSPROJ_BUFFEREDTEXTFILE_H
+#define DSPROJ_BUFFEREDTEXTFILE_H
+
+#include <string>
+#include <vector>
+
+using namespace std;
+
+// size of the buffer of a text file, the file is written in blocks of this size
+const size_t EXPORT_BUFFER_SIZE = 1 << 20;
+
+class BufferedTextFile {
+public:
+
+    /**
+ * @brief Constructor for the BufferedTextFile class.
+ *
+ * @param path The path of the file to write, the text is first written to path + ".tmp".
+ *
+ * @pre The directory of the path exists.
+ *
+ * @post The temporary file is created and empty. If it can't be created an error message is printed to the
+ *       standard error stream (cerr) and isOpen() returns false.
+ */
+    BufferedTextFile(const string &);
+
+    /**
+ * @brief Destructor for the BufferedTextFile class.
+ *
+ * @pre None.
+ *
+ * @post If commit() wasn't called or failed, the temporary file is removed and the target is left untouched.
+ */
+    ~BufferedTextFile();
+
+    /**
+ * @brief Check if the temporary file was created.
+ *
+ * @return bool True if the text can be written.
+ */
+    bool isOpen() const;
+
+    /**
+ * @brief Append text to the file.
+ *
+ * @param text The text, copied to the buffer which is written to the file when it is full.
+ */
+    void write(const string &);
+
+    /**
+ * @brief Append characters to the file.
+ *
+ * @param text The first character.
+ * @param length The number of characters.
+ */
+    void write(const char *, size_t);
+
+    /**
+ * @brief Append one character to the file.
+ *
+ * @param character The character, eg: ' ' or '\n'.
+ */
+    void write(char);
+
+    /**
+ * @brief Append an integer written in decimal to the file.
+ *
+ * @param value The integer.
+ */
+    void writeInteger(long long);
+
+    /**
+ * @brief Append a number with at most two decimals to the file, eg: 3.5 or 3.25.
+ *
+ * @param value The number, rounded to two decimals. At least one decimal is written, eg: 3.0.
+ */
+    void writeDecimal(double);
+
+    /**
+ * @brief Write what is left in the buffer, sync the file and rename it over the target.
+ *
+ * @return bool True if the target now holds the whole text.
+ *
+ * @pre The file is open.
+ *
+ * @post On failure an error message is printed to the standard error stream (cerr) and the target is left
+ *       untouched. No text can be written afterwards.
+ */
+    bool commit();
+
+private:
+    // Write the buffer to the file and empty it
+    void flush();
+
+    string path;
+    string temporaryPath;
+    int fileDescriptor;    // -1 when the file is closed
+    vector<char> buffer;   // EXPORT_BUFFER_SIZE bytes
+    size_t used;           // bytes of the buffer holding text
+    bool failed;           // a write failed, the file will not be committed
+
+};
+
+#endif //DSPROJ_BUFFEREDTEXTFILE_H
@@ -0,0 +1,407 @@
+#include "CommandProcessor.h"
+#include "Sharding.h"
+#include <sstream>
+#include <cctype>
+#include <algorithm>
+
+using namespace std;
+
+
+// Split a command in words and put them in upper case, student IDs and course codes are stored in upper case
+static vector<string> splitCommand(const string &line) {
+    vector<string> words;
+    string word;
+    istringstream stream(line);
+    while (stream >> word) {
+        for (char &character: word)
+            character = toupper((unsigned char) character);
+        words.push_back(word);
+    }
+    return words;
+}
+
+
+// Answer of a registration method
+static void appendResult(string &response, RegistrationResult result, const string &detail = "") {
+    if (result == REGISTRATION_OK) {
+        response += "OK";
+        return;
+    }
+    response += "ERR " + resultName(result);
+    if (!detail.empty())
+        response += " " + detail;
+}
+
+
+CommandProcessor::CommandProcessor(TermDirectory &terms) : terms(terms) {
+    term = &terms.getCurrentTerm();
+    finished = false;
+    deferDurability = false;
+    pendingRegistry = nullptr;
+    pendingSequence = 0;
+}
+
+
+bool CommandProcessor::execute(const string &line, string &response) {
+    response.clear();
+    vector<string> args = splitCommand(line);
+    if (args.empty() || args[0][0] == '#')
+        return false;
+
+    const string &command = args[0];
+    if (finished)
+        response = "ERR UNKNOWN_COMMAND " + command;
+    else if (command == "REGISTER")
+        registerBundle(args, response);
+    else if (command == "ADD" || command == "DROP")
+        changeCourse(args, response);
+    else if (command == "STUDENT")
+        describeStudent(args, response);
+    else if (command == "COURSE")
+        describeCourse(args, response);
+    else if (command == "ROSTER")
+        listRoster(args, response);
+    else if (command == "TERM")
+        switchTerm(args, response);
+    else if (command == "CHECKPOINT")
+        startCheckpoint(args, response);
+    else if (command == "STATS")
+        describeStats(args, response);
+    else if (command == "PING")
+        response = "OK";
+    else if (command == "SHARD")
+        findShard(args, response);
+    else if (command == "FIND")
+        findRows(args, response);
+    else if (command == "QUIT") {
+        response = "OK";
+        finished = true;
+    } else
+        response = "ERR UNKNOWN_COMMAND " + command;
+
+    stats.commands++;
+    if (response.compare(0, 3, "ERR") == 0)
+        stats.errors++;
+    return true;
+}
+
+
+unsigned long long CommandProcessor::run(istream &in, ostream &out) {
+    unsigned long long answered = 0;
+    string line, output;
+    vector<string> lines;
+    // a stream tied to the output would flush it before every line read
+    ostream *tied = in.tie(nullptr);
+
+    while (!finished) {
+        // the answers waiting in the buffer are sent before blocking for the next command
+        if (in.rdbuf()->in_avail() <= 0)
+            out.flush();
+
+        // the lines already received are run together, without waiting for more
+        lines.clear();
+        while (lines.size() < COMMAND_BATCH_LINES && getline(in, line)) {
+            if (!line.empty() && line[line.length() - 1] == '\r')
+                line.erase(line.length() - 1);
+            lines.push_back(line);
+            if (in.rdbuf()->in_avail() <= 0)
+                break;
+        }
+        if (lines.empty())
+            break;
+
+        output.clear();
+        answered += executeAll(lines, output);
+        out << output;
+    }
+
+    out.flush();
+    in.tie(tied);
+    return answered;
+}
+
+
+unsigned long long CommandProcessor::executeAll(const vector<string> &lines, string &output) {
+    unsigned long long answered = 0;
+    string response;
+
+    size_t next = 0;
+    while (next < lines.size() && !finished) {
+        size_t end = next;
+        while (end < lines.size() && isQuery(lines[end]))
+            end++;
+        if (end - next >= PARALLEL_RUN_LENGTH && terms.getPool().getNumberOfThreads() > 1) {
+            answerQueries(lines, next, end, output);
+            answered += end - next;
+            next = end;
+            continue;
+        }
+
+        // a short run of queries, or a command changing the registry or the processor, runs on this thread
+        for (end = max(end, next + 1); next < end && !finished; next++) {
+            deferDurability = (bool) durabilityHook;
+            bool answer = execute(lines[next], response);
+            deferDurability = false;
+            if (!answer)
+                continue;
+
+            size_t answerStart = output.length();
+            output += response;
+            output += '\n';
+            answered++;
+            if (pendingSequence != 0) {
+                durabilityHook(*pendingRegistry, pendingSequence, output, answerStart);
+                pendingSequence = 0;
+            }
+        }
+    }
+    return answered;
+}
+
+
+void CommandProcessor::setDurabilityHook(const DurabilityHook &hook) {
+    durabilityHook = hook;
+}
+
+
+void CommandProcessor::setAdmissionHook(const AdmissionHook &hook) {
+    admissionHook = hook;
+}
+
+
+const CommandStats &CommandProcessor::getStats() const {
+    return stats;
+}
+
+
+bool CommandProcessor::isFinished() const {
+    return finished;
+}
+
+
+void CommandProcessor::registerBundle(const vector<string> &args, string &response) {
+    if (args.size() < 3) {
+        response = "ERR BAD_ARGUMENTS REGISTER <student> <course>...";
+        return;
+    }
+    if (isOtherShard(args[1], response) || isShed(response))
+        return;
+
+    Registry &registry = *term->registry;
+    vector<string> bundle(args.begin() + 2, args.end());
+    string failedCourse;
+    pendingRegistry = &registry;
+    appendResult(response, registry.registerBundle(args[1], bundle, failedCourse,
+                                                   deferDurability ? &pendingSequence : nullptr), failedCourse);
+}
+
+
+void CommandProcessor::changeCourse(const vector<string> &args, string &response) {
+    if (args.size() != 3) {
+        response = "ERR BAD_ARGUMENTS " + args[0] + " <student> <course>";
+        return;
+    }
+    if (isOtherShard(args[1], response) || isShed(response))
+        return;
+
+    Registry &registry = *term->registry;
+    pendingRegistry = &registry;
+    unsigned long long *sequence = deferDurability ? &pendingSequence : nullptr;
+    if (args[0] == "ADD")
+        appendResult(response, registry.addCourse(args[1], args[2], sequence));
+    else
+        appendResult(response, registry.dropCourse(args[1], args[2], sequence));
+}
+
+
+void CommandProcessor::describeStudent(const vector<string> &args, string &response) const {
+    if (args.size() != 2) {
+        response = "ERR BAD_ARGUMENTS STUDENT <student>";
+        return;
+    }
+    if (isOtherShard(args[1], response))
+        return;
+
+    Student *student = term->registry->findStudent(args[1]);
+    if (student == nullptr) {
+        appendResult(response, STUDENT_NOT_FOUND);
+        return;
+    }
+
+    ostringstream answer;
+    answer << "OK " << student->getStudentId() << ' ' << student->getGpa() << ' ' << student->getNumberOfcredits();
+    for (const string &courseCode: student->getRegisteredCourse())
+        answer << ' ' << courseCode;
+    response = answer.str();
+}
+
+
+void CommandProcessor::describeCourse(const vector<string> &args, string &response) const {
+    if (args.size() != 2) {
+        response = "ERR BAD_ARGUMENTS COURSE <course>";
+        return;
+    }
+
+    Course *course = term->registry->findCourse(args[1]);
+    if (course == nullptr) {
+        appendResult(response, COURSE_NOT_FOUND);
+        return;
+    }
+
+    response = "OK " + course->getCourseCode() + " " + to_string(course->getNumberOfEnrolled()) + " " +
+               to_string(course->getCapacity()) + " " + to_string(course->getNumberOfCredits());
+}
+
+
+void CommandProcessor::listRoster(const vector<string> &args, string &response) const {
+    if (args.size() != 2) {
+        response = "ERR BAD_ARGUMENTS ROSTER <course>";
+        return;
+    }
+
+    Course *course = term->registry->findCourse(args[1]);
+    if (course == nullptr) {
+        appendResult(response, COURSE_NOT_FOUND);
+        return;
+    }
+
+    // the line is rendered once per change of the course, a popular roster is only copied
+    shared_ptr<const string> line = course->getRosterLine();
+    response.reserve(line->length() + 3);
+    response = "OK ";
+    response += *line;
+}
+
+
+void CommandProcessor::findShard(const vector<string> &args, string &response) const {
+    if (args.size() != 2) {
+        response = "ERR BAD_ARGUMENTS SHARD <student>";
+        return;
+    }
+    response = "OK " + to_string(shardOf(args[1], terms.getNumberOfShards()));
+}
+
+
+void CommandProcessor::findRows(const vector<string> &args, string &response) const {
+    StudentFilter studentFilter;
+    CourseFilter courseFilter;
+    QueryResult result;
+    if (args.size() >= 2 && args[1] == "STUDENTS" && parseStudentFilter(args, 2, studentFilter))
+        result = term->registry->findStudents(studentFilter);
+    else if (args.size() >= 2 && args[1] == "COURSES" && parseCourseFilter(args, 2, courseFilter))
+        result = term->registry->findCourses(courseFilter);
+    else {
+        if (args.size() >= 2 && args[1] == "COURSES")
+            response = "ERR BAD_ARGUMENTS FIND COURSES [PREFIX=<code>] [CREDITS=<min>-<max>] [SEATS=<min>-<max>]";
+        else
+            response = "ERR BAD_ARGUMENTS FIND STUDENTS [STATUS=REGULAR|PROBATION] [GPA=<min>-<max>] "
+                       "[CREDITS=<min>-<max>] [REGISTERED=YES|NO]";
+        return;
+    }
+
+    response = "OK " + to_string(result.keys.size());
+    for (const string &key: result.keys)
+        response += " " + key;
+}
+
+
+bool CommandProcessor::isOtherShard(const string &studentId, string &response) const {
+    int shard = shardOf(studentId, terms.getNumberOfShards());
+    if (shard == terms.getShard())
+        return false;
+    response = "ERR WRONG_SHARD " + to_string(shard);
+    return true;
+}
+
+
+bool CommandProcessor::isShed(string &response) const {
+    unsigned int retryAfter = 0;
+    if (!admissionHook || admissionHook(retryAfter))
+        return false;
+    response = "ERR RETRY_AFTER " + to_string(retryAfter);
+    return true;
+}
+
+
+void CommandProcessor::switchTerm(const vector<string> &args, string &response) {
+    if (args.size() == 1) {
+        response = "OK " + term->name;
+    } else if (args.size() != 2) {
+        response = "ERR BAD_ARGUMENTS TERM [<name>]";
+    } else if (terms.findTerm(args[1]) != nullptr) {
+        term = terms.findTerm(args[1]);
+        response = "OK";
+    } else {
+        response = "ERR UNKNOWN_TERM " + args[1];
+    }
+}
+
+
+void CommandProcessor::startCheckpoint(const vector<string> &args, string &response) {
+    if (args.size() != 1) {
+        response = "ERR BAD_ARGUMENTS CHECKPOINT";
+        return;
+    }
+
+    Registry &registry = *term->registry;
+    response = registry.startCheckpoint(registry.getSnapshotPath()) ? "OK" : "ERR BUSY";
+}
+
+
+void CommandProcessor::describeStats(const vector<string> &args, string &response) {
+    if (args.size() != 1) {
+        response = "ERR BAD_ARGUMENTS STATS";
+        return;
+    }
+
+    // this command is counted once its answer is built
+    response = "OK " + to_string(stats.commands + 1) + " " + to_string(stats.errors) + " " +
+               to_string(term->registry->pinView().getNumberOfEnrollments());
+}
+
+
+bool CommandProcessor::isQuery(const string &line) {
+    const char *spaces = " \t\n\v\f\r";
+    size_t start = line.find_first_not_of(spaces);
+    if (start == string::npos)
+        return false;
+    size_t end = min(line.find_first_of(spaces, start), line.length());
+
+    string command = line.substr(start, end - start);
+    for (char &character: command)
+        character = toupper((unsigned char) character);
+    return command == "STUDENT" || command == "COURSE" || command == "ROSTER" || command == "PING";
+}
+
+
+void CommandProcessor::answerQueries(const vector<string> &lines, size_t begin, size_t end, string &output) {
+    vector<string> responses(end - begin);
+    terms.getPool().parallelFor(end - begin, PARALLEL_CHUNK_REQUESTS,
+                                [this, &lines, &responses, begin](size_t first, size_t last) {
+                                    for (size_t i = first; i < last; i++)
+                                        answerQuery(lines[begin + i], responses[i]);
+                                });
+
+    // the counters are only updated by this thread, in the order of the commands
+    for (const string &response: responses) {
+        output += response;
+        output += '\n';
+        stats.commands++;
+        if (response.compare(0, 3, "ERR") == 0)
+            stats.errors++;
+    }
+}
+
+
+void CommandProcessor::answerQuery(const string &line, string &response) const {
+    vector<string> args = splitCommand(line);
+    const string &command = args[0];
+    if (command == "STUDENT")
+        describeStudent(args, response);
+    else if (command == "COURSE")
+        describeCourse(args, response);
+    else if (command == "ROSTER")
+        listRoster(args, response);
+    else
+        response = "OK";
+}
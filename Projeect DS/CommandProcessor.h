@@ -0,0 +1,219 @@
+/**
+
+    @file CommandProcessor.h
+    @brief Declaration of the CommandProcessor class and its member functions.
+
+    This file contains the declaration of the CommandProcessor class, which runs text commands against the open
+    terms and answers each one with a single line, so the registry can be driven by scripts and load tests instead
+    of the menu.
+
+    date 18 Oct 2026
+
+    A command is one line of words separated by spaces, the first word names the command, eg:
+        REGISTER A2101324 CSIS200 CSIS205
+    The answer starts with OK followed by the values asked, or with ERR followed by the name of the error and
+    sometimes a detail, eg: ERR COURSE_FULL CSIS205. The errors of the registrations are the names of
+    RegistrationResult (see resultName()), JOURNAL_FAILED among them when the change couldn't be saved; the others
+    are UNKNOWN_COMMAND, BAD_ARGUMENTS, UNKNOWN_TERM, BUSY, WRONG_SHARD and RETRY_AFTER.
+    Empty lines and lines starting with '#' are skipped without an answer.
+
+    The commands call the same Registry methods as the options of the menu. They work on the term of the
+    processor, the current term of the directory at first: TERM only changes the term of its own processor, so
+    each connection of the server has its own (see RegistrationServer).
+        REGISTER <student> <course>...    register a bundle of courses, all or none (option 8)
+        ADD <student> <course>            add a course (option 9)
+        DROP <student> <course>           drop a course (option 9)
+        STUDENT <student>                 OK <id> <gpa> <credits> <course>...
+        COURSE <course>                   OK <code> <enrolled> <capacity> <credits>
+        ROSTER <course>                   OK <code> <number of students> <student>...
+        TERM [<name>]                     switch to a term, or OK <term of the processor>
+        CHECKPOINT                        start a checkpoint in the background (option 12)
+        STATS                             OK <commands> <errors> <enrollments of the term>
+        PING                              OK
+        SHARD <student>                   OK <shard of the student>, 0 when the students aren't sharded
+        FIND STUDENTS [STATUS=REGULAR|PROBATION] [GPA=<range>] [CREDITS=<range>] [REGISTERED=YES|NO]
+        FIND COURSES [PREFIX=<start of the code>] [CREDITS=<range>] [SEATS=<range>]
+                                          OK <number found> <student or course>..., sorted; a range is
+                                          <min>-<max>, either bound may be left out, eg: CREDITS=-8
+        QUIT                              OK, and no command is run afterwards
+
+    When the directory holds one shard of the students (see Sharding.h), REGISTER, ADD, DROP and STUDENT about a
+    student of another shard are answered ERR WRONG_SHARD <shard>, so the client can send them there instead.
+    FIND STUDENTS only finds the students of the shard.
+
+    STUDENT, COURSE, ROSTER and PING only read the registry. When a script or a client sends many commands at once
+    (executeAll), a run of at least PARALLEL_RUN_LENGTH of them in a row is answered on the WorkStealingPool of the
+    directory; the answers still come in the order of the commands.
+
+    With a DurabilityHook (setDurabilityHook), executeAll doesn't wait for the journal after a registration: the
+    hook is given its answer and decides when it is sent, see RegistrationServer.
+
+    With an AdmissionHook (setAdmissionHook), REGISTER, ADD and DROP are first offered to the hook, and a refused
+    one is answered ERR RETRY_AFTER <milliseconds> without touching the registry, see AdmissionControl.
+
+    Public Member Functions:
+        1. CommandProcessor(TermDirectory &)
+        2. execute(const string &, string &): bool
+        3. run(istream &, ostream &): unsigned long long
+        4. getStats() const: const CommandStats &
+        5. isFinished() const: bool
+        6. executeAll(const vector<string> &, string &): unsigned long long
+        7. setDurabilityHook(const DurabilityHook &): void
+        8. setAdmissionHook(const AdmissionHook &): void
+*/
+
+#ifndef DSPROJ_COMMANDPROCESSOR_H
+#define DSPROJ_COMMANDPROCESSOR_H
+
+#include "TermDirectory.h"
+#include "Registry.h"
+#include "AsyncRequest.h"
+#include "AdmissionControl.h"
+
+#include <string>
+#include <vector>
+#include <iostream>
+
+using namespace std;
+
+// most lines read at once from a stream by run() before they are answered
+const size_t COMMAND_BATCH_LINES = 4096;
+
+// what the commands run so far did
+struct CommandStats {
+    unsigned long long commands = 0;    // commands answered
+    unsigned long long errors = 0;      // answers starting with ERR
+};
+
+class CommandProcessor {
+public:
+
+    /**
+ * @brief Constructor for the CommandProcessor class.
+ *
+ * @param terms The open terms, the commands work on the current one until a TERM command.
+ *
+ * @pre At least one term is open.
+ *
+ * @post No command was run yet.
+ */
+    CommandProcessor(TermDirectory &);
+
+    /**
+ * @brief Run one command.
+ *
+ * @param line The command, eg: ADD A2101324 CSIS200. The words are not case sensitive.
+ * @param response Set to the answer, without end of line, or to an empty string for an empty or comment line.
+ * @return bool True if the line was a command and response holds its answer.
+ *
+ * @pre None.
+ *
+ * @post A registration command changed the registry and its journal like the menu does. After QUIT every
+ *       command is answered with ERR UNKNOWN_COMMAND and isFinished() returns true.
+ */
+    bool execute(const string &, string &);
+
+    /**
+ * @brief Run the commands of a stream, one per line, until its end or QUIT.
+ *
+ * @param in The commands, eg: cin or a script file.
+ * @param out Receives one answer per command, one per line.
+ * @return unsigned long long The number of commands answered.
+ *
+ * @details The answers are buffered and only flushed when no more input is waiting, so a script piped in runs at
+ * full speed while a program sending one command at a time still gets each answer before it sends the next one.
+ * The lines already waiting in the stream, up to COMMAND_BATCH_LINES, are run together by executeAll.
+ */
+    unsigned long long run(istream &, ostream &);
+
+    /**
+ * @brief Get the number of commands answered and of errors.
+ *
+ * @return const CommandStats & The counters since the construction.
+ */
+    const CommandStats &getStats() const;
+
+    /**
+ * @brief Check if QUIT was run.
+ *
+ * @return bool True once QUIT was answered.
+ */
+    bool isFinished() const;
+
+    /**
+ * @brief Run several commands received together.
+ *
+ * @param lines The commands, one per element, without end of line.
+ * @param output Receives the answer of every command followed by an end of line, in the order of the commands.
+ * @return unsigned long long The number of commands answered.
+ *
+ * @pre None.
+ *
+ * @post Same answers and same registry as execute on every line in order. The lines after a QUIT are not run.
+ *       With a hook, the answer of a registration waiting for the journal was given to the hook.
+ */
+    unsigned long long executeAll(const vector<string> &, string &);
+
+    /**
+ * @brief Let executeAll answer the registrations before their journal records are durable.
+ *
+ * @param hook Called after the answer of each registration which journaled records is appended to the output.
+ *
+ * @pre None.
+ *
+ * @post The registrations of executeAll don't wait for the journal. execute and run still wait for it.
+ */
+    void setDurabilityHook(const DurabilityHook &);
+
+    /**
+ * @brief Let a hook refuse the registrations when too many are in flight.
+ *
+ * @param hook Called before REGISTER, ADD and DROP are applied.
+ *
+ * @pre None.
+ *
+ * @post A registration refused by the hook is answered ERR RETRY_AFTER and changes nothing.
+ */
+    void setAdmissionHook(const AdmissionHook &);
+
+private:
+    // The handlers of the commands: args[0] is the name of the command, the answer is appended to response
+    void registerBundle(const vector<string> &, string &);
+    void changeCourse(const vector<string> &, string &);
+    void describeStudent(const vector<string> &, string &) const;
+    void describeCourse(const vector<string> &, string &) const;
+    void listRoster(const vector<string> &, string &) const;
+    void switchTerm(const vector<string> &, string &);
+    void startCheckpoint(const vector<string> &, string &);
+    void describeStats(const vector<string> &, string &);
+    void findShard(const vector<string> &, string &) const;
+    void findRows(const vector<string> &, string &) const;
+
+    // Answer ERR WRONG_SHARD when a student belongs to another shard than the one of the directory
+    bool isOtherShard(const string &, string &) const;
+
+    // Answer ERR RETRY_AFTER when the admission hook refuses a registration
+    bool isShed(string &) const;
+
+    // Check if a line is a command which only reads the registry
+    static bool isQuery(const string &);
+
+    // Answer a run of queries on the pool, as execute would one after the other
+    void answerQueries(const vector<string> &, size_t, size_t, string &);
+
+    // Answer a query, without touching the counters
+    void answerQuery(const string &, string &) const;
+
+    TermDirectory &terms;
+    Term *term;            // the term the commands work on
+    CommandStats stats;
+    bool finished;
+    DurabilityHook durabilityHook;        // empty: the registrations wait for the journal
+    AdmissionHook admissionHook;          // empty: every registration is applied
+    bool deferDurability;                 // set while executeAll runs with a hook
+    Registry *pendingRegistry;            // the registry of the last registration not waited for
+    unsigned long long pendingSequence;   // its sequence, 0 if there is none
+
+};
+
+#endif //DSPROJ_COMMANDPROCESSOR_H
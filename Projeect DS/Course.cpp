@@ -4,6 +4,8 @@
 #include <string>
 #include <vector>
 #include <iomanip>
+#include <atomic>
+#include <cstring>
 
 
 using namespace std;
@@ -15,21 +17,34 @@ Course::Course(int numberOfCredit, string courseCode, string courseTitle, int ca
     setCourseTitle(courseTitle);
     setNumberOfCredits(numberOfCredit);
     setCapacity(capacity);
-    registeredStudents = map<string, string>();
+    meetingSlots = 0;
+    roster = make_shared<Roster>();
+    resetSections({make_pair(1, this->capacity)});
 
 }
 
 
 Course::Course(string s) {
+    // remove the carriage return left by files saved with Windows line endings
+    if (!s.empty() && s[s.length() - 1] == '\r')
+        s.erase(s.length() - 1);
+
     vector<string> valuesList = split(s);
 
+    // the meeting times are an optional last value that doesn't start with a digit, eg: MWF09-10
+    meetingSlots = 0;
+    if (valuesList.size() >= 5 && !isdigit(valuesList.back()[0])) {
+        meetingSlots = parseMeetingSlots(valuesList.back());
+        valuesList.pop_back();
+    }
+
     //default values in case the format of string didn't meet the minimum length
     if (valuesList.size() < 4) {
         courseCode = "";
         courseTitle = "";
         numberOfCredits = 0;
         capacity = 0;
-        registeredStudents = map<string, string>();
+        roster = make_shared<Roster>();
     } else {
         // Assign values to attributes following the format Code, Title, Number of credits, and Capacity
         courseCode = valuesList[0];
@@ -39,13 +54,40 @@ Course::Course(string s) {
         for (int i = 1; i < valuesList.size() - 2; i++) {
             courseTitle = courseTitle + valuesList[i] + " ";
         }
-        registeredStudents = map<string, string>();
+        roster = make_shared<Roster>();
 
     }
+    // the course has a single section until its sections are read from Section.txt
+    resetSections({make_pair(1, capacity)});
 }
 
 
 
+Course::Course(const CourseRecord &record) {
+    courseCode = record.courseCode;
+    courseTitle = record.courseTitle;
+    numberOfCredits = record.numberOfCredits;
+    capacity = record.capacity;
+    meetingSlots = record.meetingSlots;
+    roster = make_shared<Roster>();
+    resetSections({make_pair(1, capacity)});
+}
+
+
+bool Course::toRecord(CourseRecord &record) const {
+    memset(&record, 0, sizeof(record));
+    if (courseCode.length() >= sizeof(record.courseCode) || courseTitle.length() >= sizeof(record.courseTitle))
+        return false;
+
+    strcpy(record.courseCode, courseCode.c_str());
+    strcpy(record.courseTitle, courseTitle.c_str());
+    record.numberOfCredits = numberOfCredits;
+    record.capacity = capacity;
+    record.meetingSlots = meetingSlots;
+    return true;
+}
+
+
 Course::Course(const Course &course) {
     *this = course;
 }
@@ -55,17 +97,53 @@ Course::~Course() {
 }
 
 
-bool Course::registerStudent(const string &studentId, const string &studentFullName) {
-    registeredStudents[studentId] = studentFullName;
-    return true;// true if insertion was successful (student was not already in the course)
+bool Course::registerStudent(const string &studentId, const string &studentFullName, int sectionNumber) {
+    if (roster->registeredStudents.count(studentId) != 0)
+        return false;
+
+    // the least loaded open section is on top of the heap
+    int index = -1;
+    if (sectionNumber == AUTO_SECTION) {
+        if (openSections.empty())
+            return false;
+        index = openSections[0];
+    } else {
+        index = indexOfSection(sectionNumber);
+        if (index == -1 || sections[index].heapPosition == -1)
+            return false; // no such section or the section is full
+    }
+
+    copyRosterIfShared();
+    roster->registeredStudents.insert(make_pair(studentId, studentFullName));
+    roster->studentSections[studentId] = sections[index].number;
+    invalidateRenderedRosters();
+
+    // the section got heavier so it can only go down the heap, or leave it when it is full
+    sections[index].enrolled++;
+    if (sections[index].enrolled >= sections[index].capacity)
+        removeOpenSection(index);
+    else
+        siftDown(sections[index].heapPosition);
+
+    return true;
 }
 
 
 bool Course::dropStudent(const string &id) {
-    auto it = registeredStudents.find(id);
-
-    if (it != registeredStudents.end()) {
-        registeredStudents.erase(it);
+    if (roster->registeredStudents.count(id) != 0) {
+        copyRosterIfShared();
+        roster->registeredStudents.erase(id);
+        invalidateRenderedRosters();
+
+        // give the seat back to the section of the student
+        int index = indexOfSection(roster->studentSections[id]);
+        roster->studentSections.erase(id);
+
+        sections[index].enrolled--;
+        if (sections[index].heapPosition == -1)
+            pushOpenSection(index);
+        else
+            siftUp(sections[index].heapPosition);
         return true;
     }
 
@@ -73,6 +151,57 @@ bool Course::dropStudent(const string &id) {
 }
 
 
+void Course::restoreStudent(const string &studentId, const string &studentFullName, int sectionNumber) {
+    int index = indexOfSection(sectionNumber);
+    if (index == -1)
+        index = 0;
+
+    copyRosterIfShared();
+    roster->registeredStudents.emplace_hint(roster->registeredStudents.end(), studentId, studentFullName);
+    roster->studentSections.emplace_hint(roster->studentSections.end(), studentId, sections[index].number);
+    sections[index].enrolled++;
+    invalidateRenderedRosters();
+}
+
+
+void Course::rebuildOpenSections() {
+    openSections.clear();
+    for (size_t i = 0; i < sections.size(); i++) {
+        sections[i].heapPosition = -1;
+        if (sections[i].enrolled < sections[i].capacity)
+            pushOpenSection(i);
+    }
+}
+
+
+bool Course::setSections(const vector<pair<int, int>> &newSections) {
+    if (!roster->registeredStudents.empty()) {
+        cerr << "the sections of " << courseCode << " can't change once students are registered." << endl;
+        return false;
+    }
+    if (newSections.empty()) {
+        cerr << "the course " << courseCode << " needs at least one section." << endl;
+        return false;
+    }
+
+    for (size_t i = 0; i < newSections.size(); i++) {
+        if (newSections[i].first <= AUTO_SECTION || newSections[i].second < 0) {
+            cerr << "the section " << newSections[i].first << " of " << courseCode << " is invalid." << endl;
+            return false;
+        }
+        for (size_t j = 0; j < i; j++) {
+            if (newSections[j].first == newSections[i].first) {
+                cerr << "the section " << newSections[i].first << " of " << courseCode << " is duplicated." << endl;
+                return false;
+            }
+        }
+    }
+
+    resetSections(newSections);
+    return true;
+}
+
+
 void Course::setCourseCode(string &courseCode) {
     if (courseCode == "") {
         cerr << "the course code is invalid.";
@@ -80,6 +209,7 @@ void Course::setCourseCode(string &courseCode) {
         return;
     } else {
         this->courseCode = courseCode; // set the course code to the course code provided.
+        invalidateRenderedRosters();
     }
 }
 
@@ -91,12 +221,16 @@ void Course::setCourseTitle(string &courseTitle) {
         return;
     } else {
         this->courseTitle = courseTitle;  // set the course title to the course title provided.
+        invalidateRenderedRosters();
     }
 }
 
 void Course::setNumberOfCredits(int numberOfCredits) {
-    if(numberOfCredits < 0)
-        this->numberOfCredits = numberOfCredits;  // set the number of credits of the course  to the number of credits provided.
+    if (numberOfCredits < 0) {
+        cerr << "the number of credits is invalid.";// test and exit function if the number of credits provided is negative.
+        return;
+    }
+    this->numberOfCredits = numberOfCredits;  // set the number of credits of the course  to the number of credits provided.
 
 }
 
@@ -109,6 +243,16 @@ void Course::setCapacity(int capacity) {
     } else {
         this->capacity = capacity; // set the capacity of the course to the capacity provided.
     }
+
+    // a course with a single section keeps its section as large as the course
+    invalidateRenderedRosters();
+    if (sections.size() == 1) {
+        sections[0].capacity = capacity;
+        if (sections[0].heapPosition != -1 && sections[0].enrolled >= capacity)
+            removeOpenSection(0);
+        else if (sections[0].heapPosition == -1 && sections[0].enrolled < capacity)
+            pushOpenSection(0);
+    }
 }
 
 
@@ -133,7 +277,173 @@ int Course::getCapacity() const {
 
 
 int Course::getNumberOfEnrolled() const {
-    return registeredStudents.size();
+    return roster->registeredStudents.size();
+}
+
+
+unsigned long long Course::getMeetingSlots() const {
+    return meetingSlots;
+}
+
+
+void Course::setMeetingSlots(unsigned long long meetingSlots) {
+    this->meetingSlots = meetingSlots;
+}
+
+
+const vector<Section> &Course::getSections() const {
+    return sections;
+}
+
+
+int Course::getSectionOf(const string &studentId) const {
+    auto it = roster->studentSections.find(studentId);
+    return it == roster->studentSections.end() ? AUTO_SECTION : it->second;
+}
+
+
+bool Course::isFull() const {
+    return openSections.empty();
+}
+
+
+const map<string, string> &Course::getRegisteredStudents() const {
+    return roster->registeredStudents;
+}
+
+
+shared_ptr<const Roster> Course::shareRoster() const {
+    return roster;
+}
+
+
+shared_ptr<const string> Course::getRenderedRoster() const {
+    shared_ptr<const string> text = renderedRoster.load();
+    if (text == nullptr) {
+        text = make_shared<const string>(renderRoster());
+        renderedRoster.store(text);
+    }
+    return text;
+}
+
+
+shared_ptr<const string> Course::getRosterLine() const {
+    shared_ptr<const string> line = rosterLine.load();
+    if (line == nullptr) {
+        string rendered = courseCode + " " + to_string(roster->registeredStudents.size());
+        for (auto itr = roster->registeredStudents.begin(); itr != roster->registeredStudents.end(); ++itr) {
+            rendered += ' ';
+            rendered += itr->first;
+        }
+        line = make_shared<const string>(move(rendered));
+        rosterLine.store(line);
+    }
+    return line;
+}
+
+
+void Course::invalidateRenderedRosters() {
+    // a reader holding a text keeps it, the next one renders the course as it is now
+    renderedRoster.store(nullptr);
+    rosterLine.store(nullptr);
+}
+
+
+void Course::copyRosterIfShared() {
+    // a checkpoint or a report still holds the current roster: it keeps it and the course continues on its own copy
+    if (roster.use_count() > 1)
+        roster = make_shared<Roster>(*roster);
+    else
+        atomic_thread_fence(memory_order_acquire); // the last reads of a released view happen before the change
+}
+
+
+int Course::indexOfSection(int sectionNumber) const {
+    for (size_t i = 0; i < sections.size(); i++) {
+        if (sections[i].number == sectionNumber)
+            return i;
+    }
+    return -1;
+}
+
+
+void Course::resetSections(const vector<pair<int, int>> &newSections) {
+    sections.clear();
+    openSections.clear();
+    capacity = 0;
+
+    for (size_t i = 0; i < newSections.size(); i++) {
+        sections.push_back({newSections[i].first, newSections[i].second, 0, -1});
+        capacity += newSections[i].second;
+        if (newSections[i].second > 0)
+            pushOpenSection(i);
+    }
+    invalidateRenderedRosters();
+}
+
+
+bool Course::lessLoaded(int first, int second) const {
+    // compare enrolled / capacity without dividing, the lowest section number breaks the ties
+    long long firstLoad = (long long) sections[first].enrolled * sections[second].capacity;
+    long long secondLoad = (long long) sections[second].enrolled * sections[first].capacity;
+    if (firstLoad != secondLoad)
+        return firstLoad < secondLoad;
+    return sections[first].number < sections[second].number;
+}
+
+
+void Course::siftUp(int position) {
+    while (position > 0) {
+        int parent = (position - 1) / 2;
+        if (!lessLoaded(openSections[position], openSections[parent]))
+            break;
+        swap(openSections[position], openSections[parent]);
+        sections[openSections[position]].heapPosition = position;
+        sections[openSections[parent]].heapPosition = parent;
+        position = parent;
+    }
+}
+
+
+void Course::siftDown(int position) {
+    int size = openSections.size();
+    while (true) {
+        int lightest = position;
+        int left = 2 * position + 1, right = 2 * position + 2;
+        if (left < size && lessLoaded(openSections[left], openSections[lightest]))
+            lightest = left;
+        if (right < size && lessLoaded(openSections[right], openSections[lightest]))
+            lightest = right;
+        if (lightest == position)
+            break;
+        swap(openSections[position], openSections[lightest]);
+        sections[openSections[position]].heapPosition = position;
+        sections[openSections[lightest]].heapPosition = lightest;
+        position = lightest;
+    }
+}
+
+
+void Course::pushOpenSection(int index) {
+    openSections.push_back(index);
+    sections[index].heapPosition = openSections.size() - 1;
+    siftUp(openSections.size() - 1);
+}
+
+
+void Course::removeOpenSection(int index) {
+    int position = sections[index].heapPosition;
+    int last = openSections.back();
+    openSections.pop_back();
+    sections[index].heapPosition = -1;
+
+    // the last section of the heap takes the free position and moves to its place
+    if (last != index) {
+        openSections[position] = last;
+        sections[last].heapPosition = position;
+        siftUp(position);
+        siftDown(sections[last].heapPosition);
+    }
 }
 
 
@@ -143,8 +453,9 @@ ostream &Course::displayTabular(ostream &out) const {
         setw(15) << courseCode <<
         setw(35) << courseTitle <<
         setw(15) << fixed << setprecision(1) << numberOfCredits <<
-        setw(15) << fixed << setprecision(1) << registeredStudents.size() <<
+        setw(15) << fixed << setprecision(1) << roster->registeredStudents.size() <<
         setw(15) << fixed << setprecision(1) << capacity <<
+        setw(20) << formatMeetingSlots(meetingSlots) <<
         endl;
 
     return out;
@@ -152,23 +463,43 @@ ostream &Course::displayTabular(ostream &out) const {
 
 
 void Course::displayRegisteredStudents() {
-    // Display course code and title
-    cout << getCourseCode() << " - " << getCourseTitle() << endl;
+    // the roster is rendered once per change of the course, a display only writes the text
+    shared_ptr<const string> text = getRenderedRoster();
+    cout.write(text->data(), text->length());
+    cout.flush();
+}
 
-    // Iterator for the map of registered students
-    map<string, string>::iterator itr;
+
+string Course::renderRoster() const {
+    // Display course code and title
+    string text = getCourseCode() + " - " + getCourseTitle() + "\n";
 
     // Check if there are no registered students
-    if (registeredStudents.size() == 0) {
-        cout << "No student is registered yet in this course." << endl;
+    if (roster->registeredStudents.size() == 0) {
+        text += "No student is registered yet in this course.\n";
     } else {
         // Loop through the registered students and display their information
-        for (itr = registeredStudents.begin(); itr != registeredStudents.end(); ++itr)
-            cout << itr->first << ' ' << itr->second << endl;
+        for (auto itr = roster->registeredStudents.begin(); itr != roster->registeredStudents.end(); ++itr) {
+            text += itr->first;
+            text += ' ';
+            text += itr->second;
+            if (sections.size() > 1)
+                text += " (section " + to_string(getSectionOf(itr->first)) + ")";
+            text += '\n';
+        }
+    }
+
+    // Display the load of every section when the course has many
+    if (sections.size() > 1) {
+        text += '\n';
+        for (const Section &section: sections)
+            text += "Section " + to_string(section.number) + ": " + to_string(section.enrolled) + '/' +
+                    to_string(section.capacity) + '\n';
     }
 
     // Add some extra newlines for better formatting
-    cout << endl << endl << endl;
+    text += "\n\n\n";
+    return text;
 }
 
 
@@ -192,14 +523,19 @@ Course &Course::operator=(const Course &other) {
     courseTitle = other.courseTitle;
     capacity = other.capacity;
     numberOfCredits = other.numberOfCredits;
-    registeredStudents = other.registeredStudents;
+    meetingSlots = other.meetingSlots;
+    roster = other.roster; // shared until one of the two courses changes it
+    sections = other.sections;
+    openSections = other.openSections;
+    renderedRoster.store(other.renderedRoster.load()); // the same roster renders the same text
+    rosterLine.store(other.rosterLine.load());
 
     return *this;
 }
 
 
 istream &operator>>(istream &in, Course &course) {
-    string courseCode, courseTitle;
+    string courseCode, courseTitle, meetingTimes;
     unsigned capacity, numberOfCredits;
 
     // Prompt user for input
@@ -212,12 +548,15 @@ istream &operator>>(istream &in, Course &course) {
     in >> numberOfCredits;
     cout << "Enter the maximum capacity of the course";
     in >> capacity;
+    cout << "Enter the meeting times of the course (eg: MWF09-10,TR11-13)";
+    in >> meetingTimes;
 
     // Set the attributes of the Course object
     course.setCourseCode(courseCode);
     course.setCapacity(capacity);
     course.setCourseTitle(courseTitle);
     course.setNumberOfCredits(numberOfCredits);
+    course.setMeetingSlots(parseMeetingSlots(toUpperCase(meetingTimes)));
 
     return in;
 }
@@ -256,4 +595,74 @@ vector<string> split(const string &s) {
         splitting.push_back(temp);
 
     return splitting;
-}
\ No newline at end of file
+}
+
+
+unsigned long long parseMeetingSlots(const string &text) {
+    unsigned long long slots = 0;
+    string group;
+
+    // each group separated by a comma is made of day letters followed by HH-HH
+    for (size_t start = 0; start <= text.length(); start += group.length() + 1) {
+        size_t comma = text.find(',', start);
+        group = text.substr(start, comma == string::npos ? string::npos : comma - start);
+
+        size_t digits = 0;
+        while (digits < group.length() && DAY_LETTERS.find(group[digits]) != string::npos)
+            digits++;
+
+        int fromHour = 0, toHour = 0;
+        if (digits == 0 || group.length() != digits + 5 || group[digits + 2] != '-' ||
+            !isdigit(group[digits]) || !isdigit(group[digits + 1]) ||
+            !isdigit(group[digits + 3]) || !isdigit(group[digits + 4])) {
+            cerr << "the meeting times " << text << " are invalid." << endl;
+            return 0;
+        }
+        fromHour = stoi(group.substr(digits, 2));
+        toHour = stoi(group.substr(digits + 3, 2));
+
+        if (fromHour < FIRST_SLOT_HOUR || toHour > FIRST_SLOT_HOUR + SLOTS_PER_DAY || fromHour >= toHour) {
+            cerr << "the meeting times " << text << " are out of the week schedule." << endl;
+            return 0;
+        }
+
+        // set one bit per hour for every day of the group
+        for (size_t i = 0; i < digits; i++) {
+            int day = DAY_LETTERS.find(group[i]);
+            for (int hour = fromHour; hour < toHour; hour++)
+                slots |= 1ULL << (day * SLOTS_PER_DAY + hour - FIRST_SLOT_HOUR);
+        }
+    }
+
+    return slots;
+}
+
+
+string formatMeetingSlots(unsigned long long slots) {
+    if (slots == 0)
+        return "TBA";
+
+    // the days sharing the same range of hours are written together: hours range -> day letters
+    map<pair<int, int>, string> ranges;
+    for (int day = 0; day < DAYS_PER_WEEK; day++) {
+        int hour = 0;
+        while (hour < SLOTS_PER_DAY) {
+            if (!(slots >> (day * SLOTS_PER_DAY + hour) & 1ULL)) {
+                hour++;
+                continue;
+            }
+            int fromHour = hour;
+            while (hour < SLOTS_PER_DAY && (slots >> (day * SLOTS_PER_DAY + hour) & 1ULL))
+                hour++;
+            ranges[make_pair(fromHour + FIRST_SLOT_HOUR, hour + FIRST_SLOT_HOUR)] += DAY_LETTERS[day];
+        }
+    }
+
+    string text;
+    char hours[8];
+    for (auto itr = ranges.begin(); itr != ranges.end(); ++itr) {
+        snprintf(hours, sizeof(hours), "%02d-%02d", itr->first.first, itr->first.second);
+        text += (text.empty() ? "" : ",") + itr->second + hours;
+    }
+    return text;
+}
@@ -34,6 +34,22 @@
         20. operator=(const Course &): course&
         21. operator>>(istream &, Course &): friend istream &
         22. split(const string &): static vector<string>
+        23. getMeetingSlots() const: unsigned long long
+        24. setMeetingSlots(unsigned long long): void
+        25. parseMeetingSlots(const string &): unsigned long long
+        26. formatMeetingSlots(unsigned long long): string
+        27. setSections(const vector<pair<int, int>> &): bool
+        28. getSections() const: const vector<Section> &
+        29. getSectionOf(const string &) const: int
+        30. isFull() const: bool
+        31. restoreStudent(const string &, const string &, int): void
+        32. rebuildOpenSections(): void
+        33. getRegisteredStudents() const: const map<string, string> &
+        34. shareRoster() const: shared_ptr<const Roster>
+        35. Course(const CourseRecord &)
+        36. toRecord(CourseRecord &) const: bool
+        37. getRenderedRoster() const: shared_ptr<const string>
+        38. getRosterLine() const: shared_ptr<const string>
 */
 
 #ifndef COURSE_H
@@ -45,9 +61,45 @@
 
 #include <string>
 #include <map>
+#include <vector>
+#include <memory>
+#include <atomic>
 
 using namespace std;
 
+// the week is divided in one hour slots from 8:00 to 20:00, Monday to Friday (60 bits)
+const int FIRST_SLOT_HOUR = 8;
+const int SLOTS_PER_DAY = 12;
+const int DAYS_PER_WEEK = 5;
+const string DAY_LETTERS = "MTWRF";
+
+// section number asking the course to place the student in its least loaded open section
+const int AUTO_SECTION = 0;
+
+// a section of a course, the sections of a course share its meeting times
+struct Section {
+    int number;       // section number as written in Section.txt, eg: 2
+    int capacity;
+    int enrolled;
+    int heapPosition; // position in the heap of open sections, -1 when the section is full
+};
+
+// the students of a course, copied on write: a checkpoint shares it until the course changes again
+struct Roster {
+    // https://www.geeksforgeeks.org/map-associative-containers-the-c-standard-template-library-stl/
+    map<string, string> registeredStudents; // student id -> full name
+    map<string, int> studentSections;       // student id -> number of their section
+};
+
+// the catalog data of a course as a fixed size record, the form kept in Course.map (see MappedNodes.h)
+struct CourseRecord {
+    char courseCode[12];               // null terminated, as is the title, a longer value doesn't fit
+    char courseTitle[60];
+    int numberOfCredits;
+    int capacity;
+    unsigned long long meetingSlots;
+};
+
 class Student; // So we can solve the forward declaration error
 class Course {
 public:
@@ -103,6 +155,17 @@ public:
   */
     Course(string);
 
+    /**
+  * @brief Constructor for the Course class from a record of Course.map.
+  *
+  * @param record The code, title, credits, capacity and meeting times of the course.
+  *
+  * @pre The strings of the record are null terminated.
+  *
+  * @post The Course object has the values of the record, a single section and no registered student.
+  */
+    Course(const CourseRecord &);
+
     /**
   * @brief Destructor for the Course class.
   *
@@ -198,6 +261,117 @@ public:
   */
     int getNumberOfEnrolled() const;
 
+    /**
+  * @brief Get the weekly meeting times of the Course.
+  *
+  * This method returns the meeting times of the Course as a bitmask with one bit per hour of the week.
+  *
+  * @return unsigned long long The meeting times of the Course, 0 if the course has no schedule.
+  *
+  * @pre The Course object is properly initialized.
+  *
+  * @post None.
+  *
+  * @details Bit (day * SLOTS_PER_DAY + hour - FIRST_SLOT_HOUR) is set when the course meets during that hour,
+  * with day 0 to 4 for Monday to Friday. Two courses overlap if the AND of their meeting times is not 0.
+  */
+    unsigned long long getMeetingSlots() const;
+
+    /**
+  * @brief Get the sections of the Course.
+  *
+  * @return const vector<Section> & The sections of the Course, a course read without sections has a single
+  * section 1 holding its whole capacity.
+  *
+  * @pre The Course object is properly initialized.
+  *
+  * @post None.
+  */
+    const vector<Section> &getSections() const;
+
+    /**
+  * @brief Get the section a student is registered in.
+  *
+  * @param studentId The ID of the student.
+  * @return int The number of the section of the student, or AUTO_SECTION if the student is not registered.
+  *
+  * @pre The Course object is properly initialized.
+  *
+  * @post None.
+  */
+    int getSectionOf(const string &) const;
+
+    /**
+  * @brief Check if every section of the Course is full.
+  *
+  * @return bool True if no section has a free seat.
+  *
+  * @pre The Course object is properly initialized.
+  *
+  * @post None.
+  */
+    bool isFull() const;
+
+    /**
+  * @brief Get the students registered in the Course.
+  *
+  * @return const map<string, string> & The registered students, ID -> full name, sorted by ID.
+  *
+  * @pre The Course object is properly initialized.
+  *
+  * @post None.
+  */
+    const map<string, string> &getRegisteredStudents() const;
+
+    /**
+  * @brief Share the current roster of the Course with a reader that outlives the lock.
+  *
+  * @return shared_ptr<const Roster> The roster as it is now, it never changes afterwards.
+  *
+  * @pre The caller holds the lock of the registry.
+  *
+  * @post The next change of the Course copies the roster first, so the shared one stays a consistent view.
+  *
+  * @details This costs one reference count, which is what lets a checkpoint capture every course without
+  * copying any student while the registrations are blocked.
+  */
+    shared_ptr<const Roster> shareRoster() const;
+
+    /**
+  * @brief Get the roster of the Course as displayRegisteredStudents writes it.
+  *
+  * @return shared_ptr<const string> The text of the display, ready to be written.
+  *
+  * @pre None.
+  *
+  * @post The text is kept until the Course changes, so the next calls only share it.
+  *
+  * @details The text is rendered at the first call after a registration, a drop or a change of the sections.
+  * Threads calling it at once, eg: the queries of the pool, may render it twice but never see a partial one.
+  */
+    shared_ptr<const string> getRenderedRoster() const;
+
+    /**
+  * @brief Get the students of the Course as the ROSTER command answers them.
+  *
+  * @return shared_ptr<const string> The course code, the number of students and their IDs sorted, separated by
+  *         spaces, eg: CSIS200 2 A2101324 A2201234.
+  *
+  * @pre None.
+  *
+  * @post The line is kept until the Course changes, like the text of getRenderedRoster().
+  */
+    shared_ptr<const string> getRosterLine() const;
+
+    /**
+  * @brief Get the catalog data of the course as a fixed size record.
+  *
+  * @param record Set to the code, title, credits, capacity and meeting times. The sections and the students are
+  *        not part of it.
+  * @return bool False if the code or the title is longer than its field of the record, which is then left empty.
+  */
+    bool toRecord(CourseRecord &) const;
+
     // Setter methods
 
 
@@ -268,6 +442,32 @@ public:
   */
     void setCapacity(int);
 
+    /**
+  * @brief Set the weekly meeting times of the Course.
+  *
+  * @param meetingSlots The meeting times as a bitmask, see getMeetingSlots().
+  *
+  * @pre The Course object is properly initialized.
+  *
+  * @post The meeting times of the Course are updated with the provided value.
+  */
+    void setMeetingSlots(unsigned long long);
+
+    /**
+  * @brief Split the Course in sections.
+  *
+  * @param sections The number and the capacity of every section, eg: {{1, 30}, {2, 30}, {3, 20}}.
+  * @return bool True if the sections were set, false otherwise.
+  *
+  * @pre No student is registered in the Course yet.
+  *
+  * @post On success the capacity of the Course is the sum of the capacities of its sections.
+  *       On failure an error message is printed to the standard error stream (cerr) and nothing changes.
+  *
+  * @details There must be at least one section, with distinct numbers above 0 and non-negative capacities.
+  */
+    bool setSections(const vector<pair<int, int>> &);
+
 
     // Registration methods
 
@@ -278,18 +478,21 @@ public:
  *
  * @param studentId The ID of the student to register.
  * @param studentFullName The full name of the student to register.
+ * @param sectionNumber The section to register the student in, or AUTO_SECTION to place the student in the
+ * least loaded open section.
  * @return bool True if the student was successfully registered, false otherwise.
  *
  * @pre The Course object is properly initialized.
  *
- * @post If the student with the provided ID does not already exist in the Course,
+ * @post If the student with the provided ID does not already exist in the Course and the section has a free seat,
  * they are added to the registeredStudents map, and true is returned.
- * If the student already exists, false is returned, indicating that the registration failed.
+ * If the student already exists or the section is full, false is returned, indicating that the registration failed.
  *
  * @details The function adds a student to the Course by assigning the provided full name to the provided ID.
- * If a student with the same ID already exists, the registration fails, and false is returned.
+ * The open sections are kept in a min heap ordered by the fraction of their seats that are taken, so the least
+ * loaded one is on top and placing a student costs O(log sections).
  */
-    bool registerStudent(const string &, const string &);
+    bool registerStudent(const string &, const string &, int sectionNumber = AUTO_SECTION);
 
     /**
   * @brief Drop a student from the Course.
@@ -305,10 +508,36 @@ public:
   * Otherwise, false is returned, indicating the student was not found.
   *
   * @details The function searches for a student with the provided ID in the registeredStudents map.
-  * If found, the student is removed from the Course, and true is returned. If not found, false is returned.
+  * If found, the student is removed from the Course and their seat is given back to their section,
+  * and true is returned. If not found, false is returned.
   */
     bool dropStudent(const string & );
 
+    /**
+  * @brief Put back a student of a snapshot or a journal in the Course during a recovery.
+  *
+  * @param studentId The ID of the student.
+  * @param studentFullName The full name of the student.
+  * @param sectionNumber The section the student was in, an unknown section puts the student in the first one.
+  *
+  * @pre The IDs are given in increasing order and are not in the Course yet.
+  *
+  * @post The student is in the Course, whatever the capacity of their section. The heap of open sections is
+  *       not updated, rebuildOpenSections() must be called once every student is back.
+  *
+  * @details Since the IDs arrive sorted each one is inserted at the end of the map in constant time.
+  */
+    void restoreStudent(const string &, const string &, int);
+
+    /**
+  * @brief Rebuild the heap of open sections from the number of students of each section.
+  *
+  * @pre None.
+  *
+  * @post The sections with a free seat are in the heap, the least loaded one on top.
+  */
+    void rebuildOpenSections();
+
     // Display methods
 
     /**
@@ -321,7 +550,8 @@ public:
  * @post The registered students for the Course are displayed on the console.
  *
  * @details The method checks if there are any registered students for the course. If none, a message is displayed.
- * Otherwise, it iterates through the registered students and prints their information.
+ * Otherwise, it iterates through the registered students and prints their information. The text is kept by
+ * getRenderedRoster() until the course changes, so displaying the same roster again only writes it.
  */
     void displayRegisteredStudents();
 
@@ -379,12 +609,42 @@ public:
     bool operator==(const Course &);
 
 private:
+    // Replace the sections without checking them and rebuild the heap of open sections
+    void resetSections(const vector<pair<int, int>> &);
+
+    // True if the section at index first is less loaded than the section at index second
+    bool lessLoaded(int, int) const;
+
+    // Restore the heap property by moving the section at a position of the heap up or down
+    void siftUp(int);
+    void siftDown(int);
+
+    // Add or remove the section at an index to or from the heap of open sections
+    void pushOpenSection(int);
+    void removeOpenSection(int);
+
+    // Copy the roster before changing it if a reader still shares it
+    void copyRosterIfShared();
+
+    // Drop the rendered rosters after a change, the next read renders them again
+    void invalidateRenderedRosters();
+
+    // Render the text of displayRegisteredStudents
+    string renderRoster() const;
+
+    // Index of the section with a number, -1 if there is none
+    int indexOfSection(int) const;
+
     string courseCode;
     string courseTitle;
     int numberOfCredits;
     int capacity;
-    // https://www.geeksforgeeks.org/map-associative-containers-the-c-standard-template-library-stl/
-    map<string,string> registeredStudents; //To store id + name documentation used
+    unsigned long long meetingSlots; // one bit per hour of the week the course meets
+    shared_ptr<Roster> roster;             // the registered students and their sections
+    vector<Section> sections;              // the sections of the course, at least one
+    vector<int> openSections;              // min heap of the indexes of the sections with a free seat
+    mutable atomic<shared_ptr<const string>> renderedRoster;   // text of displayRegisteredStudents, empty when stale
+    mutable atomic<shared_ptr<const string>> rosterLine;       // answer of ROSTER without OK, empty when stale
 
 };
 
@@ -456,5 +716,33 @@ vector<string> split(const string &s);
  */
 string toUpperCase(const string &input);
 
+/**
+ * @brief Converts meeting times written as text to a weekly bitmask.
+ *
+ * The text is a comma separated list of groups made of day letters (M T W R F) followed by a range of hours,
+ * the end hour excluded, eg: "MWF09-10,TR11-13" for Monday, Wednesday and Friday from 9 to 10 and Tuesday
+ * and Thursday from 11 to 13.
+ *
+ * @return unsigned long long The meeting times as a bitmask, see Course::getMeetingSlots(), or 0 if the text
+ * is not valid.
+ *
+ * @pre Hours are between FIRST_SLOT_HOUR and FIRST_SLOT_HOUR + SLOTS_PER_DAY.
+ *
+ * @post If the text is not valid an error message is printed to the standard error stream (cerr).
+ */
+unsigned long long parseMeetingSlots(const string &text);
+
+/**
+ * @brief Converts a weekly bitmask of meeting times back to text.
+ *
+ * @return string The meeting times in the format read by parseMeetingSlots(), eg: "MWF09-10,TR11-13",
+ * or "TBA" if the bitmask is 0.
+ *
+ * @pre None.
+ *
+ * @post parseMeetingSlots() of the returned text gives back the same bitmask.
+ */
+string formatMeetingSlots(unsigned long long slots);
+
 
 #endif
\ No newline at end of file
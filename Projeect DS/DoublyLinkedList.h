@@ -12,6 +12,9 @@
  * linked list. It allows users to perform operations such as inserting elements at the beginning
  * and end, deleting elements, searching for elements, and displaying the list.
  *
+ * The nodes can also live in a file instead of the heap: DoublyLinkedList<Mapped<Record>>, declared at the end of
+ * this file, keeps the same operations on records linked by their offset in a mapped file (see MappedNodes.h).
+ *
  * Public Member Functions:
  *   1. DoublyLinkedList()
  *   2. DoublyLinkedList(const DoublyLinkedList &)
@@ -29,6 +32,7 @@
  *   14. ElementType* searchAndRetreivePtr(const ElementType &) const
  *   15. DoublyLinkedList &operator=(const DoublyLinkedList &)
  *   16. ostream &displayList(ostream &) const
+ *   17. void forEach(Function) const
  *
  * Overloaded Operators:
  *   1. ostream &operator<<(ostream &, const DoublyLinkedList<ElementType> &)
@@ -40,6 +44,7 @@
 #define DSPROJ_DOUBLYLINKEDLIST_H
 
 #include "iostream"
+#include "MappedNodes.h"
 
 using namespace std;
 
@@ -428,6 +433,26 @@ public:
  */
     ostream &displayList(ostream &) const;
 
+    /**
+ * @brief Apply a function to every element of the list, in order.
+ *
+ * This method walks the list once from the first element to the last and calls the provided
+ * function with a reference to each element.
+ *
+ * @tparam Function A callable taking an ElementType reference.
+ *
+ * @param visit The function to call for each element.
+ *
+ * @pre None.
+ *
+ * @post The function was called once for every element of the list.
+ *
+ * @details Unlike a loop over retrieveAtIndex, which walks the list from the start for every index,
+ *          this method visits all elements in a single traversal (O(n) instead of O(n^2)).
+ */
+    template<typename Function>
+    void forEach(Function visit) const;
+
 
     //ostream &operator<<(ostream &);
 
@@ -946,6 +971,23 @@ ElementType* DoublyLinkedList<ElementType>::searchAndRetreivePtr(const ElementTy
 }
 
 
+
+
+template<typename ElementType>
+template<typename Function>
+void DoublyLinkedList<ElementType>::forEach(Function visit) const {
+    // Create a pointer to traverse the list
+    DNodePtr dataPtr = myFirst;
+
+    // Traverse the list and visit each element
+    while (dataPtr != nullptr) {
+        visit(dataPtr->data);
+
+        // Move the pointer to the next node
+        dataPtr = dataPtr->next;
+    }
+}
+
 template<typename ElementType>
 ostream & operator<<(ostream & out, const DoublyLinkedList<ElementType> & list){
     return list.displayList(out);
@@ -962,4 +1004,471 @@ istream & operator>>(istream & in,  DoublyLinkedList<ElementType>& list) {
     return in;
 }
 
+
+/**
+ * @brief DoublyLinkedList whose nodes live in a file, see MappedNodes.h.
+ *
+ * The list of records of Course.map: DoublyLinkedList<Mapped<CourseRecord>>. It keeps the operations of the list
+ * above, the nodes link to their neighbours by their offset in the file instead of a DNodePtr, so opening the list
+ * maps the file and the records are there. The first node, the last node and the size are kept in the header of the
+ * file, so both ends are reached without walking the list.
+ *
+ * A list can't be copied: it is the file. A reference to a record stays valid until the next insertion, which
+ * may map the file again at another address.
+ *
+ * Public Member Functions:
+ *   1. DoublyLinkedList()
+ *   2. bool open(const string &)
+ *   3. bool isOpen() const
+ *   4. bool insertAtBegin(const Record &)
+ *   5. bool insertAtEnd(const Record &)
+ *   6. bool deleteFromBegin()
+ *   7. bool deleteFromEnd()
+ *   8. bool deleteAtElement(const Record &)
+ *   9. bool deleteAtIndex(unsigned)
+ *   10. bool isEmpty() const
+ *   11. int getSize() const
+ *   12. Record &retrieveAtIndex(unsigned int) const
+ *   13. int search(const Record &) const
+ *   14. Record* searchAndRetreivePtr(const Record &) const
+ *   15. ostream &displayList(ostream &) const
+ *   16. void forEach(Function) const
+ *   17. void clear()
+ *   18. bool sync()
+ *
+ * @tparam Record The type of the records, trivially copyable.
+ */
+template<typename Record>
+class DoublyLinkedList<Mapped<Record>> {
+private:
+    typedef typename MappedNodes<Record>::Node DNode;
+
+    MappedNodes<Record> nodes; // the file of the nodes, its header holds the first node, the last node and the size
+
+    // The node at an offset of the file
+    DNode &nodeAt(unsigned long long offset) const {
+        return nodes.getNode(offset);
+    }
+
+    // Unlink the node at an offset and give it back to the file
+    void unlink(unsigned long long);
+
+public:
+
+    /**
+ * @brief Default constructor for the mapped DoublyLinkedList.
+ *
+ * @pre None.
+ *
+ * @post No file is mapped, open() must be called before anything else.
+ */
+    DoublyLinkedList() {
+    }
+
+    DoublyLinkedList(const DoublyLinkedList &) = delete;
+    DoublyLinkedList &operator=(const DoublyLinkedList &) = delete;
+
+    /**
+ * @brief Map the file of the list, creating an empty list if it doesn't exist.
+ *
+ * @param path The path of the file, eg: Course.map.
+ *
+ * @return True if the list is ready.
+ *
+ * @pre The list isn't open yet.
+ *
+ * @post The list holds the records left in the file. A file of another record type, damaged or not clean is
+ *       emptied, see MappedNodes::open. On failure an error message is printed to the standard error stream (cerr).
+ */
+    bool open(const string &);
+
+    /**
+ * @brief Check if the file of the list is mapped.
+ *
+ * @return True if open() succeeded.
+ */
+    bool isOpen() const;
+
+    /**
+ * @brief Insert a record at the beginning of the list.
+ *
+ * @param data The record, copied to the file.
+ *
+ * @return True if the record was inserted, false if the file couldn't grow.
+ *
+ * @pre The list is open.
+ *
+ * @post The record is the first of the list. The file may have been mapped again.
+ */
+    bool insertAtBegin(const Record &);
+
+    /**
+ * @brief Insert a record at the end of the list.
+ *
+ * @param data The record, copied to the file.
+ *
+ * @return True if the record was inserted, false if the file couldn't grow.
+ *
+ * @pre The list is open.
+ *
+ * @post The record is the last of the list. The file may have been mapped again.
+ */
+    bool insertAtEnd(const Record &);
+
+    /**
+ * @brief Delete the record at the beginning of the list.
+ *
+ * @return True if a record was deleted, false if the list is empty.
+ *
+ * @pre The list is open.
+ *
+ * @post The node of the record is kept by the file for the next insertion.
+ */
+    bool deleteFromBegin();
+
+    /**
+ * @brief Delete the record at the end of the list.
+ *
+ * @return True if a record was deleted, false if the list is empty.
+ *
+ * @pre The list is open.
+ *
+ * @post The node of the record is kept by the file for the next insertion.
+ */
+    bool deleteFromEnd();
+
+    /**
+ * @brief Delete the first record equal to a record.
+ *
+ * @param e The record to delete, compared with operator==.
+ *
+ * @return True if a record was found and deleted, false otherwise.
+ *
+ * @pre The list is open.
+ */
+    bool deleteAtElement(const Record &);
+
+    /**
+ * @brief Delete the record at an index of the list.
+ *
+ * @param index The index of the record, from 0.
+ *
+ * @return True if the record was deleted, false if the list is empty or the index is out of bounds.
+ *
+ * @pre The list is open.
+ *
+ * @post If the list is empty or the index is out of bounds an error message is displayed and nothing changes.
+ */
+    bool deleteAtIndex(unsigned);
+
+    /**
+ * @brief Check if the list is empty.
+ *
+ * @return True if the list has no record.
+ *
+ * @pre The list is open.
+ */
+    bool isEmpty() const;
+
+    /**
+ * @brief Get the number of records of the list.
+ *
+ * @return The number of records, read from the header of the file.
+ *
+ * @pre The list is open.
+ */
+    int getSize() const;
+
+    /**
+ * @brief Retrieve the record at an index of the list.
+ *
+ * @param index The index of the record, from 0.
+ *
+ * @return A reference to the record, in the mapping.
+ *
+ * @pre The list is open and 0 <= index < size.
+ *
+ * @post If the index is out of bounds an error message is printed and the program ends, as the heap list does.
+ */
+    Record &retrieveAtIndex(unsigned int) const;
+
+    /**
+ * @brief Search for a record in the list.
+ *
+ * @param e The record to search, compared with operator==.
+ *
+ * @return The index of the first equal record, or -1 if there is none.
+ *
+ * @pre The list is open.
+ */
+    int search(const Record &) const;
+
+    /**
+ * @brief Search for a record in the list and retrieve a pointer to it.
+ *
+ * @param e The record to search, compared with operator==.
+ *
+ * @return A pointer to the first equal record, in the mapping, or nullptr if there is none.
+ *
+ * @pre The list is open.
+ */
+    Record* searchAndRetreivePtr(const Record &) const;
+
+    /**
+ * @brief Display the records of the list, one per line.
+ *
+ * @param out The output stream to which the records are printed with operator<<.
+ *
+ * @return A reference to the output stream.
+ *
+ * @pre The list is open.
+ *
+ * @post "Empty List" is printed if the list has no record.
+ */
+    ostream &displayList(ostream &) const;
+
+    /**
+ * @brief Apply a function to every record of the list, in order.
+ *
+ * @tparam Function A callable taking a Record reference.
+ *
+ * @param visit The function to call for each record, the record it receives is in the mapping.
+ *
+ * @pre The list is open.
+ *
+ * @post The function was called once for every record of the list.
+ */
+    template<typename Function>
+    void forEach(Function visit) const;
+
+    /**
+ * @brief Delete every record of the list at once.
+ *
+ * @pre The list is open.
+ *
+ * @post The list is empty, the file keeps its length and its nodes are used again by the next insertions.
+ */
+    void clear();
+
+    /**
+ * @brief Write the list to the disk and mark it clean.
+ *
+ * @return True if the list is on the disk.
+ *
+ * @pre The list is open.
+ *
+ * @post The next open() keeps the list, even after a crash. A list changed since the last sync is emptied by the
+ *       next open().
+ */
+    bool sync();
+
+};
+
+
+template<typename Record>
+bool DoublyLinkedList<Mapped<Record>>::open(const string &path) {
+    return nodes.open(path);
+}
+
+
+template<typename Record>
+bool DoublyLinkedList<Mapped<Record>>::isOpen() const {
+    return nodes.isOpen();
+}
+
+
+template<typename Record>
+bool DoublyLinkedList<Mapped<Record>>::isEmpty() const {
+    return nodes.getHeader().first == 0;
+}
+
+
+template<typename Record>
+bool DoublyLinkedList<Mapped<Record>>::insertAtBegin(const Record &data) {
+    // the file may be mapped again here, so no reference to a node is taken before
+    unsigned long long newNode = nodes.allocateNode(data);
+    if (newNode == 0)
+        return false;
+
+    MappedNodesHeader &header = nodes.getHeader();
+    nodeAt(newNode).next = header.first;
+    if (header.first != 0)
+        nodeAt(header.first).prev = newNode;
+    else
+        header.last = newNode;
+    header.first = newNode;
+    header.size++;
+    return true;
+}
+
+
+template<typename Record>
+bool DoublyLinkedList<Mapped<Record>>::insertAtEnd(const Record &data) {
+    // the file may be mapped again here, so no reference to a node is taken before
+    unsigned long long newNode = nodes.allocateNode(data);
+    if (newNode == 0)
+        return false;
+
+    MappedNodesHeader &header = nodes.getHeader();
+    nodeAt(newNode).prev = header.last;
+    if (header.last != 0)
+        nodeAt(header.last).next = newNode;
+    else
+        header.first = newNode;
+    header.last = newNode;
+    header.size++;
+    return true;
+}
+
+
+template<typename Record>
+void DoublyLinkedList<Mapped<Record>>::unlink(unsigned long long deleteMe) {
+    MappedNodesHeader &header = nodes.getHeader();
+    DNode &node = nodeAt(deleteMe);
+
+    nodes.markChanged();
+    if (node.prev != 0)
+        nodeAt(node.prev).next = node.next;
+    else
+        header.first = node.next;
+    if (node.next != 0)
+        nodeAt(node.next).prev = node.prev;
+    else
+        header.last = node.prev;
+    header.size--;
+    nodes.releaseNode(deleteMe);
+}
+
+
+template<typename Record>
+bool DoublyLinkedList<Mapped<Record>>::deleteFromBegin() {
+    if (isEmpty())
+        return false;
+
+    unlink(nodes.getHeader().first);
+    return true;
+}
+
+
+template<typename Record>
+bool DoublyLinkedList<Mapped<Record>>::deleteFromEnd() {
+    if (isEmpty())
+        return false;
+
+    unlink(nodes.getHeader().last);
+    return true;
+}
+
+
+template<typename Record>
+bool DoublyLinkedList<Mapped<Record>>::deleteAtElement(const Record &e) {
+    for (unsigned long long temp = nodes.getHeader().first; temp != 0; temp = nodeAt(temp).next) {
+        if (nodeAt(temp).data == e) {
+            unlink(temp);
+            return true;
+        }
+    }
+
+    // Element not found in the list
+    return false;
+}
+
+
+template<typename Record>
+bool DoublyLinkedList<Mapped<Record>>::deleteAtIndex(unsigned index) {
+    if (isEmpty()) {
+        cerr << "List is empty" << endl;
+        return false;
+    }
+    if (index >= (unsigned) getSize()) {
+        cerr << "Invalid index" << endl;
+        return false;
+    }
+
+    unsigned long long temp = nodes.getHeader().first;
+    for (unsigned i = 0; i < index; i++)
+        temp = nodeAt(temp).next;
+
+    unlink(temp);
+    return true;
+}
+
+
+template<typename Record>
+int DoublyLinkedList<Mapped<Record>>::getSize() const {
+    return nodes.getHeader().size;
+}
+
+
+template<typename Record>
+Record &DoublyLinkedList<Mapped<Record>>::retrieveAtIndex(unsigned int index) const {
+    if (index >= (unsigned) getSize()) {
+        cerr << "Index out of bounds. Code terminated!!";
+        exit(0);
+    }
+
+    unsigned long long temp = nodes.getHeader().first;
+    for (unsigned i = 0; i < index; i++)
+        temp = nodeAt(temp).next;
+    return nodeAt(temp).data;
+}
+
+
+template<typename Record>
+int DoublyLinkedList<Mapped<Record>>::search(const Record &e) const {
+    int counter = 0;
+    for (unsigned long long temp = nodes.getHeader().first; temp != 0; temp = nodeAt(temp).next, counter++) {
+        if (nodeAt(temp).data == e)
+            return counter;
+    }
+
+    // Element not found in the list
+    return -1;
+}
+
+
+template<typename Record>
+Record* DoublyLinkedList<Mapped<Record>>::searchAndRetreivePtr(const Record &e) const {
+    for (unsigned long long temp = nodes.getHeader().first; temp != 0; temp = nodeAt(temp).next) {
+        if (nodeAt(temp).data == e)
+            return &nodeAt(temp).data;
+    }
+
+    // Element not found in the list
+    return nullptr;
+}
+
+
+template<typename Record>
+ostream &DoublyLinkedList<Mapped<Record>>::displayList(ostream &out) const {
+    if (isEmpty()) {
+        out << "Empty List";
+        return out;
+    }
+
+    for (unsigned long long dataPtr = nodes.getHeader().first; dataPtr != 0; dataPtr = nodeAt(dataPtr).next)
+        out << nodeAt(dataPtr).data << endl;
+    return out;
+}
+
+
+template<typename Record>
+template<typename Function>
+void DoublyLinkedList<Mapped<Record>>::forEach(Function visit) const {
+    for (unsigned long long dataPtr = nodes.getHeader().first; dataPtr != 0; dataPtr = nodeAt(dataPtr).next)
+        visit(nodeAt(dataPtr).data);
+}
+
+
+template<typename Record>
+void DoublyLinkedList<Mapped<Record>>::clear() {
+    nodes.clear();
+}
+
+
+template<typename Record>
+bool DoublyLinkedList<Mapped<Record>>::sync() {
+    return nodes.sync();
+}
+
 #endif //DSPROJ_DOUBLYLINKEDLIST_H
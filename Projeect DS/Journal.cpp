@@ -0,0 +1,360 @@
+#include "Journal.h"
+#include <cstring>
+#include <cstdio>
+#include <chrono>
+#include <thread>
+#include <atomic>
+#include <iomanip>
+#include <fcntl.h>
+#include <unistd.h>
+
+using namespace std;
+
+static_assert(sizeof(JournalRecord) == 40, "journal records are written as 40 bytes");
+
+
+// number of records read from the disk at once when the journal is read back
+const size_t READ_BLOCK_RECORDS = 4096;
+
+
+// checksum of the record, computed with the checksum field at 0
+static unsigned int checksumOf(JournalRecord record) {
+    record.checksum = 0;
+    return journalChecksum(&record, sizeof(record));
+}
+
+
+Journal::Journal() {
+    fileDescriptor = -1;
+    nextSequence = 1;
+    durableSequence = 0;
+    syncs = 0;
+    records = 0;
+    flushing = false;
+    failed = false;
+}
+
+
+Journal::~Journal() {
+    close();
+}
+
+
+bool Journal::open(const string &path, unsigned long long nextSequence, long long validLength) {
+    lock_guard<mutex> lock(journalMutex);
+
+    fileDescriptor = ::open(path.c_str(), O_WRONLY | O_CREAT | O_APPEND, 0644);
+    if (fileDescriptor == -1) {
+        cerr << "The journal " << path << " can't be opened, the enrollments will not be saved." << endl;
+        return false;
+    }
+    this->path = path;
+
+    // cut off the torn records left by a crash so the new records follow the last complete operation
+    if (validLength >= 0 && ftruncate(fileDescriptor, validLength) != 0)
+        cerr << "The torn end of the journal " << path << " couldn't be removed." << endl;
+
+    this->nextSequence = nextSequence;
+    durableSequence = nextSequence - 1;
+    syncs = 0;
+    records = 0;
+    failed = false;
+    return true;
+}
+
+
+void Journal::close() {
+    unsigned long long last;
+    {
+        lock_guard<mutex> lock(journalMutex);
+        if (fileDescriptor == -1)
+            return;
+        last = nextSequence - 1;
+    }
+
+    // write what is still buffered before closing
+    waitDurable(last);
+
+    lock_guard<mutex> lock(journalMutex);
+    ::close(fileDescriptor);
+    fileDescriptor = -1;
+}
+
+
+bool Journal::isOpen() const {
+    lock_guard<mutex> lock(journalMutex);
+    return fileDescriptor != -1;
+}
+
+
+unsigned long long Journal::append(vector<JournalRecord> &operation) {
+    lock_guard<mutex> lock(journalMutex);
+
+    if (fileDescriptor == -1 || operation.empty() || failed)
+        return 0;
+
+    for (JournalRecord &record: operation) {
+        record.sequence = nextSequence++;
+        record.checksum = checksumOf(record);
+        buffer.push_back(record);
+    }
+    records += operation.size();
+
+    return nextSequence - 1;
+}
+
+
+bool Journal::waitDurable(unsigned long long sequence) {
+    unique_lock<mutex> lock(journalMutex);
+
+    while (durableSequence < sequence && !failed) {
+        if (flushing) {
+            // a leader is writing, the records appended meanwhile go in the next group
+            flushed.wait(lock);
+            continue;
+        }
+
+        // become the leader of the group made of everything buffered so far
+        flushing = true;
+        vector<JournalRecord> group;
+        group.swap(buffer);
+        unsigned long long last = nextSequence - 1;
+
+        lock.unlock();
+        bool written = writeAndSync(group);
+        lock.lock();
+
+        flushing = false;
+        syncs++;
+        if (written) {
+            durableSequence = last;
+        } else {
+            // the records appended during the failed write will never be written either
+            failed = true;
+            buffer.clear();
+        }
+        flushed.notify_all();
+    }
+
+    return durableSequence >= sequence;
+}
+
+
+unsigned long long Journal::getDurableSequence() const {
+    lock_guard<mutex> lock(journalMutex);
+    return durableSequence;
+}
+
+
+bool Journal::hasFailed() const {
+    lock_guard<mutex> lock(journalMutex);
+    return failed;
+}
+
+
+unsigned long long Journal::getNumberOfSyncs() const {
+    lock_guard<mutex> lock(journalMutex);
+    return syncs;
+}
+
+
+unsigned long long Journal::getNumberOfRecords() const {
+    lock_guard<mutex> lock(journalMutex);
+    return records;
+}
+
+
+unsigned long long Journal::getLastSequence() const {
+    lock_guard<mutex> lock(journalMutex);
+    return nextSequence - 1;
+}
+
+
+bool Journal::writeAndSync(const vector<JournalRecord> &group) {
+    const char *bytes = reinterpret_cast<const char *>(group.data());
+    size_t length = group.size() * sizeof(JournalRecord);
+
+    // write can accept only part of the bytes, keep going until the whole group is written
+    while (length > 0) {
+        ssize_t written = write(fileDescriptor, bytes, length);
+        if (written < 0) {
+            cerr << "Writing the journal failed, the last enrollments are not saved." << endl;
+            return false;
+        }
+        bytes += written;
+        length -= written;
+    }
+
+    if (fdatasync(fileDescriptor) != 0) {
+        cerr << "Syncing the journal failed, the last enrollments are not saved." << endl;
+        return false;
+    }
+    return true;
+}
+
+
+bool Journal::rotate(const string &segmentPath) {
+    unique_lock<mutex> lock(journalMutex);
+    if (fileDescriptor == -1)
+        return false;
+
+    // the group being written goes to the current file, the next one to the new file
+    while (flushing)
+        flushed.wait(lock);
+
+    if (rename(path.c_str(), segmentPath.c_str()) != 0) {
+        cerr << "The journal " << path << " can't be moved to " << segmentPath << ", it is not compacted." << endl;
+        return false;
+    }
+
+    int newFile = ::open(path.c_str(), O_WRONLY | O_CREAT | O_APPEND | O_TRUNC, 0644);
+    if (newFile == -1) {
+        cerr << "A new journal " << path << " can't be created, the journal continues in " << segmentPath << "." << endl;
+        rename(segmentPath.c_str(), path.c_str());
+        return false;
+    }
+
+    // the renames must be on the disk before a record is only in the new file
+    syncDirectoryOf(path);
+
+    ::close(fileDescriptor);
+    fileDescriptor = newFile;
+    return true;
+}
+
+
+long long Journal::readRecords(const string &path, unsigned long long afterSequence, vector<JournalRecord> &tail,
+                               unsigned long long &lastSequence, long long &validLength, RateLimiter *limiter) {
+    lastSequence = 0;
+    validLength = 0;
+
+    FILE *file = fopen(path.c_str(), "rb");
+    if (file == nullptr)
+        return access(path.c_str(), F_OK) == 0 ? -1 : 0; // a missing journal is an empty one
+
+    long long operations = 0;
+    long long length = 0;
+    unsigned long long sequence = 0;
+    size_t operationStart = tail.size(); // first record of the operation being read
+    vector<JournalRecord> block(READ_BLOCK_RECORDS);
+    bool torn = false;
+    size_t count;
+
+    while (!torn) {
+        if (limiter != nullptr)
+            limiter->acquire(block.size() * sizeof(JournalRecord));
+        if ((count = fread(block.data(), sizeof(JournalRecord), block.size(), file)) == 0)
+            break;
+
+        for (size_t i = 0; i < count; i++) {
+            const JournalRecord &record = block[i];
+
+            // a torn or foreign record ends the journal
+            if (record.checksum != checksumOf(record) || (sequence != 0 && record.sequence != sequence + 1)) {
+                torn = true;
+                break;
+            }
+
+            sequence = record.sequence;
+            length += sizeof(record);
+            if (sequence > afterSequence)
+                tail.push_back(record);
+
+            if (record.flags & JOURNAL_END) {
+                if (sequence > afterSequence)
+                    operations++;
+                operationStart = tail.size();
+                lastSequence = sequence;
+                validLength = length;
+            }
+        }
+    }
+
+    // the records of an operation without its end are dropped
+    tail.resize(operationStart);
+    fclose(file);
+    return operations;
+}
+
+
+JournalRecord makeJournalRecord(unsigned char type, const string &studentId, const string &courseCode, int section) {
+    JournalRecord record;
+    memset(&record, 0, sizeof(record));
+
+    record.type = type;
+    record.section = section;
+    strncpy(record.studentId, studentId.c_str(), sizeof(record.studentId) - 1);
+    strncpy(record.courseCode, courseCode.c_str(), sizeof(record.courseCode) - 1);
+    return record;
+}
+
+
+void benchmarkJournal(const string &path, ostream &out) {
+    const int writerCounts[] = {1, 2, 4, 8, 16, 32, 64, 128};
+
+    out << left << setw(10) << "Writers" << setw(16) << "Commits/s" << setw(10) << "Syncs"
+        << setw(12) << "Batch size" << endl;
+
+    for (int writers: writerCounts) {
+        remove(path.c_str());
+        Journal journal;
+        if (!journal.open(path, 1))
+            return;
+
+        atomic<bool> stop(false);
+        atomic<long long> commits(0);
+        vector<thread> threads;
+
+        auto start = chrono::steady_clock::now();
+        for (int i = 0; i < writers; i++) {
+            threads.emplace_back([&journal, &stop, &commits, i]() {
+                vector<JournalRecord> operation(1, makeJournalRecord(JOURNAL_REGISTER, "A" + to_string(i), "BENCH", 1));
+                while (!stop) {
+                    operation[0].flags = JOURNAL_END;
+                    if (!journal.waitDurable(journal.append(operation)))
+                        return;
+                    commits++;
+                }
+            });
+        }
+
+        this_thread::sleep_for(chrono::seconds(1));
+        stop = true;
+        for (thread &writer: threads)
+            writer.join();
+        double seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+
+        unsigned long long syncs = journal.getNumberOfSyncs();
+        out << left << setw(10) << writers << setw(16) << fixed << setprecision(0) << commits / seconds
+            << setw(10) << syncs << setw(12) << setprecision(1) << (syncs == 0 ? 0.0 : (double) commits / syncs)
+            << endl;
+    }
+
+    remove(path.c_str());
+}
+
+
+unsigned int journalChecksum(const void *bytes, size_t length) {
+    const unsigned char *data = static_cast<const unsigned char *>(bytes);
+
+    unsigned int hash = 2166136261u;
+    for (size_t i = 0; i < length; i++) {
+        hash ^= data[i];
+        hash *= 16777619u;
+    }
+    return hash;
+}
+
+
+bool syncDirectoryOf(const string &path) {
+    // a backslash is part of a file name for the POSIX calls used here, eg: the Windows style data paths of main()
+    size_t separator = path.find_last_of('/');
+    string directory = separator == string::npos ? "." : path.substr(0, separator + 1);
+    int directoryDescriptor = ::open(directory.c_str(), O_RDONLY);
+    if (directoryDescriptor == -1)
+        return false;
+
+    bool synced = fsync(directoryDescriptor) == 0;
+    ::close(directoryDescriptor);
+    return synced;
+}
@@ -0,0 +1,314 @@
+/**
+
+    @file Journal.h
+    @brief Declaration of the Journal class and its member functions.
+
+    This file contains the declaration of the Journal class, a binary write-ahead journal of the registration
+    events (a student registered in or dropped from a course).
+
+    date 18 Oct 2026
+
+    Every mutation of the registry is appended to the journal as a fixed size record before the caller is told
+    it succeeded, so the enrollments survive the end of the program and are replayed at the next start. The
+    records of one operation (eg: a bundle of courses) are written together and the last one is flagged, so an
+    operation interrupted by a crash is never replayed halfway.
+
+    Writing to the disk is done with group commit: the callers append their records to a shared buffer and
+    wait for them to be durable. The first waiter becomes the leader, writes everything buffered so far and
+    calls fsync once for all of them while the others keep appending. The cost of one fsync is shared by every
+    writer that arrived during the previous one, so durability doesn't cap the number of registrations per second.
+
+    The journal is kept short by compaction: rotate() renames the file to a segment (the path followed by
+    JOURNAL_SEGMENT_SUFFIX) and continues in a new empty file, the segment is then folded into the snapshot and
+    deleted, see Registry::startCompaction. Until then a recovery reads the segment before the journal file.
+
+    Public Member Functions:
+        1. Journal()
+        2. ~Journal()
+        3. open(const string &, unsigned long long, long long): bool
+        4. close(): void
+        5. isOpen() const: bool
+        6. append(vector<JournalRecord> &): unsigned long long
+        7. waitDurable(unsigned long long): bool
+        8. getDurableSequence() const: unsigned long long
+        9. hasFailed() const: bool
+        10. getNumberOfSyncs() const: unsigned long long
+        11. getNumberOfRecords() const: unsigned long long
+        12. getLastSequence() const: unsigned long long
+        13. readRecords(const string &, unsigned long long, vector<JournalRecord> &, unsigned long long &, long long &, RateLimiter *): long long
+        14. rotate(const string &): bool
+
+    Free Functions:
+        1. makeJournalRecord(unsigned char, const string &, const string &, int): JournalRecord
+        2. benchmarkJournal(const string &, ostream &): void
+        3. journalChecksum(const void *, size_t): unsigned int
+        4. syncDirectoryOf(const string &): bool
+*/
+
+#ifndef DSPROJ_JOURNAL_H
+#define DSPROJ_JOURNAL_H
+
+#include <string>
+#include <vector>
+#include <mutex>
+#include <condition_variable>
+#include <iostream>
+#include "RateLimiter.h"
+
+using namespace std;
+
+// types of the journal records
+const unsigned char JOURNAL_REGISTER = 1;
+const unsigned char JOURNAL_DROP = 2;
+
+// flag of the last record of an operation, the operation is replayed only if this record is in the journal
+const unsigned char JOURNAL_END = 1;
+
+// added to the path of the journal to name the segment waiting to be folded into the snapshot
+const string JOURNAL_SEGMENT_SUFFIX = ".compacting";
+
+// one registration event as it is written on the disk, 40 bytes without padding
+struct JournalRecord {
+    unsigned long long sequence; // position of the record in the journal, starting at 1
+    unsigned int checksum;       // FNV-1a of the record with this field at 0, detects a torn write
+    unsigned char type;          // JOURNAL_REGISTER or JOURNAL_DROP
+    unsigned char flags;         // JOURNAL_END on the last record of an operation
+    unsigned short section;      // section the student was placed in, for a registration
+    char studentId[12];          // null terminated
+    char courseCode[12];         // null terminated
+};
+
+class Journal {
+public:
+
+    /**
+ * @brief Constructor for the Journal class.
+ *
+ * @pre None.
+ *
+ * @post The journal is closed: nothing is written until open() is called.
+ */
+    Journal();
+
+    /**
+ * @brief Destructor for the Journal class.
+ *
+ * @pre No thread is waiting for its records to be durable.
+ *
+ * @post The buffered records are written and the file is closed.
+ */
+    ~Journal();
+
+    /**
+ * @brief Open the journal file to append records to it.
+ *
+ * @param path The path of the journal file, it is created if it doesn't exist.
+ * @param nextSequence The sequence number of the next record, one after the last replayed record.
+ * @param validLength The length of the valid records of the file as returned by readRecords(), anything after
+ * (a record torn by a crash) is cut off. -1 keeps the file as it is.
+ * @return bool True if the file is open.
+ *
+ * @pre The journal is closed.
+ *
+ * @post On failure an error message is printed to the standard error stream (cerr).
+ */
+    bool open(const string &, unsigned long long, long long validLength = -1);
+
+    /**
+ * @brief Write the buffered records and close the journal file.
+ *
+ * @pre No thread is waiting for its records to be durable.
+ *
+ * @post The journal is closed.
+ */
+    void close();
+
+    /**
+ * @brief Check if the journal file is open.
+ *
+ * @return bool True if records are written to a file.
+ */
+    bool isOpen() const;
+
+    /**
+ * @brief Append the records of an operation to the journal buffer.
+ *
+ * @param records The records of the operation, their sequence numbers and checksums are filled here.
+ * @return unsigned long long The sequence number of the last record, to pass to waitDurable(), or 0 if
+ * there is no record, the journal is closed or it failed.
+ *
+ * @pre The last record of the operation has the JOURNAL_END flag.
+ *
+ * @post The records are buffered in the order of the calls, nothing is written to the disk yet. Once a write
+ *       failed the records are refused: they could never be written, the buffer would only grow.
+ *
+ * @details The registry calls this while it holds its own lock, so the order of the records is the order in
+ * which the mutations were applied, and waits for durability after releasing it.
+ */
+    unsigned long long append(vector<JournalRecord> &);
+
+    /**
+ * @brief Wait until a record and every record before it are written and synced to the disk.
+ *
+ * @param sequence The sequence number returned by append().
+ * @return bool True if the record is durable, false if writing the journal failed.
+ *
+ * @pre None.
+ *
+ * @post On success the record survives a crash of the program or of the machine.
+ *
+ * @details If no write is in progress the caller becomes the leader: it takes the whole buffer, writes it and
+ * calls fsync without holding the lock, then wakes up every waiter covered by this sync. Otherwise it waits for
+ * the current leader and checks again, and may become the leader of the next group.
+ */
+    bool waitDurable(unsigned long long);
+
+    /**
+ * @brief Get the sequence number of the last durable record.
+ *
+ * @return unsigned long long Every record up to this one is synced to the disk.
+ */
+    unsigned long long getDurableSequence() const;
+
+    /**
+ * @brief Check if writing or syncing the journal failed since it was opened.
+ *
+ * @return bool True if no record is made durable anymore, see append().
+ */
+    bool hasFailed() const;
+
+    /**
+ * @brief Get the number of times the journal was synced to the disk since it was opened.
+ *
+ * @return unsigned long long The number of fsync calls, records / syncs is the average size of a group.
+ */
+    unsigned long long getNumberOfSyncs() const;
+
+    /**
+ * @brief Get the number of records appended since the journal was opened.
+ *
+ * @return unsigned long long The number of records.
+ */
+    unsigned long long getNumberOfRecords() const;
+
+    /**
+ * @brief Get the sequence number of the last appended record, durable or not.
+ *
+ * @return unsigned long long The sequence number, the state of the registry includes every record up to it.
+ */
+    unsigned long long getLastSequence() const;
+
+    /**
+ * @brief Read the records of the complete operations of a journal file.
+ *
+ * @param path The path of the journal file.
+ * @param afterSequence Only the records after this sequence number are kept, eg: the sequence of a snapshot.
+ * @param tail Receives the records kept, in the order of the journal.
+ * @param lastSequence Set to the sequence number of the last complete operation read, 0 if none.
+ * @param validLength Set to the length of the file up to the end of the last complete operation.
+ * @param limiter Paces the reads when not null, eg: for a compaction running next to the registrations.
+ * @return long long The number of operations kept, or -1 if the file exists but can't be read.
+ *
+ * @pre The journal file is not being written.
+ *
+ * @post A missing file is an empty journal. The reading stops at the first record that is torn (wrong
+ *       checksum, short read or out of sequence), the records of an operation without its JOURNAL_END record
+ *       are not kept.
+ *
+ * @details The file is read in large blocks, the records are only checked here and applied by the caller,
+ * see Registry::recover.
+ */
+    static long long readRecords(const string &, unsigned long long, vector<JournalRecord> &,
+                                 unsigned long long &, long long &, RateLimiter *limiter = nullptr);
+
+    /**
+ * @brief Move the records written so far to a segment file and continue the journal in a new empty file.
+ *
+ * @param segmentPath The path the journal file is renamed to, it must not exist.
+ * @return bool True if the journal now writes to a new file, false if it was left as it is.
+ *
+ * @pre The journal is open.
+ *
+ * @post The segment holds every record up to getDurableSequence() and is not written anymore. The records
+ *       buffered but not written yet go to the new file. On failure an error message is printed to the standard
+ *       error stream (cerr).
+ *
+ * @details The rotation waits for the group being written, if any, so a group never spans the two files, and
+ * never splits an operation since an operation is appended to the buffer at once. Both renames are made durable
+ * by syncing the directory before the new file receives records.
+ */
+    bool rotate(const string &);
+
+private:
+    // Write the records to the file and sync it, without holding the lock
+    bool writeAndSync(const vector<JournalRecord> &);
+
+    int fileDescriptor;                // -1 when the journal is closed
+    string path;                       // path of the journal file, renamed by rotate()
+    vector<JournalRecord> buffer;      // records appended but not written yet
+    unsigned long long nextSequence;   // sequence number of the next appended record
+    unsigned long long durableSequence;
+    unsigned long long syncs;
+    unsigned long long records;
+    bool flushing;                     // a leader is writing a group
+    bool failed;                       // a write or a sync failed, nothing is durable anymore
+
+    mutable mutex journalMutex;
+    condition_variable flushed;        // notified when a group is durable
+
+};
+
+/**
+ * @brief Build a journal record for a student and a course.
+ *
+ * @param type JOURNAL_REGISTER or JOURNAL_DROP.
+ * @param studentId The ID of the student.
+ * @param courseCode The code of the course.
+ * @param section The section of the student in the course, 0 for a drop.
+ * @return JournalRecord The record, without its sequence number, checksum and flags.
+ *
+ * @pre The ID and the code are at most 11 characters long.
+ *
+ * @post None.
+ */
+JournalRecord makeJournalRecord(unsigned char type, const string &studentId, const string &courseCode, int section);
+
+/**
+ * @brief Measure how many operations per second the journal makes durable for different group sizes.
+ *
+ * @param path The path of a scratch journal file, it is deleted at the end.
+ * @param out The output stream of the results.
+ *
+ * @pre The directory of the path is on the disk to measure.
+ *
+ * @post One line per number of concurrent writers is written to out: the commits per second, the number of
+ *       fsync calls and the average number of operations made durable by one fsync (the batch size).
+ *
+ * @details Each writer thread appends one single record operation and waits for it to be durable, in a loop
+ * for one second. With one writer every commit pays its own fsync, with more writers group commit gathers the
+ * operations that arrive during a sync into the next one.
+ */
+void benchmarkJournal(const string &path, ostream &out);
+
+/**
+ * @brief Compute the FNV-1a hash of a block of bytes.
+ *
+ * @param bytes The first byte of the block.
+ * @param length The number of bytes.
+ * @return unsigned int The hash, used to detect torn or corrupted records and files.
+ */
+unsigned int journalChecksum(const void *bytes, size_t length);
+
+/**
+ * @brief Write the entries of the directory holding a file to the disk.
+ *
+ * @param path The path of the file, its directory is the part before the last '/', "." if there is none.
+ * @return bool True if the directory was synced.
+ *
+ * @pre None.
+ *
+ * @post A rename or a creation of a file in the directory done before the call survives a crash.
+ */
+bool syncDirectoryOf(const string &path);
+
+#endif //DSPROJ_JOURNAL_H
@@ -12,6 +12,9 @@
  * It simplifies linked list operations by including a dummy node, which serves as a placeholder and simplifies
  * insertion and deletion operations.
  *
+ * The nodes can also live in a file instead of the heap: LListWithDummyNode<Mapped<Record>>, declared at the end of
+ * this file, keeps the same operations on records linked by their offset in a mapped file (see MappedNodes.h).
+ *
  * Public Member Functions:
  *   1. LListWithDummyNode()
  *   2. LListWithDummyNode(const LListWithDummyNode &)
@@ -29,6 +32,8 @@
  *   14. ElementType* searchAndRetreivePtr(const ElementType &) const
  *   15. LListWithDummyNode &operator=(const LListWithDummyNode &)
  *   16. ostream &displayList(ostream &) const
+ *   17. void forEach(Function) const
+ *   18. int deleteIf(Predicate)
  *
  * Overloaded Operators:
  *   1. ostream &operator<<(ostream &, const LListWithDummyNode<ElementType> &)
@@ -43,6 +48,7 @@
 #include "iostream"
 #include "Course.h"
 #include "Student.h"
+#include "MappedNodes.h"
 
 using namespace std;
 
@@ -449,6 +455,47 @@ public:
  */
     ostream &displayList(ostream &) const;
 
+    /**
+ * @brief Apply a function to every element of the list, in order.
+ *
+ * This method walks the list once from the first element to the last and calls the provided
+ * function with a reference to each element.
+ *
+ * @tparam Function A callable taking an ElementType reference.
+ *
+ * @param visit The function to call for each element.
+ *
+ * @pre None.
+ *
+ * @post The function was called once for every element of the list.
+ *
+ * @details Unlike a loop over retrieveAtIndex, which walks the list from the start for every index,
+ *          this method visits all elements in a single traversal (O(n) instead of O(n^2)).
+ */
+    template<typename Function>
+    void forEach(Function visit) const;
+
+    /**
+ * @brief Delete every element of the list for which a predicate is true.
+ *
+ * This method walks the list once and deletes the nodes whose element satisfies the predicate.
+ *
+ * @tparam Predicate A callable taking a constant ElementType reference and returning bool.
+ *
+ * @param shouldDelete The predicate selecting the elements to delete.
+ *
+ * @return The number of deleted elements.
+ *
+ * @pre None.
+ *
+ * @post No element of the list satisfies the predicate, the size is decremented accordingly.
+ *
+ * @details Deleting k elements with deleteAtElement walks the list k times; this method deletes
+ *          all of them in a single traversal using a pointer to the previous node.
+ */
+    template<typename Predicate>
+    int deleteIf(Predicate shouldDelete);
+
 
 
 };
@@ -913,6 +960,51 @@ ostream & LListWithDummyNode<ElementType>::displayList(ostream & out) const {
 
 
 
+
+
+template<typename ElementType>
+template<typename Function>
+void LListWithDummyNode<ElementType>::forEach(Function visit) const {
+    // Create a pointer to traverse the list
+    NodePtr dataPtr = myFirst->next;
+
+    // Traverse the list and visit each element
+    while (dataPtr != nullptr) {
+        visit(dataPtr->data);
+
+        // Move the pointer to the next node
+        dataPtr = dataPtr->next;
+    }
+}
+
+
+
+template<typename ElementType>
+template<typename Predicate>
+int LListWithDummyNode<ElementType>::deleteIf(Predicate shouldDelete) {
+    int deleted = 0;
+
+    // Create pointers to traverse the list, starting from the dummy node
+    NodePtr prev = myFirst;
+    NodePtr temp = myFirst->next;
+
+    while (temp != nullptr) {
+        if (shouldDelete(temp->data)) {
+            // Update the next pointer of the previous node to skip the node to be deleted
+            prev->next = temp->next;
+            delete temp;
+            mySize--;
+            deleted++;
+        } else
+            prev = temp;
+
+        // Move to the node following the previous one
+        temp = prev->next;
+    }
+
+    return deleted;
+}
+
 template<typename ElementType>
 ostream & operator<<(ostream & out, const LListWithDummyNode<ElementType> & list){
     return list.displayList(out);
@@ -931,4 +1023,508 @@ istream & operator>>(istream & in,  LListWithDummyNode<ElementType>& list){
 
 
 
+/**
+ * @brief LListWithDummyNode whose nodes live in a file, see MappedNodes.h.
+ *
+ * The list of records of Student.map: LListWithDummyNode<Mapped<StudentRecord>>. It keeps the dummy node and the
+ * operations of the list above, the nodes link to each other by their offset in the file instead of a NodePtr,
+ * so opening the list maps the file and the records are there. The size and the last node are kept in the header of
+ * the file, so insertAtEnd doesn't walk the list.
+ *
+ * A list can't be copied: it is the file. A reference to a record stays valid until the next insertion, which
+ * may map the file again at another address.
+ *
+ * Public Member Functions:
+ *   1. LListWithDummyNode()
+ *   2. bool open(const string &)
+ *   3. bool isOpen() const
+ *   4. bool isEmpty() const
+ *   5. bool insertAtBegin(const Record &)
+ *   6. bool insertAtEnd(const Record &)
+ *   7. bool deleteFromBegin()
+ *   8. bool deleteFromEnd()
+ *   9. bool deleteAtIndex(unsigned)
+ *   10. bool deleteAtElement(const Record &)
+ *   11. int getSize() const
+ *   12. Record &retrieveAtIndex(unsigned) const
+ *   13. int search(const Record &) const
+ *   14. Record* searchAndRetreivePtr(const Record &) const
+ *   15. ostream &displayList(ostream &) const
+ *   16. void forEach(Function) const
+ *   17. int deleteIf(Predicate)
+ *   18. void clear()
+ *   19. bool sync()
+ *
+ * @tparam Record The type of the records, trivially copyable.
+ */
+template<typename Record>
+class LListWithDummyNode<Mapped<Record>> {
+private:
+    typedef typename MappedNodes<Record>::Node Node;
+
+    // Offset of the dummy node in the file
+    static constexpr unsigned long long myFirst = MappedNodes<Record>::DUMMY_NODE;
+
+    // Private members of the mapped LListWithDummyNode class
+    MappedNodes<Record> nodes; // the file of the nodes, its header holds the size and the last node
+
+    // The node at an offset of the file
+    Node &nodeAt(unsigned long long offset) const {
+        return nodes.getNode(offset);
+    }
+
+    // Link a new node after the node at an offset; false if the file couldn't grow
+    bool insertAfter(unsigned long long, const Record &);
+
+    // Unlink the node following the node at an offset and give it back to the file
+    void deleteAfter(unsigned long long);
+
+public:
+
+    /**
+ * @brief Default constructor for the mapped LListWithDummyNode.
+ *
+ * @pre None.
+ *
+ * @post No file is mapped, open() must be called before anything else.
+ */
+    LListWithDummyNode() {
+    }
+
+    LListWithDummyNode(const LListWithDummyNode &) = delete;
+    LListWithDummyNode &operator=(const LListWithDummyNode &) = delete;
+
+    /**
+ * @brief Map the file of the list, creating an empty list if it doesn't exist.
+ *
+ * @param path The path of the file, eg: Student.map.
+ *
+ * @return True if the list is ready.
+ *
+ * @pre The list isn't open yet.
+ *
+ * @post The list holds the records left in the file. A file of another record type, damaged or not clean is
+ *       emptied, see MappedNodes::open. On failure an error message is printed to the standard error stream (cerr).
+ */
+    bool open(const string &);
+
+    /**
+ * @brief Check if the file of the list is mapped.
+ *
+ * @return True if open() succeeded.
+ */
+    bool isOpen() const;
+
+    /**
+ * @brief Check if the list is empty.
+ *
+ * @return True if the dummy node has no next node.
+ *
+ * @pre The list is open.
+ */
+    bool isEmpty() const;
+
+    /**
+ * @brief Insert a record at the beginning of the list.
+ *
+ * @param data The record, copied to the file.
+ *
+ * @return True if the record was inserted, false if the file couldn't grow.
+ *
+ * @pre The list is open.
+ *
+ * @post The record follows the dummy node. The file may have been mapped again.
+ */
+    bool insertAtBegin(const Record &);
+
+    /**
+ * @brief Insert a record at the end of the list.
+ *
+ * @param data The record, copied to the file.
+ *
+ * @return True if the record was inserted, false if the file couldn't grow.
+ *
+ * @pre The list is open.
+ *
+ * @post The record is the last of the list. The file may have been mapped again.
+ *
+ * @details The last node is read from the header of the file, the list isn't walked.
+ */
+    bool insertAtEnd(const Record &);
+
+    /**
+ * @brief Delete the record at the beginning of the list.
+ *
+ * @return True if a record was deleted, false if the list is empty.
+ *
+ * @pre The list is open.
+ *
+ * @post The node of the record is kept by the file for the next insertion.
+ */
+    bool deleteFromBegin();
+
+    /**
+ * @brief Delete the record at the end of the list.
+ *
+ * @return True if a record was deleted, false if the list is empty.
+ *
+ * @pre The list is open.
+ *
+ * @post The node of the record is kept by the file for the next insertion.
+ *
+ * @details The list is walked to find the node before the last one, the nodes only link to their next node.
+ */
+    bool deleteFromEnd();
+
+    /**
+ * @brief Delete the record at an index of the list.
+ *
+ * @param index The index of the record, from 0.
+ *
+ * @return True if the record was deleted, false if the list is empty or the index is out of bounds.
+ *
+ * @pre The list is open.
+ *
+ * @post If the list is empty or the index is out of bounds an error message is displayed and nothing changes.
+ */
+    bool deleteAtIndex(unsigned);
+
+    /**
+ * @brief Delete the first record equal to a record.
+ *
+ * @param e The record to delete, compared with operator==.
+ *
+ * @return True if a record was found and deleted, false otherwise.
+ *
+ * @pre The list is open.
+ */
+    bool deleteAtElement(const Record &);
+
+    /**
+ * @brief Get the number of records of the list.
+ *
+ * @return The number of records, read from the header of the file.
+ *
+ * @pre The list is open.
+ */
+    int getSize() const;
+
+    /**
+ * @brief Retrieve the record at an index of the list.
+ *
+ * @param index The index of the record, from 0.
+ *
+ * @return A reference to the record, in the mapping.
+ *
+ * @pre The list is open and 0 <= index < size.
+ *
+ * @post If the index is out of bounds an error message is printed and the program ends, as the heap list does.
+ */
+    Record &retrieveAtIndex(unsigned) const;
+
+    /**
+ * @brief Search for a record in the list.
+ *
+ * @param e The record to search, compared with operator==.
+ *
+ * @return The index of the first equal record, or -1 if there is none.
+ *
+ * @pre The list is open.
+ */
+    int search(const Record &) const;
+
+    /**
+ * @brief Search for a record in the list and retrieve a pointer to it.
+ *
+ * @param e The record to search, compared with operator==.
+ *
+ * @return A pointer to the first equal record, in the mapping, or nullptr if there is none.
+ *
+ * @pre The list is open.
+ */
+    Record* searchAndRetreivePtr(const Record &) const;
+
+    /**
+ * @brief Display the records of the list.
+ *
+ * @param out The output stream to which the records are printed with operator<<.
+ *
+ * @return A reference to the output stream.
+ *
+ * @pre The list is open.
+ *
+ * @post "Empty List" is printed if the list has no record.
+ */
+    ostream &displayList(ostream &) const;
+
+    /**
+ * @brief Apply a function to every record of the list, in order.
+ *
+ * @tparam Function A callable taking a Record reference.
+ *
+ * @param visit The function to call for each record, the record it receives is in the mapping.
+ *
+ * @pre The list is open.
+ *
+ * @post The function was called once for every record of the list.
+ */
+    template<typename Function>
+    void forEach(Function visit) const;
+
+    /**
+ * @brief Delete every record of the list for which a predicate is true.
+ *
+ * @tparam Predicate A callable taking a constant Record reference and returning bool.
+ *
+ * @param shouldDelete The predicate selecting the records to delete.
+ *
+ * @return The number of deleted records.
+ *
+ * @pre The list is open.
+ *
+ * @post No record of the list satisfies the predicate, their nodes are kept by the file for the next insertions.
+ */
+    template<typename Predicate>
+    int deleteIf(Predicate shouldDelete);
+
+    /**
+ * @brief Delete every record of the list at once.
+ *
+ * @pre The list is open.
+ *
+ * @post The list is empty, the file keeps its length and its nodes are used again by the next insertions.
+ */
+    void clear();
+
+    /**
+ * @brief Write the list to the disk and mark it clean.
+ *
+ * @return True if the list is on the disk.
+ *
+ * @pre The list is open.
+ *
+ * @post The next open() keeps the list, even after a crash. A list changed since the last sync is emptied by the
+ *       next open().
+ */
+    bool sync();
+
+};
+
+
+template<typename Record>
+bool LListWithDummyNode<Mapped<Record>>::open(const string &path) {
+    return nodes.open(path);
+}
+
+
+template<typename Record>
+bool LListWithDummyNode<Mapped<Record>>::isOpen() const {
+    return nodes.isOpen();
+}
+
+
+template<typename Record>
+bool LListWithDummyNode<Mapped<Record>>::isEmpty() const {
+    return nodeAt(myFirst).next == 0;
+}
+
+
+template<typename Record>
+bool LListWithDummyNode<Mapped<Record>>::insertAfter(unsigned long long prev, const Record &data) {
+    // the file may be mapped again here, so no reference to a node is taken before
+    unsigned long long newNode = nodes.allocateNode(data);
+    if (newNode == 0)
+        return false;
+
+    nodeAt(newNode).next = nodeAt(prev).next;
+    nodeAt(prev).next = newNode;
+    if (nodeAt(newNode).next == 0)
+        nodes.getHeader().last = newNode;
+    nodes.getHeader().size++;
+    return true;
+}
+
+
+template<typename Record>
+void LListWithDummyNode<Mapped<Record>>::deleteAfter(unsigned long long prev) {
+    unsigned long long deleteMe = nodeAt(prev).next;
+
+    nodes.markChanged();
+    nodeAt(prev).next = nodeAt(deleteMe).next;
+    if (nodes.getHeader().last == deleteMe)
+        nodes.getHeader().last = prev == myFirst ? 0 : prev;
+    nodes.getHeader().size--;
+    nodes.releaseNode(deleteMe);
+}
+
+
+template<typename Record>
+bool LListWithDummyNode<Mapped<Record>>::insertAtBegin(const Record &data) {
+    return insertAfter(myFirst, data);
+}
+
+
+template<typename Record>
+bool LListWithDummyNode<Mapped<Record>>::insertAtEnd(const Record &data) {
+    return insertAfter(isEmpty() ? myFirst : nodes.getHeader().last, data);
+}
+
+
+template<typename Record>
+bool LListWithDummyNode<Mapped<Record>>::deleteFromBegin() {
+    if (isEmpty())
+        return false;
+
+    deleteAfter(myFirst);
+    return true;
+}
+
+
+template<typename Record>
+bool LListWithDummyNode<Mapped<Record>>::deleteFromEnd() {
+    if (isEmpty())
+        return false;
+
+    // Traverse the list to find the node before the last one
+    unsigned long long prev = myFirst;
+    while (nodeAt(nodeAt(prev).next).next != 0)
+        prev = nodeAt(prev).next;
+
+    deleteAfter(prev);
+    return true;
+}
+
+
+template<typename Record>
+bool LListWithDummyNode<Mapped<Record>>::deleteAtIndex(unsigned index) {
+    if (isEmpty()) {
+        cerr << "List is empty" << endl;
+        return false;
+    }
+    if (index >= (unsigned) getSize()) {
+        cerr << "Invalid index" << endl;
+        return false;
+    }
+
+    // Traverse the list to the node before the one to be deleted, starting from the dummy node
+    unsigned long long prev = myFirst;
+    for (unsigned i = 0; i < index; i++)
+        prev = nodeAt(prev).next;
+
+    deleteAfter(prev);
+    return true;
+}
+
+
+template<typename Record>
+bool LListWithDummyNode<Mapped<Record>>::deleteAtElement(const Record &e) {
+    for (unsigned long long prev = myFirst; nodeAt(prev).next != 0; prev = nodeAt(prev).next) {
+        if (nodeAt(nodeAt(prev).next).data == e) {
+            deleteAfter(prev);
+            return true;
+        }
+    }
+
+    // Element not found in the list
+    return false;
+}
+
+
+template<typename Record>
+int LListWithDummyNode<Mapped<Record>>::getSize() const {
+    return nodes.getHeader().size;
+}
+
+
+template<typename Record>
+Record &LListWithDummyNode<Mapped<Record>>::retrieveAtIndex(unsigned index) const {
+    if (index >= (unsigned) getSize()) {
+        cerr << "Out of bounds. Code terminated!!";
+        exit(0);
+    }
+
+    unsigned long long temp = nodeAt(myFirst).next;
+    for (unsigned i = 0; i < index; i++)
+        temp = nodeAt(temp).next;
+    return nodeAt(temp).data;
+}
+
+
+template<typename Record>
+int LListWithDummyNode<Mapped<Record>>::search(const Record &e) const {
+    int counter = 0;
+    for (unsigned long long temp = nodeAt(myFirst).next; temp != 0; temp = nodeAt(temp).next, counter++) {
+        if (nodeAt(temp).data == e)
+            return counter;
+    }
+
+    // Element not found in the list
+    return -1;
+}
+
+
+template<typename Record>
+Record* LListWithDummyNode<Mapped<Record>>::searchAndRetreivePtr(const Record &e) const {
+    for (unsigned long long temp = nodeAt(myFirst).next; temp != 0; temp = nodeAt(temp).next) {
+        if (nodeAt(temp).data == e)
+            return &nodeAt(temp).data;
+    }
+
+    // Element not found in the list
+    return nullptr;
+}
+
+
+template<typename Record>
+ostream & LListWithDummyNode<Mapped<Record>>::displayList(ostream &out) const {
+    if (isEmpty()) {
+        out << "Empty List";
+        return out;
+    }
+
+    for (unsigned long long dataPtr = nodeAt(myFirst).next; dataPtr != 0; dataPtr = nodeAt(dataPtr).next)
+        out << nodeAt(dataPtr).data;
+    return out;
+}
+
+
+template<typename Record>
+template<typename Function>
+void LListWithDummyNode<Mapped<Record>>::forEach(Function visit) const {
+    for (unsigned long long dataPtr = nodeAt(myFirst).next; dataPtr != 0; dataPtr = nodeAt(dataPtr).next)
+        visit(nodeAt(dataPtr).data);
+}
+
+
+template<typename Record>
+template<typename Predicate>
+int LListWithDummyNode<Mapped<Record>>::deleteIf(Predicate shouldDelete) {
+    int deleted = 0;
+
+    // the previous node starts at the dummy node and only moves past the nodes that are kept
+    unsigned long long prev = myFirst;
+    while (nodeAt(prev).next != 0) {
+        if (shouldDelete((const Record &) nodeAt(nodeAt(prev).next).data)) {
+            deleteAfter(prev);
+            deleted++;
+        } else
+            prev = nodeAt(prev).next;
+    }
+
+    return deleted;
+}
+
+
+template<typename Record>
+void LListWithDummyNode<Mapped<Record>>::clear() {
+    nodes.clear();
+}
+
+
+template<typename Record>
+bool LListWithDummyNode<Mapped<Record>>::sync() {
+    return nodes.sync();
+}
+
+
 #endif //DSPROJECT_LLISTWITHDUMMYNODE_H
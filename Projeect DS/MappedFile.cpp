@@ -0,0 +1,147 @@
+#include "MappedFile.h"
+#include <iostream>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+using namespace std;
+
+
+MappedFile::MappedFile() {
+    fileDescriptor = -1;
+    writable = true;
+    base = nullptr;
+    length = 0;
+}
+
+
+MappedFile::~MappedFile() {
+    if (base != nullptr)
+        munmap(base, length);
+    if (fileDescriptor != -1)
+        close(fileDescriptor);
+}
+
+
+bool MappedFile::open(const string &path, size_t minimumLength) {
+    this->path = path;
+    fileDescriptor = ::open(path.c_str(), O_RDWR | O_CREAT, 0644);
+    struct stat status;
+    if (fileDescriptor == -1 || fstat(fileDescriptor, &status) != 0) {
+        cerr << "The file " << path << " can't be opened." << endl;
+        if (fileDescriptor != -1)
+            close(fileDescriptor);
+        fileDescriptor = -1;
+        return false;
+    }
+
+    size_t fileLength = status.st_size;
+    if (fileLength < minimumLength) {
+        if (ftruncate(fileDescriptor, minimumLength) != 0) {
+            cerr << "The file " << path << " can't be extended." << endl;
+            close(fileDescriptor);
+            fileDescriptor = -1;
+            return false;
+        }
+        fileLength = minimumLength;
+    }
+
+    void *mapping = mmap(nullptr, fileLength, PROT_READ | PROT_WRITE, MAP_SHARED, fileDescriptor, 0);
+    if (mapping == MAP_FAILED) {
+        cerr << "The file " << path << " can't be mapped." << endl;
+        close(fileDescriptor);
+        fileDescriptor = -1;
+        return false;
+    }
+
+    base = (char *) mapping;
+    length = fileLength;
+    return true;
+}
+
+
+bool MappedFile::openReadOnly(const string &path) {
+    this->path = path;
+    writable = false;
+    fileDescriptor = ::open(path.c_str(), O_RDONLY);
+    struct stat status;
+    if (fileDescriptor == -1 || fstat(fileDescriptor, &status) != 0 || status.st_size == 0) {
+        cerr << "The file " << path << " can't be opened." << endl;
+        if (fileDescriptor != -1)
+            close(fileDescriptor);
+        fileDescriptor = -1;
+        return false;
+    }
+
+    void *mapping = mmap(nullptr, status.st_size, PROT_READ, MAP_SHARED, fileDescriptor, 0);
+    if (mapping == MAP_FAILED) {
+        cerr << "The file " << path << " can't be mapped." << endl;
+        close(fileDescriptor);
+        fileDescriptor = -1;
+        return false;
+    }
+
+    base = (char *) mapping;
+    length = status.st_size;
+    return true;
+}
+
+
+bool MappedFile::remap() {
+    struct stat status;
+    if (fstat(fileDescriptor, &status) != 0)
+        return false;
+    if ((size_t) status.st_size == length)
+        return true;
+
+    void *mapping = mmap(nullptr, status.st_size, writable ? PROT_READ | PROT_WRITE : PROT_READ, MAP_SHARED,
+                         fileDescriptor, 0);
+    if (mapping == MAP_FAILED)
+        return false;
+
+    munmap(base, length);
+    base = (char *) mapping;
+    length = status.st_size;
+    return true;
+}
+
+
+bool MappedFile::resize(size_t newLength) {
+    if (ftruncate(fileDescriptor, newLength) != 0) {
+        cerr << "The file " << path << " can't be extended." << endl;
+        return false;
+    }
+
+    void *mapping = mmap(nullptr, newLength, PROT_READ | PROT_WRITE, MAP_SHARED, fileDescriptor, 0);
+    if (mapping == MAP_FAILED) {
+        cerr << "The file " << path << " can't be mapped." << endl;
+        return false;
+    }
+
+    // the old mapping shows the same pages, nothing has to be copied
+    munmap(base, length);
+    base = (char *) mapping;
+    length = newLength;
+    return true;
+}
+
+
+bool MappedFile::sync() {
+    return base != nullptr && msync(base, length, MS_SYNC) == 0;
+}
+
+
+bool MappedFile::isOpen() const {
+    return base != nullptr;
+}
+
+
+char *MappedFile::getBase() const {
+    return base;
+}
+
+
+size_t MappedFile::getLength() const {
+    return length;
+}
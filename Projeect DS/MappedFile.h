@@ -0,0 +1,148 @@
+/**
+
+    @file MappedFile.h
+    @brief Declaration of the MappedFile class and its member functions.
+
+    This file contains the declaration of the MappedFile class, which maps a whole file in memory so data structures
+    can be kept in it directly, eg: the nodes of the mapped list of the students
+    (see MappedNodes.h).
+
+    date 18 Oct 2026
+
+    The file is mapped shared: a write to the memory is a write to the page cache of the file, the OS writes it to
+    the disk later on its own, or when sync() is called. Growing the file maps it again, maybe at another address,
+    which is why the structures kept in it link their parts with offsets from getBase() and never with pointers.
+
+    Public Member Functions:
+        1. MappedFile()
+        2. ~MappedFile()
+        3. open(const string &, size_t): bool
+        4. resize(size_t): bool
+        5. sync(): bool
+        6. isOpen() const: bool
+        7. getBase() const: char *
+        8. getLength() const: size_t
+        9. openReadOnly(const string &): bool
+        10. remap(): bool
+*/
+
+#ifndef DSPROJ_MAPPEDFILE_H
+#define DSPROJ_MAPPEDFILE_H
+
+#include <string>
+#include <cstddef>
+
+using namespace std;
+
+class MappedFile {
+public:
+
+    /**
+ * @brief Constructor for the MappedFile class.
+ *
+ * @pre None.
+ *
+ * @post No file is mapped.
+ */
+    MappedFile();
+
+    /**
+ * @brief Destructor for the MappedFile class.
+ *
+ * @pre None.
+ *
+ * @post The file is unmapped and closed. What was written to the memory stays in the page cache of the file.
+ */
+    ~MappedFile();
+
+    MappedFile(const MappedFile &) = delete;
+    MappedFile &operator=(const MappedFile &) = delete;
+
+    /**
+ * @brief Map a file, creating it if it doesn't exist.
+ *
+ * @param path The path of the file.
+ * @param minimumLength The file is extended with zeros to at least this many bytes.
+ * @return bool True if the file is mapped.
+ *
+ * @pre No file is mapped yet.
+ *
+ * @post On failure an error message is printed to the standard error stream (cerr) and isOpen() returns false.
+ */
+    bool open(const string &, size_t);
+
+    /**
+ * @brief Map an existing file for reading only, eg: a segment written by another process.
+ *
+ * @param path The path of the file.
+ * @return bool True if the file is mapped.
+ *
+ * @pre No file is mapped yet.
+ *
+ * @post On failure an error message is printed to the standard error stream (cerr) and isOpen() returns false.
+ *       Writing to the mapping is not allowed, resize() must not be called.
+ */
+    bool openReadOnly(const string &);
+
+    /**
+ * @brief Map the file again at its current length, when another process grew it.
+ *
+ * @return bool True if the whole file is mapped.
+ *
+ * @pre The file is mapped.
+ *
+ * @post getBase() may have changed as with resize(). On failure the mapping is unchanged.
+ */
+    bool remap();
+
+    /**
+ * @brief Grow the file and map it again.
+ *
+ * @param length The new length in bytes, the added bytes are zeros.
+ * @return bool True if the file was grown and mapped again.
+ *
+ * @pre The file is mapped and length is larger than getLength().
+ *
+ * @post getBase() may have changed, every pointer in the mapping must be computed again from its offset.
+ *       On failure an error message is printed to the standard error stream (cerr) and the mapping is unchanged.
+ */
+    bool resize(size_t);
+
+    /**
+ * @brief Write the pages changed in the memory to the disk and wait for them.
+ *
+ * @return bool True if the whole mapping is on the disk.
+ */
+    bool sync();
+
+    /**
+ * @brief Check if a file is mapped.
+ *
+ * @return bool True if open() succeeded.
+ */
+    bool isOpen() const;
+
+    /**
+ * @brief Get the address of the first byte of the file.
+ *
+ * @return char * The start of the mapping, nullptr if no file is mapped.
+ */
+    char *getBase() const;
+
+    /**
+ * @brief Get the length of the mapping.
+ *
+ * @return size_t The length of the file in bytes.
+ */
+    size_t getLength() const;
+
+private:
+    string path;
+    int fileDescriptor;    // -1 when no file is mapped
+    bool writable;         // false when mapped by openReadOnly
+    char *base;
+    size_t length;
+
+};
+
+#endif //DSPROJ_MAPPEDFILE_H
@@ -0,0 +1,273 @@
+/**
+
+    @file MappedNodes.h
+    @brief Declaration and implementation of the MappedNodes class template and its member functions.
+
+    This file contains the MappedNodes class template, the storage of the nodes of a list kept in a MappedFile
+    instead of the heap, and the Mapped tag which selects it: LListWithDummyNode<Mapped<StudentRecord>> and
+    DoublyLinkedList<Mapped<CourseRecord>> are the lists of LListWithDummyNode.h and DoublyLinkedList.h whose nodes
+    live in a file, eg: Student.map and Course.map. A start maps the file and the list is there, nothing is parsed
+    or copied.
+
+    date 18 Oct 2026
+
+    The file starts with a MappedNodesHeader, followed by the nodes. A node links to its neighbours by their offset
+    in the file, 0 standing for nullptr (the header is at offset 0), so the list is valid wherever the file is mapped
+    and after it grew. When the file is full it doubles, and the deleted nodes are kept in a free list for the next
+    insertions. The first node of the file is the dummy node of an LListWithDummyNode, a DoublyLinkedList doesn't
+    use it.
+
+    Persistence is left to the page cache of the OS. The header holds a clean flag, cleared before the links change
+    and set again by sync(): a list found not clean by open() was left in the middle of a change by a crash of the
+    process and is emptied. A record changed in place, eg: the GPA of a student, leaves the flag as it is.
+
+    The records are copied with memcpy and must be trivially copyable: no string, pointer or container. A reference
+    to a record stays valid until the next insertion, which may map the file again at another address.
+
+    Public Member Functions:
+        1. MappedNodes()
+        2. open(const string &): bool
+        3. isOpen() const: bool
+        4. getHeader() const: MappedNodesHeader &
+        5. getNode(unsigned long long) const: Node &
+        6. markChanged(): void
+        7. allocateNode(const Record &): unsigned long long
+        8. releaseNode(unsigned long long): void
+        9. clear(): void
+        10. sync(): bool
+
+    @tparam Record The type of the records, trivially copyable.
+*/
+
+#ifndef DSPROJ_MAPPEDNODES_H
+#define DSPROJ_MAPPEDNODES_H
+
+#include "MappedFile.h"
+
+#include <string>
+#include <cstring>
+#include <iostream>
+#include <type_traits>
+
+using namespace std;
+
+// first bytes of a file of mapped nodes
+const char MAPPED_NODES_MAGIC[8] = {'D', 'S', 'M', 'A', 'P', '0', '0', '3'};
+
+// number of nodes of a new file of mapped nodes, the dummy node included
+const unsigned long long MAPPED_NODES_INITIAL_NODES = 64;
+
+// header of a file of mapped nodes, 64 bytes
+struct MappedNodesHeader {
+    char magic[8];                  // MAPPED_NODES_MAGIC
+    unsigned int recordSize;        // sizeof(Record), a file of another record type is not opened
+    unsigned int clean;             // 1 when the links didn't change since the last sync()
+    unsigned long long capacity;    // nodes the file has room for
+    unsigned long long used;        // nodes taken from the end of the file since the last clear(), the dummy included
+    unsigned long long freeNodes;   // offset of the first deleted node, linked by their next field, 0 if none
+    unsigned long long size;        // nodes in the list
+    unsigned long long first;       // offset of the first node, 0 if the list is empty
+    unsigned long long last;        // offset of the last node, 0 if the list is empty
+};
+
+// selects the mapped storage of a list, eg: LListWithDummyNode<Mapped<StudentRecord>> holds StudentRecords
+template<typename Record>
+struct Mapped {
+};
+
+template<typename Record>
+class MappedNodes {
+    static_assert(is_trivially_copyable<Record>::value, "the records of a mapped list are copied as bytes");
+
+public:
+    // node of the list, stored in the file
+    struct Node {
+        unsigned long long next;    // offset of the next node, 0 for the last one
+        unsigned long long prev;    // offset of the previous node, 0 for the first one or in a singly linked list
+        Record data;
+    };
+
+    // offset of the dummy node, the first one after the header
+    static constexpr unsigned long long DUMMY_NODE = sizeof(MappedNodesHeader);
+
+    /**
+ * @brief Constructor for the MappedNodes class.
+ *
+ * @pre None.
+ *
+ * @post No file is mapped, open() must be called before anything else.
+ */
+    MappedNodes() {
+    }
+
+    /**
+ * @brief Map the file of the nodes, creating an empty list if it doesn't exist.
+ *
+ * @param path The path of the file, eg: Student.map.
+ * @return bool True if the nodes are ready.
+ *
+ * @pre The file isn't mapped yet.
+ *
+ * @post A file of another record type, damaged or not clean is emptied, with a message on the standard error
+ *       stream (cerr). On failure an error message is printed to the standard error stream (cerr).
+ */
+    bool open(const string &path) {
+        if (!file.open(path, sizeof(MappedNodesHeader) + MAPPED_NODES_INITIAL_NODES * sizeof(Node)))
+            return false;
+
+        MappedNodesHeader &header = getHeader();
+        bool created = header.magic[0] == 0 && header.capacity == 0;
+        bool valid = memcmp(header.magic, MAPPED_NODES_MAGIC, sizeof(header.magic)) == 0 &&
+                     header.recordSize == sizeof(Record) && header.clean == 1 &&
+                     header.used >= 1 && header.used <= header.capacity &&
+                     sizeof(MappedNodesHeader) + header.capacity * sizeof(Node) <= file.getLength();
+        if (!valid) {
+            if (!created && (memcmp(header.magic, MAPPED_NODES_MAGIC, sizeof(header.magic)) != 0 ||
+                             header.recordSize != sizeof(Record)))
+                cerr << "The file " << path << " was written in another format, its list was emptied." << endl;
+            else if (!created)
+                cerr << "The file " << path << " is damaged or wasn't closed cleanly, its list was emptied." << endl;
+            memset(&header, 0, sizeof(header));
+            memcpy(header.magic, MAPPED_NODES_MAGIC, sizeof(header.magic));
+            header.recordSize = sizeof(Record);
+            header.capacity = (file.getLength() - sizeof(MappedNodesHeader)) / sizeof(Node);
+            clear();
+            header.clean = 1;
+        }
+        return true;
+    }
+
+    /**
+ * @brief Check if the file of the nodes is mapped.
+ *
+ * @return bool True if open() succeeded.
+ */
+    bool isOpen() const {
+        return file.isOpen();
+    }
+
+    /**
+ * @brief Get the header of the file.
+ *
+ * @return MappedNodesHeader & The header, in the mapping.
+ *
+ * @pre The file is mapped.
+ */
+    MappedNodesHeader &getHeader() const {
+        return *(MappedNodesHeader *) file.getBase();
+    }
+
+    /**
+ * @brief Get the node at an offset of the file.
+ *
+ * @param offset The offset of the node, DUMMY_NODE or a value returned by allocateNode().
+ * @return Node & The node, in the mapping.
+ *
+ * @pre The file is mapped and the offset isn't 0.
+ */
+    Node &getNode(unsigned long long offset) const {
+        return *(Node *) (file.getBase() + offset);
+    }
+
+    /**
+ * @brief Clear the clean flag before the links of the list change.
+ *
+ * @pre The file is mapped.
+ *
+ * @post The next open() empties the list unless sync() is called first.
+ */
+    void markChanged() {
+        getHeader().clean = 0;
+    }
+
+    /**
+ * @brief Take a node for a new record, a deleted one first, and copy the record into it.
+ *
+ * @param data The record.
+ * @return unsigned long long The offset of the node, 0 if the file couldn't grow.
+ *
+ * @pre The file is mapped.
+ *
+ * @post The node isn't linked yet, its next and prev fields are 0. The file may have been mapped again.
+ */
+    unsigned long long allocateNode(const Record &data) {
+        markChanged();
+
+        unsigned long long offset = getHeader().freeNodes;
+        if (offset != 0)
+            getHeader().freeNodes = getNode(offset).next;
+        else {
+            if (getHeader().used == getHeader().capacity) {
+                unsigned long long capacity = getHeader().capacity * 2;
+                if (!file.resize(sizeof(MappedNodesHeader) + capacity * sizeof(Node)))
+                    return 0;
+                getHeader().capacity = capacity; // the header moved with the mapping
+            }
+            offset = sizeof(MappedNodesHeader) + getHeader().used * sizeof(Node);
+            getHeader().used++;
+        }
+
+        Node &node = getNode(offset);
+        node.next = 0;
+        node.prev = 0;
+        memcpy(&node.data, &data, sizeof(Record));
+        return offset;
+    }
+
+    /**
+ * @brief Give back the node of a deleted record.
+ *
+ * @param offset The offset of the node, no longer linked.
+ *
+ * @pre The file is mapped.
+ *
+ * @post The node is the next one taken by allocateNode().
+ */
+    void releaseNode(unsigned long long offset) {
+        markChanged();
+        getNode(offset).next = getHeader().freeNodes;
+        getHeader().freeNodes = offset;
+    }
+
+    /**
+ * @brief Delete every node but the dummy node.
+ *
+ * @pre The file is mapped.
+ *
+ * @post The list is empty, the file keeps its length and its nodes are taken again from the start.
+ */
+    void clear() {
+        markChanged();
+        MappedNodesHeader &header = getHeader();
+        header.used = 1;
+        header.freeNodes = 0;
+        header.size = 0;
+        header.first = 0;
+        header.last = 0;
+        getNode(DUMMY_NODE).next = 0;
+        getNode(DUMMY_NODE).prev = 0;
+    }
+
+    /**
+ * @brief Write the nodes to the disk and mark them clean.
+ *
+ * @return bool True if the nodes are on the disk.
+ *
+ * @pre The file is mapped.
+ *
+ * @post The next open() keeps the list, even after a crash.
+ */
+    bool sync() {
+        // the nodes are on the disk before the flag saying they are complete
+        if (!file.sync())
+            return false;
+        getHeader().clean = 1;
+        return file.sync();
+    }
+
+private:
+    MappedFile file;
+
+};
+
+#endif //DSPROJ_MAPPEDNODES_H
@@ -0,0 +1,131 @@
+#include "PrerequisiteGraph.h"
+#include "Course.h"
+#include <iostream>
+
+using namespace std;
+
+// states of a course during the depth first search
+const int NOT_VISITED = 0;
+const int IN_PROGRESS = 1;
+const int CLOSED = 2;
+
+
+PrerequisiteGraph::PrerequisiteGraph() {
+}
+
+
+bool PrerequisiteGraph::build(const vector<string> &lines) {
+    indexes.clear();
+    direct.clear();
+    closure.clear();
+
+    // number every course and store its direct prerequisites
+    for (const string &line: lines) {
+        vector<string> codes = split(line);
+        if (codes.empty())
+            continue;
+
+        int course = addCourse(codes[0]);
+        for (size_t i = 1; i < codes.size(); i++) {
+            // numbered first since adding a course may move the vector of direct prerequisites
+            int prerequisite = addCourse(codes[i]);
+            direct[course].push_back(prerequisite);
+        }
+    }
+
+    // every closure has one bit per course of the graph
+    size_t words = (indexes.size() + 63) / 64;
+    closure.assign(indexes.size(), CourseSet(words, 0));
+
+    vector<int> state(indexes.size(), NOT_VISITED);
+    for (size_t course = 0; course < indexes.size(); course++) {
+        if (!close(course, state)) {
+            cerr << "The prerequisites contain a cycle, they will not be checked." << endl;
+            indexes.clear();
+            direct.clear();
+            closure.clear();
+            return false;
+        }
+    }
+
+    return true;
+}
+
+
+int PrerequisiteGraph::indexOf(const string &courseCode) const {
+    auto it = indexes.find(courseCode);
+    return it == indexes.end() ? -1 : it->second;
+}
+
+
+int PrerequisiteGraph::getNumberOfCourses() const {
+    return indexes.size();
+}
+
+
+CourseSet PrerequisiteGraph::toSet(const vector<string> &courseCodes) const {
+    CourseSet set((indexes.size() + 63) / 64, 0);
+
+    for (const string &code: courseCodes) {
+        int course = indexOf(code);
+        if (course != -1)
+            set[course / 64] |= 1ULL << (course % 64);
+    }
+    return set;
+}
+
+
+CourseSet PrerequisiteGraph::requiredFor(const string &courseCode) const {
+    int course = indexOf(courseCode);
+    return course == -1 ? CourseSet() : closure[course];
+}
+
+
+bool PrerequisiteGraph::isSatisfied(const string &courseCode, const CourseSet &completed) const {
+    int course = indexOf(courseCode);
+    if (course == -1)
+        return true; // the course has no prerequisites
+
+    // every required bit must be set in the completed courses
+    const CourseSet &required = closure[course];
+    for (size_t i = 0; i < required.size(); i++) {
+        unsigned long long done = i < completed.size() ? completed[i] : 0;
+        if (required[i] & ~done)
+            return false;
+    }
+    return true;
+}
+
+
+int PrerequisiteGraph::addCourse(const string &courseCode) {
+    auto it = indexes.find(courseCode);
+    if (it != indexes.end())
+        return it->second;
+
+    int course = indexes.size();
+    indexes[courseCode] = course;
+    direct.push_back(vector<int>());
+    return course;
+}
+
+
+bool PrerequisiteGraph::close(int course, vector<int> &state) {
+    if (state[course] == CLOSED)
+        return true;
+    if (state[course] == IN_PROGRESS)
+        return false; // we came back to a course whose closure is being computed
+
+    state[course] = IN_PROGRESS;
+    for (int prerequisite: direct[course]) {
+        if (!close(prerequisite, state))
+            return false;
+
+        // the prerequisite itself and everything required before it
+        closure[course][prerequisite / 64] |= 1ULL << (prerequisite % 64);
+        for (size_t i = 0; i < closure[course].size(); i++)
+            closure[course][i] |= closure[prerequisite][i];
+    }
+    state[course] = CLOSED;
+
+    return true;
+}
@@ -0,0 +1,140 @@
+/**
+
+    @file PrerequisiteGraph.h
+    @brief Declaration of the PrerequisiteGraph class and its member functions.
+
+    This file contains the declaration of the PrerequisiteGraph class, which stores the prerequisites of the
+    courses of the catalog as a directed acyclic graph (MATH210 -> MATH350 means MATH210 before MATH350).
+
+    date 18 Oct 2026
+
+    Every course code met in the prerequisites gets a bit number. When the graph is built, the transitive
+    closure of the prerequisites of every course is computed once and stored as a bitset (a vector of 64 bit
+    words), so checking if a student can take a course is an AND between two bitsets instead of a walk of the
+    prerequisite chain. The courses completed by a student are stored as a bitset with the same numbering.
+
+    Public Member Functions:
+        1. PrerequisiteGraph()
+        2. build(const vector<string> &): bool
+        3. indexOf(const string &) const: int
+        4. getNumberOfCourses() const: int
+        5. toSet(const vector<string> &) const: CourseSet
+        6. requiredFor(const string &) const: CourseSet
+        7. isSatisfied(const string &, const CourseSet &) const: bool
+*/
+
+#ifndef DSPROJ_PREREQUISITEGRAPH_H
+#define DSPROJ_PREREQUISITEGRAPH_H
+
+#include <string>
+#include <vector>
+#include <unordered_map>
+
+using namespace std;
+
+// a set of courses, bit i of word i / 64 is the course number i of the graph
+typedef vector<unsigned long long> CourseSet;
+
+class PrerequisiteGraph {
+public:
+
+    /**
+ * @brief Constructor for the PrerequisiteGraph class.
+ *
+ * @pre None.
+ *
+ * @post The graph is empty: no course has prerequisites.
+ */
+    PrerequisiteGraph();
+
+    /**
+ * @brief Build the graph from the lines of the prerequisites file.
+ *
+ * @param lines One line per course: the course code followed by the codes of its direct prerequisites,
+ * separated by spaces, eg: "MATH350 MATH210".
+ * @return bool True if the graph was built, false if the prerequisites contain a cycle.
+ *
+ * @pre The codes are uppercase.
+ *
+ * @post On success, every course of the lines has a number and the closure of its prerequisites is stored.
+ *       On failure an error message is printed to the standard error stream (cerr) and the graph is empty.
+ *
+ * @details The closure is computed with a depth first search that memorizes the closure of each course, so
+ * every edge is followed once: closure(c) = union over the direct prerequisites p of ({p} + closure(p)).
+ * A course met again while its own closure is being computed means there is a cycle.
+ */
+    bool build(const vector<string> &);
+
+    /**
+ * @brief Get the number of a course in the graph.
+ *
+ * @param courseCode The code of the course.
+ * @return int The bit number of the course, or -1 if the course is not in the graph.
+ *
+ * @pre None.
+ *
+ * @post None.
+ */
+    int indexOf(const string &) const;
+
+    /**
+ * @brief Get the number of courses in the graph.
+ *
+ * @return int The number of courses met in the prerequisites.
+ */
+    int getNumberOfCourses() const;
+
+    /**
+ * @brief Convert a list of course codes to a bitset.
+ *
+ * @param courseCodes The codes of the courses, eg: the courses completed by a student.
+ * @return CourseSet The bitset of the courses, the codes that are not in the graph are ignored
+ *         since no course requires them.
+ *
+ * @pre None.
+ *
+ * @post None.
+ */
+    CourseSet toSet(const vector<string> &) const;
+
+    /**
+ * @brief Get all the courses required before a course.
+ *
+ * @param courseCode The code of the course.
+ * @return CourseSet The transitive closure of the prerequisites of the course, empty if it has none.
+ *
+ * @pre None.
+ *
+ * @post None.
+ */
+    CourseSet requiredFor(const string &) const;
+
+    /**
+ * @brief Check if a set of completed courses satisfies the prerequisites of a course.
+ *
+ * @param courseCode The code of the course.
+ * @param completed The bitset of the completed courses.
+ * @return bool True if every course of the closure of the prerequisites is completed.
+ *
+ * @pre None.
+ *
+ * @post None.
+ *
+ * @details The closure is precomputed, so this is one hash lookup and an AND per 64 courses.
+ */
+    bool isSatisfied(const string &, const CourseSet &) const;
+
+private:
+    // Number the course if it is not numbered yet and return its number
+    int addCourse(const string &);
+
+    // Compute the closure of a course, false if a cycle is found
+    bool close(int, vector<int> &);
+
+    unordered_map<string, int> indexes; // course code -> bit number
+    vector<vector<int>> direct;         // bit number -> bit numbers of the direct prerequisites
+    vector<CourseSet> closure;          // bit number -> every course required before it
+
+};
+
+#endif //DSPROJ_PREREQUISITEGRAPH_H
@@ -0,0 +1,265 @@
+#include "QueryIndex.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+
+using namespace std;
+
+
+// GPA of a student in hundredths, a GPA just under a bound stays under it, eg: 1.996 is 199 like its status
+static int gpaHundredths(double gpa) {
+    return max(0, (int) floor(gpa * 100 + 1e-6));
+}
+
+
+// Read a bound of a range, scaled, eg: 2.5 is 250 with a scale of 100; false if it isn't a number
+static bool parseBound(const string &text, double scale, int &bound) {
+    char *end = nullptr;
+    double value = strtod(text.c_str(), &end);
+    if (text.empty() || *end != '\0' || value < 0 || value * scale >= QUERY_NO_LIMIT)
+        return false;
+    bound = (int) llround(value * scale);
+    return true;
+}
+
+
+// Read a range <min>-<max>, <min>-, -<max> or a single value, narrowing the bounds already set
+static bool parseRange(const string &text, double scale, int &minimum, int &maximum) {
+    size_t dash = text.find('-');
+    string low = dash == string::npos ? text : text.substr(0, dash);
+    string high = dash == string::npos ? text : text.substr(dash + 1);
+    int bound;
+    if (!low.empty()) {
+        if (!parseBound(low, scale, bound))
+            return false;
+        minimum = max(minimum, bound);
+    }
+    if (!high.empty()) {
+        if (!parseBound(high, scale, bound))
+            return false;
+        maximum = min(maximum, bound);
+    }
+    return !low.empty() || !high.empty();
+}
+
+
+void QueryIndex::BucketIndex::insert(unsigned int row, int value) {
+    if (value >= (int) buckets.size())
+        buckets.resize(value + 1);
+    if (row >= positions.size())
+        positions.resize(row + 1);
+    positions[row] = buckets[value].size();
+    buckets[value].push_back(row);
+}
+
+
+void QueryIndex::BucketIndex::move(unsigned int row, int from, int to) {
+    // the last row of the bucket takes the place of the one leaving
+    vector<unsigned int> &bucket = buckets[from];
+    unsigned int last = bucket.back();
+    bucket[positions[row]] = last;
+    positions[last] = positions[row];
+    bucket.pop_back();
+    insert(row, to);
+}
+
+
+size_t QueryIndex::BucketIndex::count(int minimum, int maximum) const {
+    size_t rows = 0;
+    for (int value = max(minimum, 0); value <= maximum && value < (int) buckets.size(); value++)
+        rows += buckets[value].size();
+    return rows;
+}
+
+
+void QueryIndex::BucketIndex::collect(int minimum, int maximum, vector<unsigned int> &rows) const {
+    for (int value = max(minimum, 0); value <= maximum && value < (int) buckets.size(); value++)
+        rows.insert(rows.end(), buckets[value].begin(), buckets[value].end());
+}
+
+
+QueryIndex::QueryIndex() {
+}
+
+
+void QueryIndex::setStudent(const string &studentId, double gpa, int numberOfCredits, bool isRegistered) {
+    int hundredths = gpaHundredths(gpa);
+    numberOfCredits = max(numberOfCredits, 0);
+
+    auto itr = studentRows.find(studentId);
+    if (itr == studentRows.end()) {
+        unsigned int row = studentIds.size();
+        studentRows[studentId] = row;
+        studentIds.push_back(studentId);
+        gpas.push_back(hundredths);
+        credits.push_back(numberOfCredits);
+        registered.push_back(isRegistered);
+        studentsByGpa.insert(row, hundredths);
+        studentsByCredits.insert(row, numberOfCredits);
+        return;
+    }
+
+    unsigned int row = itr->second;
+    if (gpas[row] != hundredths) {
+        studentsByGpa.move(row, gpas[row], hundredths);
+        gpas[row] = hundredths;
+    }
+    if (credits[row] != numberOfCredits) {
+        studentsByCredits.move(row, credits[row], numberOfCredits);
+        credits[row] = numberOfCredits;
+    }
+    registered[row] = isRegistered;
+}
+
+
+void QueryIndex::setCourse(const string &courseCode, int numberOfCredits, int seatsLeft) {
+    auto itr = coursesByCode.find(courseCode);
+    if (itr == coursesByCode.end()) {
+        coursesByCode[courseCode] = courseCodes.size();
+        courseCodes.push_back(courseCode);
+        courseCredits.push_back(numberOfCredits);
+        seats.push_back(max(seatsLeft, 0));
+        return;
+    }
+    courseCredits[itr->second] = numberOfCredits;
+    seats[itr->second] = max(seatsLeft, 0);
+}
+
+
+QueryResult QueryIndex::findStudents(const StudentFilter &filter) const {
+    QueryResult result;
+    size_t rows = studentIds.size();
+
+    // the index giving the fewest rows, read only when it leaves out most of them
+    size_t byGpa = filter.minimumGpa > 0 || filter.maximumGpa != QUERY_NO_LIMIT
+                   ? studentsByGpa.count(filter.minimumGpa, filter.maximumGpa) : rows;
+    size_t byCredits = filter.minimumCredits > 0 || filter.maximumCredits != QUERY_NO_LIMIT
+                       ? studentsByCredits.count(filter.minimumCredits, filter.maximumCredits) : rows;
+
+    if (min(byGpa, byCredits) <= rows * QUERY_INDEX_SELECTIVITY) {
+        vector<unsigned int> candidates;
+        if (byGpa <= byCredits) {
+            studentsByGpa.collect(filter.minimumGpa, filter.maximumGpa, candidates);
+            result.plan = "gpa index";
+        } else {
+            studentsByCredits.collect(filter.minimumCredits, filter.maximumCredits, candidates);
+            result.plan = "credits index";
+        }
+        for (unsigned int row: candidates)
+            if (matches(row, filter))
+                result.keys.push_back(studentIds[row]);
+        result.examined = candidates.size();
+    } else {
+        for (unsigned int row = 0; row < rows; row++)
+            if (matches(row, filter))
+                result.keys.push_back(studentIds[row]);
+        result.plan = "column scan";
+        result.examined = rows;
+    }
+
+    sort(result.keys.begin(), result.keys.end());
+    return result;
+}
+
+
+QueryResult QueryIndex::findCourses(const CourseFilter &filter) const {
+    QueryResult result;
+    auto matches = [this, &filter](unsigned int row) {
+        return courseCredits[row] >= filter.minimumCredits && courseCredits[row] <= filter.maximumCredits &&
+               seats[row] >= filter.minimumSeats && seats[row] <= filter.maximumSeats;
+    };
+
+    // the codes starting with the prefix follow each other in the sorted index, and come out sorted
+    if (!filter.prefix.empty()) {
+        for (auto itr = coursesByCode.lower_bound(filter.prefix);
+             itr != coursesByCode.end() && itr->first.compare(0, filter.prefix.length(), filter.prefix) == 0; ++itr) {
+            result.examined++;
+            if (matches(itr->second))
+                result.keys.push_back(itr->first);
+        }
+        result.plan = "prefix index";
+        return result;
+    }
+
+    for (unsigned int row = 0; row < courseCodes.size(); row++)
+        if (matches(row))
+            result.keys.push_back(courseCodes[row]);
+    result.plan = "column scan";
+    result.examined = courseCodes.size();
+    sort(result.keys.begin(), result.keys.end());
+    return result;
+}
+
+
+void QueryIndex::clear() {
+    studentIds.clear();
+    gpas.clear();
+    credits.clear();
+    registered.clear();
+    studentRows.clear();
+    studentsByGpa = BucketIndex();
+    studentsByCredits = BucketIndex();
+    courseCodes.clear();
+    courseCredits.clear();
+    seats.clear();
+    coursesByCode.clear();
+}
+
+
+bool QueryIndex::matches(unsigned int row, const StudentFilter &filter) const {
+    if (gpas[row] < filter.minimumGpa || gpas[row] > filter.maximumGpa ||
+        credits[row] < filter.minimumCredits || credits[row] > filter.maximumCredits)
+        return false;
+    return filter.registration == QUERY_ANY_REGISTRATION ||
+           (registered[row] != 0) == (filter.registration == QUERY_REGISTERED);
+}
+
+
+bool parseStudentFilter(const vector<string> &words, size_t first, StudentFilter &filter) {
+    filter = StudentFilter();
+    for (size_t i = first; i < words.size(); i++) {
+        size_t equal = words[i].find('=');
+        if (equal == string::npos)
+            return false;
+        string name = words[i].substr(0, equal), value = words[i].substr(equal + 1);
+
+        if (name == "STATUS" && value == "PROBATION")
+            filter.maximumGpa = min(filter.maximumGpa, PROBATION_GPA - 1);
+        else if (name == "STATUS" && value == "REGULAR")
+            filter.minimumGpa = max(filter.minimumGpa, PROBATION_GPA);
+        else if (name == "GPA") {
+            if (!parseRange(value, 100, filter.minimumGpa, filter.maximumGpa))
+                return false;
+        } else if (name == "CREDITS") {
+            if (!parseRange(value, 1, filter.minimumCredits, filter.maximumCredits))
+                return false;
+        } else if (name == "REGISTERED" && (value == "YES" || value == "NO"))
+            filter.registration = value == "YES" ? QUERY_REGISTERED : QUERY_NOT_REGISTERED;
+        else
+            return false;
+    }
+    return true;
+}
+
+
+bool parseCourseFilter(const vector<string> &words, size_t first, CourseFilter &filter) {
+    filter = CourseFilter();
+    for (size_t i = first; i < words.size(); i++) {
+        size_t equal = words[i].find('=');
+        if (equal == string::npos)
+            return false;
+        string name = words[i].substr(0, equal), value = words[i].substr(equal + 1);
+
+        if (name == "PREFIX" && !value.empty())
+            filter.prefix = value;
+        else if (name == "CREDITS") {
+            if (!parseRange(value, 1, filter.minimumCredits, filter.maximumCredits))
+                return false;
+        } else if (name == "SEATS") {
+            if (!parseRange(value, 1, filter.minimumSeats, filter.maximumSeats))
+                return false;
+        } else
+            return false;
+    }
+    return true;
+}
@@ -0,0 +1,211 @@
+/**
+
+    @file QueryIndex.h
+    @brief Declaration of the QueryIndex class, which answers filter queries over the students and the courses.
+
+    This file contains the filters of the queries, the QueryIndex class which keeps the fields they read as columns
+    with an index on some of them, and the functions reading a filter from the words of a command.
+
+    date 18 Oct 2026
+
+    Finding the students on probation with under 9 credits, or the courses of CSIS with open seats, used to mean
+    walking the whole linked lists (options 1 and 2) and filtering by eye. The QueryIndex keeps one row per student
+    and per course, the fields of the filters stored column by column (a vector per field), so a scan reads a few
+    packed integers per row instead of following a node and its strings. Next to the columns:
+        - the students are bucketed by GPA (in hundredths) and by credits, each bucket a vector of rows;
+        - the courses are kept sorted by code, a prefix is a range of it.
+
+    A query counts the rows of every index its filter can use (the sizes of the buckets in the range) and reads
+    the smallest candidate set when it is at most QUERY_INDEX_SELECTIVITY of the rows; otherwise it scans the
+    columns, which costs less than jumping from row to row. The plan chosen and the rows read are returned with the
+    keys. The Registry keeps the index up to date: every enrollment and drop moves the student between credit
+    buckets and changes the seats of the course in constant time.
+
+    Public Member Functions:
+        1. QueryIndex()
+        2. setStudent(const string &, double, int, bool): void
+        3. setCourse(const string &, int, int): void
+        4. findStudents(const StudentFilter &) const: QueryResult
+        5. findCourses(const CourseFilter &) const: QueryResult
+        6. clear(): void
+
+    Free Functions:
+        1. parseStudentFilter(const vector<string> &, size_t, StudentFilter &): bool
+        2. parseCourseFilter(const vector<string> &, size_t, CourseFilter &): bool
+*/
+
+#ifndef DSPROJ_QUERYINDEX_H
+#define DSPROJ_QUERYINDEX_H
+
+#include <string>
+#include <vector>
+#include <map>
+#include <unordered_map>
+#include <climits>
+
+using namespace std;
+
+// bound of a range without a maximum
+const int QUERY_NO_LIMIT = INT_MAX;
+
+// an index is read instead of the columns when it gives at most this fraction of the rows
+const double QUERY_INDEX_SELECTIVITY = 0.25;
+
+// GPA under which a student is on probation, in hundredths (see Student::getAcademicStatus)
+const int PROBATION_GPA = 200;
+
+// which students a query keeps
+enum QueryRegistration {
+    QUERY_ANY_REGISTRATION,
+    QUERY_REGISTERED,        // at least one course
+    QUERY_NOT_REGISTERED
+};
+
+// the fields a student query filters on, the bounds are included
+struct StudentFilter {
+    int minimumGpa = 0;                     // hundredths of a point, eg: 250 for 2.50
+    int maximumGpa = QUERY_NO_LIMIT;
+    int minimumCredits = 0;
+    int maximumCredits = QUERY_NO_LIMIT;
+    QueryRegistration registration = QUERY_ANY_REGISTRATION;
+};
+
+// the fields a course query filters on, the bounds are included
+struct CourseFilter {
+    string prefix;                          // start of the course code, eg: CSIS, empty for every course
+    int minimumCredits = 0;
+    int maximumCredits = QUERY_NO_LIMIT;
+    int minimumSeats = 0;                   // seats left, eg: 1 for the courses which aren't full
+    int maximumSeats = QUERY_NO_LIMIT;
+};
+
+// the answer of a query
+struct QueryResult {
+    vector<string> keys;     // student IDs or course codes, sorted
+    string plan;             // the path read: "gpa index", "credits index", "prefix index" or "column scan"
+    size_t examined = 0;     // rows read
+};
+
+class QueryIndex {
+public:
+
+    /**
+ * @brief Constructor for the QueryIndex class.
+ *
+ * @pre None.
+ *
+ * @post The index holds no student and no course.
+ */
+    QueryIndex();
+
+    /**
+ * @brief Add a student to the index, or update the fields of a student already in it.
+ *
+ * @param studentId The ID of the student.
+ * @param gpa The GPA of the student, eg: 2.5.
+ * @param numberOfCredits The credits the student is registered for.
+ * @param registered True if the student has at least one course.
+ *
+ * @post The student moves to the buckets of its new GPA and credits, in constant time.
+ */
+    void setStudent(const string &, double, int, bool);
+
+    /**
+ * @brief Add a course to the index, or update the fields of a course already in it.
+ *
+ * @param courseCode The code of the course.
+ * @param numberOfCredits The credits of the course.
+ * @param seats The seats left, 0 for a full or overfull course.
+ */
+    void setCourse(const string &, int, int);
+
+    /**
+ * @brief Find the students matching every field of a filter.
+ *
+ * @param filter The bounds of the GPA and the credits and the registration of the students.
+ * @return QueryResult The IDs of the students, sorted, with the plan chosen and the rows read.
+ *
+ * @pre None.
+ *
+ * @post None, the index is not modified.
+ */
+    QueryResult findStudents(const StudentFilter &) const;
+
+    /**
+ * @brief Find the courses matching every field of a filter.
+ *
+ * @param filter The prefix of the code and the bounds of the credits and the seats left.
+ * @return QueryResult The codes of the courses, sorted, with the plan chosen and the rows read.
+ *
+ * @pre None.
+ *
+ * @post None, the index is not modified.
+ */
+    QueryResult findCourses(const CourseFilter &) const;
+
+    /**
+ * @brief Remove every student and every course.
+ */
+    void clear();
+
+private:
+    // the rows of a column of small integers, a bucket per value, each row knowing its place in its bucket
+    struct BucketIndex {
+        vector<vector<unsigned int>> buckets;
+        vector<unsigned int> positions;     // position of every row in its bucket
+
+        // Put a new row in the bucket of a value
+        void insert(unsigned int, int);
+
+        // Move a row from the bucket of a value to the bucket of another one
+        void move(unsigned int, int, int);
+
+        // Number of rows with a value in a range
+        size_t count(int, int) const;
+
+        // Append the rows with a value in a range
+        void collect(int, int, vector<unsigned int> &) const;
+    };
+
+    // Check if the student of a row matches a filter
+    bool matches(unsigned int, const StudentFilter &) const;
+
+    // the students, one row each in the order they were added
+    vector<string> studentIds;
+    vector<int> gpas;                       // hundredths of a point
+    vector<int> credits;
+    vector<unsigned char> registered;
+    unordered_map<string, unsigned int> studentRows;
+    BucketIndex studentsByGpa;
+    BucketIndex studentsByCredits;
+
+    // the courses, one row each in the order they were added
+    vector<string> courseCodes;
+    vector<int> courseCredits;
+    vector<int> seats;
+    map<string, unsigned int> coursesByCode;   // sorted, a prefix is a range of it
+
+};
+
+/**
+ * @brief Read a student filter from the words of a command.
+ *
+ * @param words The command in upper case, eg: FIND STUDENTS STATUS=PROBATION CREDITS=-8.
+ * @param first The first word of the filter, eg: 2.
+ * @param filter Set to the filter; a range is written <min>-<max>, either bound may be left out.
+ * @return bool False if a word isn't one of STATUS=REGULAR|PROBATION, GPA=<range>, CREDITS=<range> and
+ *         REGISTERED=YES|NO.
+ */
+bool parseStudentFilter(const vector<string> &, size_t, StudentFilter &);
+
+/**
+ * @brief Read a course filter from the words of a command.
+ *
+ * @param words The command in upper case, eg: FIND COURSES PREFIX=CSIS SEATS=1-.
+ * @param first The first word of the filter, eg: 2.
+ * @param filter Set to the filter; a range is written <min>-<max>, either bound may be left out.
+ * @return bool False if a word isn't one of PREFIX=<start of the code>, CREDITS=<range> and SEATS=<range>.
+ */
+bool parseCourseFilter(const vector<string> &, size_t, CourseFilter &);
+
+#endif //DSPROJ_QUERYINDEX_H
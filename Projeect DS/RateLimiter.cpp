@@ -0,0 +1,28 @@
+#include "RateLimiter.h"
+#include <thread>
+
+using namespace std;
+
+
+RateLimiter::RateLimiter(long long bytesPerSecond) : bytesPerSecond(bytesPerSecond) {
+    bytes = 0;
+    start = chrono::steady_clock::now();
+}
+
+
+void RateLimiter::acquire(size_t blockBytes) {
+    bytes += blockBytes;
+    if (bytesPerSecond <= 0)
+        return;
+
+    // the block may start once the bytes before it would have taken this long at the allowed rate
+    auto allowed = start + chrono::duration_cast<chrono::steady_clock::duration>(
+            chrono::duration<double>((double) (bytes - blockBytes) / bytesPerSecond));
+    if (chrono::steady_clock::now() < allowed)
+        this_thread::sleep_until(allowed);
+}
+
+
+unsigned long long RateLimiter::getBytes() const {
+    return bytes;
+}
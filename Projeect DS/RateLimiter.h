@@ -0,0 +1,68 @@
+/**
+
+    @file RateLimiter.h
+    @brief Declaration of the RateLimiter class and its member functions.
+
+    This file contains the declaration of the RateLimiter class, which keeps a background job under a number of
+    bytes per second.
+
+    date 18 Oct 2026
+
+    The job calls acquire() with the size of every block before reading or writing it. When the job is ahead of
+    the allowed rate the call sleeps until the block fits, so the disk keeps most of its bandwidth for the
+    journal, whose fsync latency every registration waits for.
+
+    Public Member Functions:
+        1. RateLimiter(long long)
+        2. acquire(size_t): void
+        3. getBytes() const: unsigned long long
+*/
+
+#ifndef DSPROJ_RATELIMITER_H
+#define DSPROJ_RATELIMITER_H
+
+#include <chrono>
+#include <cstddef>
+
+using namespace std;
+
+class RateLimiter {
+public:
+
+    /**
+ * @brief Constructor for the RateLimiter class.
+ *
+ * @param bytesPerSecond The maximum average rate, 0 or less for no limit.
+ *
+ * @pre None.
+ *
+ * @post The rate is measured from now.
+ */
+    RateLimiter(long long);
+
+    /**
+ * @brief Account for a block of bytes and wait until it fits in the rate.
+ *
+ * @param bytes The size of the block about to be read or written.
+ *
+ * @pre None.
+ *
+ * @post The bytes accounted so far divided by the time since the construction is at most the rate.
+ */
+    void acquire(size_t);
+
+    /**
+ * @brief Get the number of bytes accounted so far.
+ *
+ * @return unsigned long long The sum of the blocks given to acquire().
+ */
+    unsigned long long getBytes() const;
+
+private:
+    long long bytesPerSecond;
+    unsigned long long bytes;
+    chrono::steady_clock::time_point start;
+
+};
+
+#endif //DSPROJ_RATELIMITER_H
@@ -0,0 +1,136 @@
+#include "RegistrationScheduler.h"
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <numeric>
+#include <queue>
+#include <thread>
+
+using namespace std;
+
+
+RegistrationScheduler::RegistrationScheduler(Registry &registry) : registry(registry) {
+    nextArrival = 0;
+    elapsedMilliseconds = 0;
+}
+
+
+void RegistrationScheduler::submit(const string &studentId, const vector<string> &courseCodes) {
+    RegistrationRequest request;
+    request.bundle.studentId = studentId;
+    request.bundle.courseCodes = courseCodes;
+    request.cohort = cohortOf(studentId);
+    request.arrival = nextArrival++;
+
+    // an unknown student keeps the lowest GPA, the registry reports it when the request is applied
+    Student *student = registry.findStudent(studentId);
+    request.gpa = student == nullptr ? 0 : student->getGpa();
+
+    pending.push_back(request);
+}
+
+
+int RegistrationScheduler::run(int batchSize) {
+    auto start = chrono::steady_clock::now();
+
+    applied.clear();
+    applied.reserve(pending.size());
+
+    // true if request a is served after request b: older cohort first, then higher GPA, then earlier arrival
+    auto servedAfter = [this](size_t a, size_t b) {
+        const RegistrationRequest &x = pending[a];
+        const RegistrationRequest &y = pending[b];
+        if (x.cohort != y.cohort)
+            return x.cohort > y.cohort;
+        if (x.gpa != y.gpa)
+            return x.gpa < y.gpa;
+        return x.arrival > y.arrival;
+    };
+
+    // the heap holds the indices of the pending requests, the next one to serve on top
+    vector<size_t> heap(pending.size());
+    iota(heap.begin(), heap.end(), 0);
+    make_heap(heap.begin(), heap.end(), servedAfter);
+
+    // batches ordered by the second thread, at most two waiting to be applied
+    queue<vector<size_t>> ready;
+    mutex readyMutex;
+    condition_variable readyChanged;
+    bool orderingDone = false;
+
+    thread orderer([&]() {
+        while (!heap.empty()) {
+            vector<size_t> batch;
+            batch.reserve(batchSize);
+            while (!heap.empty() && (int) batch.size() < batchSize) {
+                pop_heap(heap.begin(), heap.end(), servedAfter);
+                batch.push_back(heap.back());
+                heap.pop_back();
+            }
+
+            unique_lock<mutex> lock(readyMutex);
+            readyChanged.wait(lock, [&]() { return ready.size() < 2; });
+            ready.push(move(batch));
+            readyChanged.notify_all();
+        }
+
+        lock_guard<mutex> lock(readyMutex);
+        orderingDone = true;
+        readyChanged.notify_all();
+    });
+
+    // apply the batches in the order they were produced
+    int accepted = 0;
+    vector<BundleRequest *> bundles;
+    while (true) {
+        vector<size_t> batch;
+        {
+            unique_lock<mutex> lock(readyMutex);
+            readyChanged.wait(lock, [&]() { return !ready.empty() || orderingDone; });
+            if (ready.empty())
+                break;
+            batch = move(ready.front());
+            ready.pop();
+            readyChanged.notify_all();
+        }
+
+        bundles.clear();
+        for (size_t index: batch)
+            bundles.push_back(&pending[index].bundle);
+        accepted += registry.registerBundles(bundles);
+
+        // the orderer never looks at a request again once it is in a batch
+        for (size_t index: batch)
+            applied.push_back(move(pending[index]));
+    }
+
+    orderer.join();
+    pending.clear();
+
+    elapsedMilliseconds = chrono::duration<double, milli>(chrono::steady_clock::now() - start).count();
+    return accepted;
+}
+
+
+int RegistrationScheduler::getPendingCount() const {
+    return pending.size();
+}
+
+
+const vector<RegistrationRequest> &RegistrationScheduler::getRequests() const {
+    return applied;
+}
+
+
+double RegistrationScheduler::getElapsedMilliseconds() const {
+    return elapsedMilliseconds;
+}
+
+
+int cohortOf(const string &studentId) {
+    // the cohort is the year written right after the 'A': A2210191 -> 22
+    if (studentId.length() < 3 || !isdigit(studentId[1]) || !isdigit(studentId[2]))
+        return 99;
+    return (studentId[1] - '0') * 10 + (studentId[2] - '0');
+}
@@ -0,0 +1,138 @@
+/**
+
+    @file RegistrationScheduler.h
+    @brief Declaration of the RegistrationScheduler class and its member functions.
+
+    This file contains the declaration of the RegistrationScheduler class, which queues the registration
+    requests received when a registration window opens and applies them in priority order.
+
+    date 18 Oct 2026
+
+    The registrar opens registration cohort by cohort: the cohort is the year encoded in the student ID
+    (A21xxxxx, A22xxxxx, ...). Requests are applied from the oldest cohort to the newest, then from the
+    highest GPA to the lowest, then in arrival order. They are handed to the registry in batches, and the
+    next batch is being ordered on a second thread while the current one is applied.
+
+    Public Member Functions:
+        1. RegistrationScheduler(Registry &)
+        2. submit(const string &, const vector<string> &): void
+        3. run(int): int
+        4. getPendingCount() const: int
+        5. getRequests() const: const vector<RegistrationRequest> &
+        6. getElapsedMilliseconds() const: double
+
+    Free Functions:
+        1. cohortOf(const string &): int
+*/
+
+#ifndef DSPROJ_REGISTRATIONSCHEDULER_H
+#define DSPROJ_REGISTRATIONSCHEDULER_H
+
+#include "Registry.h"
+
+#include <string>
+#include <vector>
+
+using namespace std;
+
+// number of requests given to the registry at once when a registration window opens
+const int REGISTRATION_BATCH_SIZE = 512;
+
+/**
+ * @brief A queued registration request and the information used to order it.
+ */
+struct RegistrationRequest {
+    BundleRequest bundle;   // student, courses and, once applied, the result
+    int cohort;             // year of the student ID, lower is served first
+    double gpa;             // higher is served first inside a cohort
+    unsigned long arrival;  // order of submission, earlier is served first on ties
+};
+
+class RegistrationScheduler {
+public:
+
+    /**
+ * @brief Constructor for the RegistrationScheduler class.
+ *
+ * @param registry The registry the requests are applied to.
+ *
+ * @pre The registry outlives the scheduler.
+ *
+ * @post The scheduler has no pending request.
+ */
+    RegistrationScheduler(Registry &);
+
+    /**
+ * @brief Queue a registration request.
+ *
+ * @param studentId The id of the student (uppercase).
+ * @param courseCodes The codes of the courses the student asks for, registered all or nothing.
+ *
+ * @pre None.
+ *
+ * @post The request is pending with the next arrival number, its cohort and the GPA of the student.
+ *
+ * @details An unknown student is still queued with a GPA of 0 so the registry reports it in the result.
+ */
+    void submit(const string &, const vector<string> &);
+
+    /**
+ * @brief Apply every pending request in priority order.
+ *
+ * @param batchSize The number of requests given to the registry at once.
+ * @return int The number of requests that were registered.
+ *
+ * @pre batchSize is greater than 0.
+ *
+ * @post Every pending request was applied and has its result; getRequests() lists them in the order they
+ *       were applied.
+ *
+ * @details The pending requests are put in a binary heap (built in linear time). A second thread pops the
+ * heap into batches and hands them over through a queue of two batches while this thread applies the
+ * previous batch with Registry::registerBundles, so ordering and registration overlap.
+ */
+    int run(int);
+
+    /**
+ * @brief Get the number of requests waiting for run().
+ *
+ * @return int The number of pending requests.
+ */
+    int getPendingCount() const;
+
+    /**
+ * @brief Get the requests applied by the last run, in the order they were applied.
+ *
+ * @return const vector<RegistrationRequest> & The applied requests with their results.
+ */
+    const vector<RegistrationRequest> &getRequests() const;
+
+    /**
+ * @brief Get the duration of the last run.
+ *
+ * @return double The wall time of the last run in milliseconds.
+ */
+    double getElapsedMilliseconds() const;
+
+private:
+    Registry &registry;
+    vector<RegistrationRequest> pending;  // requests waiting for the next run
+    vector<RegistrationRequest> applied;  // requests of the last run, in applied order
+    unsigned long nextArrival;
+    double elapsedMilliseconds;
+
+};
+
+/**
+ * @brief Get the cohort encoded in a student ID.
+ *
+ * @param studentId A student ID such as A2210191.
+ * @return int The two digits following the 'A' (22 for A2210191), or 99 if they are not digits.
+ *
+ * @pre None.
+ *
+ * @post None.
+ */
+int cohortOf(const string &);
+
+#endif //DSPROJ_REGISTRATIONSCHEDULER_H
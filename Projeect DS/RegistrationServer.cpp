@@ -0,0 +1,503 @@
+#include "RegistrationServer.h"
+#include <cstring>
+#include <cstdio>
+#include <cerrno>
+#include <chrono>
+#include <cmath>
+#include <csignal>
+#include <unistd.h>
+#include <fcntl.h>
+#include <sys/epoll.h>
+#include <poll.h>
+#include <sys/signalfd.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <netinet/in.h>
+#include <arpa/inet.h>
+
+using namespace std;
+
+
+RegistrationServer::Connection::Connection(int fileDescriptor, TermDirectory &terms)
+        : fileDescriptor(fileDescriptor), processor(terms), binaryProcessor(terms) {
+    closed = false;
+    written = 0;
+    events = 0;
+    protocol = PROTOCOL_UNKNOWN;
+}
+
+
+RegistrationServer::RegistrationServer(TermDirectory &terms) : terms(terms), readBuffer(SERVER_READ_SIZE, '\0') {
+    listenDescriptor = -1;
+    deferredInRead = 0;
+    epollDescriptor = epoll_create1(0);
+    if (epollDescriptor == -1)
+        cerr << "The epoll instance of the server can't be created." << endl;
+}
+
+
+RegistrationServer::~RegistrationServer() {
+    for (auto itr = connections.begin(); itr != connections.end(); ++itr)
+        close(itr->first);
+    if (listenDescriptor != -1)
+        close(listenDescriptor);
+    if (epollDescriptor != -1)
+        close(epollDescriptor);
+    if (!socketPath.empty())
+        unlink(socketPath.c_str());
+}
+
+
+bool RegistrationServer::listenUnix(const string &path) {
+    sockaddr_un address;
+    memset(&address, 0, sizeof(address));
+    address.sun_family = AF_UNIX;
+    if (path.length() >= sizeof(address.sun_path)) {
+        cerr << "The socket path " << path << " is too long." << endl;
+        return false;
+    }
+    strcpy(address.sun_path, path.c_str());
+
+    // a socket file left by a previous run would make bind fail
+    unlink(path.c_str());
+    if (!startListening(AF_UNIX, &address, sizeof(address)))
+        return false;
+    socketPath = path;
+    return true;
+}
+
+
+bool RegistrationServer::listenTcp(int port) {
+    sockaddr_in address;
+    memset(&address, 0, sizeof(address));
+    address.sin_family = AF_INET;
+    address.sin_port = htons(port);
+    address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    return startListening(AF_INET, &address, sizeof(address));
+}
+
+
+bool RegistrationServer::startListening(int family, const void *address, size_t length) {
+    int descriptor = socket(family, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+    if (descriptor == -1) {
+        cerr << "The socket of the server can't be created." << endl;
+        return false;
+    }
+
+    int reuse = 1;
+    if (family == AF_INET)
+        setsockopt(descriptor, SOL_SOCKET, SO_REUSEADDR, &reuse, sizeof(reuse));
+
+    epoll_event event;
+    memset(&event, 0, sizeof(event));
+    event.events = EPOLLIN;
+    event.data.fd = descriptor;
+    if (bind(descriptor, (const sockaddr *) address, length) != 0 || listen(descriptor, SOMAXCONN) != 0 ||
+        epoll_ctl(epollDescriptor, EPOLL_CTL_ADD, descriptor, &event) != 0) {
+        cerr << "The server can't listen: " << strerror(errno) << endl;
+        close(descriptor);
+        return false;
+    }
+
+    listenDescriptor = descriptor;
+    return true;
+}
+
+
+void RegistrationServer::run(ostream &report) {
+    // SIGINT and SIGTERM are read from a descriptor of the loop instead of interrupting it
+    sigset_t signals;
+    sigemptyset(&signals);
+    sigaddset(&signals, SIGINT);
+    sigaddset(&signals, SIGTERM);
+    pthread_sigmask(SIG_BLOCK, &signals, nullptr);
+    int signalDescriptor = signalfd(-1, &signals, SFD_NONBLOCK | SFD_CLOEXEC);
+
+    epoll_event event;
+    memset(&event, 0, sizeof(event));
+    event.events = EPOLLIN;
+    event.data.fd = signalDescriptor;
+    epoll_ctl(epollDescriptor, EPOLL_CTL_ADD, signalDescriptor, &event);
+    event.data.fd = waiter.getEventDescriptor();
+    epoll_ctl(epollDescriptor, EPOLL_CTL_ADD, waiter.getEventDescriptor(), &event);
+
+    epoll_event events[SERVER_EVENTS];
+    auto nextReport = chrono::steady_clock::now() + chrono::seconds(1);
+    unsigned long long reportedRequests = stats.requests;
+    unsigned long long reportedShed = 0;
+    bool stopping = false;
+
+    while (!stopping) {
+        int timeout = chrono::duration_cast<chrono::milliseconds>(nextReport - chrono::steady_clock::now()).count();
+        if (!replicas.empty())
+            timeout = min(timeout, REPLICA_PUBLISH_INTERVAL_MS);
+        int ready = epoll_wait(epollDescriptor, events, SERVER_EVENTS, max(timeout, 0));
+        if (ready < 0 && errno != EINTR) {
+            cerr << "The server stopped waiting for its connections: " << strerror(errno) << endl;
+            break;
+        }
+
+        for (int i = 0; i < ready; i++) {
+            int descriptor = events[i].data.fd;
+            if (descriptor == signalDescriptor) {
+                stopping = true;
+                continue;
+            }
+            if (descriptor == listenDescriptor) {
+                acceptConnections();
+                continue;
+            }
+            if (descriptor == waiter.getEventDescriptor()) {
+                waiter.resumeCompleted();
+                continue;
+            }
+
+            auto itr = connections.find(descriptor);
+            if (itr == connections.end())
+                continue;
+            Connection &connection = *itr->second;
+
+            bool keep = (events[i].events & EPOLLIN) != 0 || (events[i].events & (EPOLLERR | EPOLLHUP)) == 0;
+            if (keep && (events[i].events & EPOLLIN) != 0)
+                keep = readConnection(connection);
+            settleConnection(connection, keep);
+        }
+
+        // the answers released by the coroutines resumed above are written
+        vector<int> descriptors;
+        descriptors.swap(released);
+        for (int descriptor: descriptors) {
+            auto itr = connections.find(descriptor);
+            if (itr != connections.end())
+                settleConnection(*itr->second, true);
+        }
+
+        auto now = chrono::steady_clock::now();
+        publishReplicas(now);
+        admission.update(now);
+        if (now >= nextReport) {
+            if (stats.requests != reportedRequests)
+                report << stats.requests - reportedRequests << " requests/s, p50 "
+                       << llround(recentLatencies.percentile(50)) << " us, p99 "
+                       << llround(recentLatencies.percentile(99)) << " us, p99.9 "
+                       << llround(recentLatencies.percentile(99.9)) << " us, " << waiter.getWaiting()
+                       << " waiting for the journal (limit " << admission.getStats().limit << "), "
+                       << admission.getStats().shed - reportedShed << " shed, " << stats.open << " connections"
+                       << endl;
+            reportedRequests = stats.requests;
+            reportedShed = admission.getStats().shed;
+            recentLatencies.clear();
+            nextReport = now + chrono::seconds(1);
+        }
+    }
+
+    // the registrations in flight are made durable before the server stops, and their answers are written
+    waiter.drain();
+    nextPublish = chrono::steady_clock::now();
+    publishReplicas(nextPublish);
+    auto deadline = nextPublish + chrono::milliseconds(SERVER_FLUSH_TIMEOUT_MS);
+    while (!connections.empty()) {
+        flushConnection(*connections.begin()->second, deadline);
+        closeConnection(connections.begin()->first);
+    }
+    close(signalDescriptor);
+}
+
+
+bool RegistrationServer::openReplicas() {
+    bool opened = true;
+    terms.forEach([this, &opened](Term &term) {
+        unique_ptr<ReplicaPublisher> publisher(new ReplicaPublisher());
+        if (!publisher->open(replicaPath(term.fileSuffix)) || !publisher->publish(term)) {
+            opened = false;
+            return;
+        }
+        replicas[term.name] = move(publisher);
+    });
+    nextPublish = chrono::steady_clock::now() + chrono::milliseconds(REPLICA_PUBLISH_INTERVAL_MS);
+    return opened;
+}
+
+
+const ServerStats &RegistrationServer::getStats() const {
+    return stats;
+}
+
+
+const LatencyHistogram &RegistrationServer::getLatencies() const {
+    return latencies;
+}
+
+
+const AdmissionStats &RegistrationServer::getAdmission() const {
+    return admission.getStats();
+}
+
+
+void RegistrationServer::acceptConnections() {
+    while (true) {
+        int descriptor = accept4(listenDescriptor, nullptr, nullptr, SOCK_NONBLOCK | SOCK_CLOEXEC);
+        if (descriptor == -1) {
+            if (errno != EAGAIN && errno != EWOULDBLOCK && errno != EINTR && errno != ECONNABORTED)
+                cerr << "A connection can't be accepted: " << strerror(errno) << endl;
+            return;
+        }
+
+        shared_ptr<Connection> connection(new Connection(descriptor, terms));
+        connection->events = EPOLLIN;
+        Connection *target = connection.get();
+        DurabilityHook hook = [this, target](Registry &registry, unsigned long long sequence, string &output,
+                                             size_t answerStart) {
+            deferAnswer(*target, registry, sequence, output, answerStart);
+        };
+        connection->processor.setDurabilityHook(hook);
+        connection->binaryProcessor.setDurabilityHook(hook);
+        // the registrations waiting for the journal are the queue bounded by the admission control
+        AdmissionHook admit = [this](unsigned int &retryAfter) {
+            return admission.admit(waiter.getWaiting(), retryAfter);
+        };
+        connection->processor.setAdmissionHook(admit);
+        connection->binaryProcessor.setAdmissionHook(admit);
+        epoll_event event;
+        memset(&event, 0, sizeof(event));
+        event.events = EPOLLIN;
+        event.data.fd = descriptor;
+        if (epoll_ctl(epollDescriptor, EPOLL_CTL_ADD, descriptor, &event) != 0) {
+            close(descriptor);
+            continue;
+        }
+
+        connections[descriptor] = move(connection);
+        stats.accepted++;
+        stats.open++;
+    }
+}
+
+
+bool RegistrationServer::readConnection(Connection &connection) {
+    ssize_t length = recv(connection.fileDescriptor, &readBuffer[0], readBuffer.size(), 0);
+    if (length == 0)
+        return false; // the client closed the connection
+    if (length < 0)
+        return errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR;
+    stats.bytesRead += length;
+
+    string &input = connection.input;
+    input.append(readBuffer, 0, length);
+
+    if (connection.protocol == PROTOCOL_UNKNOWN) {
+        if ((unsigned char) input[0] == BINARY_PROTOCOL_HELLO) {
+            connection.protocol = PROTOCOL_BINARY;
+            input.erase(0, 1);
+        } else {
+            connection.protocol = PROTOCOL_TEXT;
+        }
+    }
+
+    // the answers go through a buffer of this read: the hook takes the ones waiting for the journal out of it
+    readAt = chrono::steady_clock::now();
+    deferredInRead = 0;
+    unsigned long long requests = stats.requests;
+    answerBuffer.clear();
+    bool keep = connection.protocol == PROTOCOL_BINARY ? answerBinary(connection, answerBuffer)
+                                                       : answerText(connection, answerBuffer);
+    if (connection.pending.empty() && connection.output.empty())
+        connection.output.swap(answerBuffer);
+    else
+        appendAnswers(connection, answerBuffer.data(), answerBuffer.length());
+    recordLatency(readAt, stats.requests - requests - deferredInRead);
+    return keep;
+}
+
+
+bool RegistrationServer::answerText(Connection &connection, string &answers) {
+    string &input = connection.input;
+    vector<string> lines;
+    size_t start = 0, end;
+    while ((end = input.find('\n', start)) != string::npos) {
+        lines.emplace_back(input, start, end - start);
+        start = end + 1;
+        if (!lines.back().empty() && lines.back().back() == '\r')
+            lines.back().pop_back();
+    }
+    input.erase(0, start);
+
+    // every complete line is run at once, so a pipelined run of lookups is answered on the pool
+    stats.requests += connection.processor.executeAll(lines, answers);
+
+    // the lines after a QUIT are dropped, the connection is closing
+    if (connection.processor.isFinished())
+        input.clear();
+    return input.length() <= SERVER_LINE_LIMIT;
+}
+
+
+bool RegistrationServer::answerBinary(Connection &connection, string &answers) {
+    BinaryProcessor &processor = connection.binaryProcessor;
+    unsigned long long requests = processor.getRequests();
+
+    size_t consumed = processor.consume(connection.input.data(), connection.input.length(), answers);
+    connection.input.erase(0, consumed);
+    stats.requests += processor.getRequests() - requests;
+    return !processor.isBroken();
+}
+
+
+bool RegistrationServer::writeConnection(Connection &connection) {
+    string &output = connection.output;
+    while (connection.written < output.length()) {
+        ssize_t length = send(connection.fileDescriptor, output.data() + connection.written,
+                              output.length() - connection.written, MSG_NOSIGNAL);
+        if (length < 0) {
+            if (errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR)
+                break;
+            return false;
+        }
+        connection.written += length;
+        stats.bytesWritten += length;
+    }
+
+    // the written answers are dropped from the buffer once they are the larger part of it
+    if (connection.written == output.length()) {
+        output.clear();
+        connection.written = 0;
+    } else if (connection.written > output.length() / 2) {
+        output.erase(0, connection.written);
+        connection.written = 0;
+    }
+    return true;
+}
+
+
+void RegistrationServer::flushConnection(Connection &connection, chrono::steady_clock::time_point deadline) {
+    while (writeConnection(connection) && connection.written < connection.output.length()) {
+        int timeout = chrono::duration_cast<chrono::milliseconds>(deadline - chrono::steady_clock::now()).count();
+        pollfd writable = {connection.fileDescriptor, POLLOUT, 0};
+        if (timeout <= 0 || poll(&writable, 1, timeout) <= 0)
+            return;
+    }
+}
+
+
+void RegistrationServer::updateEvents(Connection &connection) {
+    size_t pending = connection.output.length() - connection.written;
+    unsigned int events = 0;
+    if (pending <= SERVER_OUTPUT_LIMIT)
+        events |= EPOLLIN;
+    if (pending > 0)
+        events |= EPOLLOUT;
+    if (events == connection.events)
+        return;
+
+    epoll_event event;
+    memset(&event, 0, sizeof(event));
+    event.events = events;
+    event.data.fd = connection.fileDescriptor;
+    epoll_ctl(epollDescriptor, EPOLL_CTL_MOD, connection.fileDescriptor, &event);
+    connection.events = events;
+}
+
+
+void RegistrationServer::appendAnswers(Connection &connection, const char *answers, size_t length) {
+    if (connection.pending.empty())
+        connection.output.append(answers, length);
+    else
+        connection.pending.back()->after.append(answers, length);
+}
+
+
+void RegistrationServer::deferAnswer(Connection &connection, Registry &registry, unsigned long long sequence,
+                                     string &output, size_t answerStart) {
+    // the answers before this one are complete, the later ones of the read will wait behind it
+    appendAnswers(connection, output.data(), answerStart);
+    unique_ptr<PendingAnswer> pending(new PendingAnswer());
+    pending->answer.assign(output, answerStart, string::npos);
+    pending->readAt = readAt;
+    output.clear();
+
+    PendingAnswer *answer = pending.get();
+    connection.pending.push_back(move(pending));
+    deferredInRead++;
+    sendWhenDurable(connections[connection.fileDescriptor], answer, registry, sequence);
+}
+
+
+RequestTask RegistrationServer::sendWhenDurable(shared_ptr<Connection> connection, PendingAnswer *answer,
+                                                Registry &registry, unsigned long long sequence) {
+    bool isDurable = co_await waiter.durable(registry, sequence);
+
+    // resumed on the loop, or never suspended when the records were already durable; the change was made but the
+    // journal failed to write it, so it may be lost on a restart and can't be answered OK
+    if (!isDurable) {
+        answer->answer.clear();
+        if (connection->protocol == PROTOCOL_BINARY)
+            appendStatusFrame(answer->answer, JOURNAL_FAILED);
+        else
+            answer->answer = "ERR " + resultName(JOURNAL_FAILED) + "\n";
+    }
+    answer->ready = true;
+    stats.deferred++;
+    recordLatency(answer->readAt, 1);
+    admission.completed();
+    if (connection->closed)
+        co_return;
+    releaseAnswers(*connection);
+    released.push_back(connection->fileDescriptor);
+}
+
+
+void RegistrationServer::releaseAnswers(Connection &connection) {
+    while (!connection.pending.empty() && connection.pending.front()->ready) {
+        PendingAnswer &answer = *connection.pending.front();
+        connection.output += answer.answer;
+        connection.output += answer.after;
+        connection.pending.pop_front();
+    }
+}
+
+
+void RegistrationServer::settleConnection(Connection &connection, bool keep) {
+    if (keep)
+        keep = writeConnection(connection);
+    // after QUIT the connection is closed once its answers are written
+    if (keep && connection.protocol == PROTOCOL_TEXT && connection.processor.isFinished() &&
+        connection.pending.empty() && connection.written == connection.output.size())
+        keep = false;
+
+    if (keep)
+        updateEvents(connection);
+    else
+        closeConnection(connection.fileDescriptor);
+}
+
+
+void RegistrationServer::recordLatency(chrono::steady_clock::time_point since, unsigned long long requests) {
+    if (requests == 0)
+        return;
+    double microseconds = chrono::duration<double, micro>(chrono::steady_clock::now() - since).count();
+    latencies.record(microseconds, requests);
+    recentLatencies.record(microseconds, requests);
+}
+
+
+void RegistrationServer::publishReplicas(chrono::steady_clock::time_point now) {
+    if (replicas.empty() || now < nextPublish)
+        return;
+
+    // a registration waiting for its journal is already applied, the lookups of the server see it as well
+    terms.forEach([this](Term &term) {
+        auto itr = replicas.find(term.name);
+        if (itr != replicas.end())
+            itr->second->publishIfChanged(term);
+    });
+    nextPublish = now + chrono::milliseconds(REPLICA_PUBLISH_INTERVAL_MS);
+}
+
+
+void RegistrationServer::closeConnection(int descriptor) {
+    // closing the descriptor also removes it from the epoll instance, a coroutine may still hold the connection
+    close(descriptor);
+    connections[descriptor]->closed = true;
+    connections.erase(descriptor);
+    stats.open--;
+}
@@ -0,0 +1,293 @@
+/**
+
+    @file RegistrationServer.h
+    @brief Declaration of the RegistrationServer class and its member functions.
+
+    This file contains the declaration of the RegistrationServer class, which lets many front-end processes share
+    the open terms through a Unix domain socket or a localhost TCP port.
+
+    date 18 Oct 2026
+
+    The server runs a single thread around one epoll instance: the listening socket, every connection and a
+    signalfd for SIGINT and SIGTERM are registered in it, and the loop only works on the descriptors that are
+    ready. No lock is needed since the registry is only called from this thread. The requests are the commands
+    of CommandProcessor, one per line, and each connection has its own processor, so TERM only changes the term
+    of its own connection and QUIT closes it.
+
+    Every socket is non blocking. The answers of a connection are kept in its output buffer, written as soon as
+    they are ready and again on EPOLLOUT when the socket was full; a connection whose output buffer holds more
+    than SERVER_OUTPUT_LIMIT bytes isn't read until its client reads the answers.
+
+    A client may also speak the binary protocol of BinaryProtocol.h, by sending BINARY_PROTOCOL_HELLO first: its
+    requests are then length prefixed frames answered by a BinaryProcessor. Both protocols answer every request
+    complete in what was read, in order, and send the answers together, so a client pipelining many requests per
+    write gets them back in a few large writes.
+
+    The loop never waits for the journal: a registration is applied at once and its answer is held by a coroutine
+    (RequestTask) suspended on JournalWaiter::durable until its journal records are synced by the thread of the
+    waiter; the loop resumes it when the eventfd of the waiter is readable. The answers of the later requests of
+    the same connection are held behind it, so every connection still gets its answers in order, while the
+    registrations of all the connections in flight are made durable by the same group commits. When the journal
+    fails to write them, the held answer is replaced by ERR JOURNAL_FAILED. The lookups never touch the disk. A run
+    of lookups read at once from a connection is answered on the WorkStealingPool of the directory while the loop
+    waits for it, so the registry still only changes on this thread.
+
+    Before a registration is applied, the AdmissionControl of the server checks how many registrations wait for
+    the journal: past its limit, adapted so that the ones let in wait about ADMISSION_TARGET_MICROSECONDS, the
+    registration is refused with a retry-after, so a burst of registrations is shed at the door instead of making
+    every answer wait behind it.
+
+    With openReplicas, the loop also copies every term changed by its registrations into the shared memory segment
+    of the term (SharedReplica.h), at most every REPLICA_PUBLISH_INTERVAL_MS, so local processes answer most
+    lookups themselves and never reach the socket.
+
+    Public Member Functions:
+        1. RegistrationServer(TermDirectory &)
+        2. ~RegistrationServer()
+        3. listenUnix(const string &): bool
+        4. listenTcp(int): bool
+        5. run(ostream &): void
+        6. getStats() const: const ServerStats &
+        7. getLatencies() const: const LatencyHistogram &
+        8. openReplicas(): bool
+        9. getAdmission() const: const AdmissionStats &
+*/
+
+#ifndef DSPROJ_REGISTRATIONSERVER_H
+#define DSPROJ_REGISTRATIONSERVER_H
+
+#include "TermDirectory.h"
+#include "CommandProcessor.h"
+#include "BinaryProtocol.h"
+#include "AsyncRequest.h"
+#include "SharedReplica.h"
+#include "AdmissionControl.h"
+
+#include <string>
+#include <memory>
+#include <unordered_map>
+#include <deque>
+#include <map>
+#include <chrono>
+#include <iostream>
+
+using namespace std;
+
+// bytes read from a socket at once
+const size_t SERVER_READ_SIZE = 64 * 1024;
+
+// a connection isn't read while this many bytes of answers wait for its client
+const size_t SERVER_OUTPUT_LIMIT = 1 << 20;
+
+// a request line longer than this closes the connection
+const size_t SERVER_LINE_LIMIT = 64 * 1024;
+
+// when the server stops, the answers left are written to the clients that read them within this time
+const int SERVER_FLUSH_TIMEOUT_MS = 2000;
+
+// protocol of a connection, chosen by its first byte
+enum ConnectionProtocol {
+    PROTOCOL_UNKNOWN,    // nothing received yet
+    PROTOCOL_TEXT,       // CommandProcessor commands, one per line
+    PROTOCOL_BINARY      // BinaryProtocol frames
+};
+
+// number of events taken from epoll at once
+const int SERVER_EVENTS = 256;
+
+// what the server did since it started
+struct ServerStats {
+    unsigned long long accepted = 0;      // connections accepted
+    unsigned long long open = 0;          // connections open now
+    unsigned long long requests = 0;      // commands answered
+    unsigned long long deferred = 0;      // registrations answered once their journal records were durable
+    unsigned long long bytesRead = 0;
+    unsigned long long bytesWritten = 0;
+};
+
+class RegistrationServer {
+public:
+
+    /**
+ * @brief Constructor for the RegistrationServer class.
+ *
+ * @param terms The open terms shared by the connections.
+ *
+ * @pre At least one term is open.
+ *
+ * @post The server doesn't listen yet, listenUnix or listenTcp must be called before run().
+ */
+    RegistrationServer(TermDirectory &);
+
+    /**
+ * @brief Destructor for the RegistrationServer class.
+ *
+ * @pre None.
+ *
+ * @post Every connection and the listening socket are closed, the file of a Unix domain socket is removed.
+ */
+    ~RegistrationServer();
+
+    /**
+ * @brief Listen on a Unix domain socket.
+ *
+ * @param path The path of the socket file, an existing file is replaced.
+ * @return bool True if the socket is listening.
+ *
+ * @pre The server doesn't listen yet.
+ *
+ * @post On failure an error message is printed to the standard error stream (cerr).
+ */
+    bool listenUnix(const string &);
+
+    /**
+ * @brief Listen on a TCP port of the loopback interface (127.0.0.1).
+ *
+ * @param port The port, eg: 7400.
+ * @return bool True if the socket is listening.
+ *
+ * @pre The server doesn't listen yet.
+ *
+ * @post On failure an error message is printed to the standard error stream (cerr).
+ */
+    bool listenTcp(int);
+
+    /**
+ * @brief Serve the connections until SIGINT or SIGTERM.
+ *
+ * @param report Receives one line per second with the requests per second, the 50th, 99th and 99.9th
+ *        percentiles of their latency, the registrations waiting for the journal and their limit, the
+ *        registrations shed and the open connections, when there was any request in that second.
+ *
+ * @pre The server is listening.
+ *
+ * @post Every registration in flight is durable, its answer and the ones before it were written to the clients
+ *       still reading within SERVER_FLUSH_TIMEOUT_MS and the connections are closed. SIGINT and SIGTERM are
+ *       blocked in the calling thread.
+ */
+    void run(ostream &);
+
+    /**
+ * @brief Get the counters of the server.
+ *
+ * @return const ServerStats & The counters since the construction.
+ */
+    const ServerStats &getStats() const;
+
+    /**
+ * @brief Get the latencies of the requests, from the read of a request to its answer being ready to send.
+ *
+ * @return const LatencyHistogram & Every request since the construction.
+ */
+    const LatencyHistogram &getLatencies() const;
+
+    /**
+ * @brief Publish every open term into its shared memory segment, and again while the server runs.
+ *
+ * @return bool True if every segment is open and published.
+ *
+ * @pre Called before run().
+ *
+ * @post run() publishes a term again when its registrations changed it, at most every
+ *       REPLICA_PUBLISH_INTERVAL_MS. On failure an error message is printed to the standard error stream (cerr).
+ */
+    bool openReplicas();
+
+    /**
+ * @brief Get the counters of the admission control of the registrations.
+ *
+ * @return const AdmissionStats & The registrations let in and shed, the deepest queue and the current limit.
+ */
+    const AdmissionStats &getAdmission() const;
+
+private:
+    // the answer of a registration waiting for its journal records, and the answers of the requests after it
+    struct PendingAnswer {
+        string answer;
+        string after;                               // answers of the later requests, until the next pending one
+        bool ready = false;                         // the records are durable
+        chrono::steady_clock::time_point readAt;    // when the request was read
+    };
+
+    // a client connected to the server
+    struct Connection {
+        Connection(int, TermDirectory &);
+
+        int fileDescriptor;
+        bool closed;             // the descriptor was closed, a coroutine may still hold the connection
+        string input;            // bytes read and not yet a whole line
+        string output;           // answers not yet written
+        size_t written;          // bytes of output already written
+        unsigned int events;     // events registered in epoll
+        ConnectionProtocol protocol;
+        CommandProcessor processor;
+        BinaryProcessor binaryProcessor;
+        deque<unique_ptr<PendingAnswer>> pending;   // in the order of the requests
+    };
+
+    // Bind and listen on a socket of any family
+    bool startListening(int, const void *, size_t);
+
+    // Accept every waiting connection
+    void acceptConnections();
+
+    // Read what a connection sent and answer its complete requests; false if it must be closed
+    bool readConnection(Connection &);
+
+    // Answer the complete lines, or frames, of the input of a connection into answers; false if it must be closed
+    bool answerText(Connection &, string &);
+    bool answerBinary(Connection &, string &);
+
+    // Add answers to the output of a connection, or behind its last answer waiting for the journal
+    void appendAnswers(Connection &, const char *, size_t);
+
+    // DurabilityHook of the processors: hold the answer of a registration until its journal records are durable
+    void deferAnswer(Connection &, Registry &, unsigned long long, string &, size_t);
+
+    // Coroutine releasing a held answer once its journal records are durable
+    RequestTask sendWhenDurable(shared_ptr<Connection>, PendingAnswer *, Registry &, unsigned long long);
+
+    // Move the ready answers at the front of the pending ones to the output of a connection
+    void releaseAnswers(Connection &);
+
+    // Write, then watch or close a connection after its events
+    void settleConnection(Connection &, bool);
+
+    // Count the latency of requests since they were read
+    void recordLatency(chrono::steady_clock::time_point, unsigned long long);
+
+    // Write what the socket accepts of the answers; false if it must be closed
+    bool writeConnection(Connection &);
+
+    // Register the events a connection waits for, depending on its output buffer
+    void updateEvents(Connection &);
+
+    // Wait until the socket accepts all the answers when the server stops, or until the deadline
+    void flushConnection(Connection &, chrono::steady_clock::time_point);
+
+    void closeConnection(int);
+
+    // Publish the terms changed since their last publication, when REPLICA_PUBLISH_INTERVAL_MS passed since
+    void publishReplicas(chrono::steady_clock::time_point);
+
+    TermDirectory &terms;
+    int listenDescriptor;    // -1 when not listening
+    int epollDescriptor;
+    string socketPath;       // file of the Unix domain socket, empty for TCP
+    string readBuffer;       // SERVER_READ_SIZE bytes, shared by the connections
+    string answerBuffer;     // answers of the current read, shared by the connections
+    unordered_map<int, shared_ptr<Connection>> connections;
+    ServerStats stats;
+    JournalWaiter waiter;
+    AdmissionControl admission;                  // bounds the registrations waiting for the journal
+    vector<int> released;                        // connections with answers released by a coroutine
+    chrono::steady_clock::time_point readAt;     // when the requests being answered were read
+    unsigned long long deferredInRead;           // answers of the current read held for the journal
+    LatencyHistogram latencies;                  // since the construction
+    LatencyHistogram recentLatencies;            // since the last report
+    map<string, unique_ptr<ReplicaPublisher>> replicas;   // by name of term, empty without openReplicas
+    chrono::steady_clock::time_point nextPublish;
+
+};
+
+#endif //DSPROJ_REGISTRATIONSERVER_H
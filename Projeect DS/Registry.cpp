@@ -0,0 +1,1268 @@
+#include "Registry.h"
+#include <string>
+#include <vector>
+#include <unordered_set>
+#include <map>
+#include <thread>
+#include <algorithm>
+#include <cstring>
+#include <cstdio>
+#include <fstream>
+#include <unistd.h>
+#include <sys/wait.h>
+
+using namespace std;
+
+
+Registry::Registry(LListWithDummyNode<Student> &unregistered,
+                   LListWithDummyNode<Student> &registered,
+                   DoublyLinkedList<Course> &courseList)
+        : unregistered(unregistered), registered(registered), courseList(courseList),
+          checkpointSequence(0), compactionSequence(0), seatCoordinator(nullptr), checkpointRunning(false) {
+
+    // index the students of both lists and the offered courses by their id / code
+    unregistered.forEach([this](Student &student) { studentIndex[student.getStudentId()] = &student; });
+    registered.forEach([this](Student &student) { studentIndex[student.getStudentId()] = &student; });
+    courseList.forEach([this](Course &course) { courseIndex[course.getCourseCode()] = &course; });
+    rebuildQueryIndex();
+}
+
+
+Registry::~Registry() {
+    waitForCheckpoint();
+}
+
+
+Student *Registry::findStudent(const string &studentId) const {
+    shared_lock<shared_mutex> lock(registryMutex);
+    return lookupStudent(studentId);
+}
+
+
+Course *Registry::findCourse(const string &courseCode) const {
+    shared_lock<shared_mutex> lock(registryMutex);
+    return lookupCourse(courseCode);
+}
+
+
+Student *Registry::lookupStudent(const string &studentId) const {
+    auto it = studentIndex.find(studentId);
+    return it == studentIndex.end() ? nullptr : it->second;
+}
+
+
+Course *Registry::lookupCourse(const string &courseCode) const {
+    auto it = courseIndex.find(courseCode);
+    return it == courseIndex.end() ? nullptr : it->second;
+}
+
+
+bool Registry::isRegistered(const string &studentId) const {
+    shared_lock<shared_mutex> lock(registryMutex);
+
+    // a student is in the registered list as long as they have at least one course
+    Student *student = lookupStudent(studentId);
+    return student != nullptr && !student->getRegisteredCourse().empty();
+}
+
+
+RegistrationResult Registry::checkEligibility(const Student &student, const Course &course, int pendingCredits,
+                                              unsigned long long pendingSlots) const {
+    int credits = student.getNumberOfcredits() + pendingCredits + course.getNumberOfCredits();
+
+    if (student.hasCourse(course.getCourseCode()))
+        return ALREADY_REGISTERED;
+    // making sure that the course capacity isn't full
+    if (course.isFull())
+        return COURSE_FULL;
+    // making sure the student on probation doesn't exceed 12 credits
+    if (student.getGpa() < 2 && credits > MAX_CREDITS_PROBATION)
+        return CREDIT_LIMIT_PROBATION;
+    // making sure that the regular student doesn't exceed 18 credits
+    if (student.getGpa() >= 2 && credits > MAX_CREDITS_REGULAR)
+        return CREDIT_LIMIT_REGULAR;
+    // making sure the course doesn't meet at the same time as another course of the student
+    if ((student.getBookedSlots() | pendingSlots) & course.getMeetingSlots())
+        return TIME_CONFLICT;
+    // making sure every course required before this one is completed
+    if (!prerequisites.isSatisfied(course.getCourseCode(), student.getCompletedCourses()))
+        return MISSING_PREREQUISITE;
+
+    return REGISTRATION_OK;
+}
+
+
+RegistrationResult Registry::addCourse(const string &studentId, const string &courseCode,
+                                       unsigned long long *pendingSequence) {
+    unique_lock<shared_mutex> lock(registryMutex);
+    if (pendingSequence != nullptr)
+        *pendingSequence = 0;
+    if (journal.hasFailed())
+        return JOURNAL_FAILED;
+
+    Student *student = lookupStudent(studentId);
+    if (student == nullptr)
+        return STUDENT_NOT_FOUND;
+
+    Course *course = lookupCourse(courseCode);
+    if (course == nullptr)
+        return COURSE_NOT_FOUND;
+
+    RegistrationResult result = checkEligibility(*student, *course, 0, 0);
+    if (result != REGISTRATION_OK)
+        return result;
+
+    vector<string> seat(1, course->getCourseCode());
+    vector<int> section(1, AUTO_SECTION);
+    string fullCourse;
+    if (seatCoordinator != nullptr && !seatCoordinator->takeSeats(seat, section, fullCourse))
+        return COURSE_FULL;
+
+    bool wasRegistered = !student->getRegisteredCourse().empty();
+    if (!enroll(student, course, section[0])) {
+        if (seatCoordinator != nullptr)
+            seatCoordinator->releaseSeats(seat, section);
+        return ALREADY_REGISTERED;
+    }
+
+    // first course of the student: they now belong to the registered list
+    if (!wasRegistered)
+        moveStudent(student, unregistered, registered);
+
+    return commitJournal(lock, pendingSequence) ? REGISTRATION_OK : JOURNAL_FAILED;
+}
+
+
+RegistrationResult Registry::dropCourse(const string &studentId, const string &courseCode,
+                                        unsigned long long *pendingSequence) {
+    unique_lock<shared_mutex> lock(registryMutex);
+    if (pendingSequence != nullptr)
+        *pendingSequence = 0;
+    if (journal.hasFailed())
+        return JOURNAL_FAILED;
+
+    Student *student = lookupStudent(studentId);
+    if (student == nullptr)
+        return STUDENT_NOT_FOUND;
+
+    Course *course = lookupCourse(courseCode);
+    if (course == nullptr)
+        return COURSE_NOT_FOUND;
+
+    int sectionNumber = course->getSectionOf(student->getStudentId());
+    if (!student->hasCourse(courseCode) || !unenroll(student, course))
+        return NOT_REGISTERED;
+    if (seatCoordinator != nullptr)
+        seatCoordinator->releaseSeats(vector<string>(1, course->getCourseCode()), vector<int>(1, sectionNumber));
+
+    // last course dropped: the student goes back to the unregistered list
+    if (student->getRegisteredCourse().empty())
+        moveStudent(student, registered, unregistered);
+
+    return commitJournal(lock, pendingSequence) ? REGISTRATION_OK : JOURNAL_FAILED;
+}
+
+
+RegistrationResult Registry::registerBundle(const string &studentId, const vector<string> &courseCodes,
+                                            string &failedCourse, unsigned long long *pendingSequence) {
+    unique_lock<shared_mutex> lock(registryMutex);
+    failedCourse = "";
+    if (pendingSequence != nullptr)
+        *pendingSequence = 0;
+    if (journal.hasFailed())
+        return JOURNAL_FAILED;
+
+    Student *student = lookupStudent(studentId);
+    if (student == nullptr)
+        return STUDENT_NOT_FOUND;
+
+    bool wasRegistered = !student->getRegisteredCourse().empty();
+    RegistrationResult result = reserveBundle(student, courseCodes, failedCourse);
+
+    if (result == REGISTRATION_OK && !wasRegistered && !courseCodes.empty())
+        moveStudent(student, unregistered, registered);
+
+    bool saved = commitJournal(lock, pendingSequence);
+    return result == REGISTRATION_OK && !saved ? JOURNAL_FAILED : result;
+}
+
+
+int Registry::registerBundles(const vector<BundleRequest *> &batch) {
+    unique_lock<shared_mutex> lock(registryMutex);
+    if (journal.hasFailed()) {
+        for (BundleRequest *request: batch)
+            request->result = JOURNAL_FAILED;
+        return 0;
+    }
+
+    int accepted = 0;
+    vector<Student *> newlyRegistered; // moved to the registered list once the batch is done
+
+    for (BundleRequest *request: batch) {
+        request->failedCourse = "";
+
+        Student *student = lookupStudent(request->studentId);
+        if (student == nullptr) {
+            request->result = STUDENT_NOT_FOUND;
+            continue;
+        }
+
+        bool wasRegistered = !student->getRegisteredCourse().empty();
+        request->result = reserveBundle(student, request->courseCodes, request->failedCourse);
+
+        if (request->result == REGISTRATION_OK) {
+            endJournalOperation();
+            accepted++;
+            if (!wasRegistered && !request->courseCodes.empty())
+                newlyRegistered.push_back(student);
+        }
+    }
+
+    settleMoves(newlyRegistered, unregistered, registered);
+
+    // the whole batch is made durable by the same sync, or none of it is
+    if (!commitJournal(lock)) {
+        for (BundleRequest *request: batch)
+            if (request->result == REGISTRATION_OK)
+                request->result = JOURNAL_FAILED;
+        return 0;
+    }
+    return accepted;
+}
+
+
+RegistrationResult Registry::reserveBundle(Student *student, const vector<string> &courseCodes,
+                                           string &failedCourse) {
+    // validation: nothing is modified until every course of the bundle has been accepted
+    vector<Course *> bundle;
+    bundle.reserve(courseCodes.size());
+    int pendingCredits = 0;
+    unsigned long long pendingSlots = 0;
+
+    for (const string &code: courseCodes) {
+        Course *course = lookupCourse(code);
+        if (course == nullptr) {
+            failedCourse = code;
+            return COURSE_NOT_FOUND;
+        }
+
+        // the same course twice in one bundle
+        for (Course *accepted: bundle) {
+            if (accepted == course) {
+                failedCourse = code;
+                return ALREADY_REGISTERED;
+            }
+        }
+
+        RegistrationResult result = checkEligibility(*student, *course, pendingCredits, pendingSlots);
+        if (result != REGISTRATION_OK) {
+            failedCourse = code;
+            return result;
+        }
+
+        pendingCredits += course->getNumberOfCredits();
+        pendingSlots |= course->getMeetingSlots();
+        bundle.push_back(course);
+    }
+
+    // the seats shared with other registries are taken together, before any of them is taken here, in the
+    // sections the coordinator chose
+    vector<string> seats;
+    vector<int> sections(bundle.size(), AUTO_SECTION);
+    if (seatCoordinator != nullptr && !bundle.empty()) {
+        for (Course *course: bundle)
+            seats.push_back(course->getCourseCode());
+        if (!seatCoordinator->takeSeats(seats, sections, failedCourse))
+            return COURSE_FULL;
+    }
+
+    // reservation: take the seats one by one, undoing the previous ones if a seat is refused
+    size_t journalLength = journalRecords.size();
+    for (size_t i = 0; i < bundle.size(); i++) {
+        if (!enroll(student, bundle[i], sections[i])) {
+            for (size_t j = i; j > 0; j--)
+                unenroll(student, bundle[j - 1]);
+            journalRecords.resize(journalLength); // the undone seats never reach the journal
+            if (seatCoordinator != nullptr)
+                seatCoordinator->releaseSeats(seats, sections);
+
+            failedCourse = bundle[i]->getCourseCode();
+            return ALREADY_REGISTERED;
+        }
+    }
+
+    return REGISTRATION_OK;
+}
+
+
+bool Registry::enroll(Student *student, Course *course, int sectionNumber) {
+    // the course refuses the student if they are already in its roster
+    if (!course->registerStudent(student->getStudentId(), student->getFullName(), sectionNumber))
+        return false;
+
+    // the section is journaled so the replay puts the student back in the same one
+    if (journal.isOpen())
+        journalRecords.push_back(makeJournalRecord(JOURNAL_REGISTER, student->getStudentId(), course->getCourseCode(),
+                                                   course->getSectionOf(student->getStudentId())));
+
+    student->addCourse(course->getCourseCode());
+    student->setNumberOfCredits(student->getNumberOfcredits() + course->getNumberOfCredits());
+    student->setBookedSlots(student->getBookedSlots() | course->getMeetingSlots());
+    indexStudent(*student);
+    indexCourse(*course);
+    return true;
+}
+
+
+bool Registry::unenroll(Student *student, Course *course) {
+    if (!course->dropStudent(student->getStudentId()))
+        return false;
+
+    if (journal.isOpen())
+        journalRecords.push_back(makeJournalRecord(JOURNAL_DROP, student->getStudentId(), course->getCourseCode(), 0));
+
+    student->dropCourse(course->getCourseCode());
+    student->setNumberOfCredits(student->getNumberOfcredits() - course->getNumberOfCredits());
+    // the courses of a student never overlap, so the hours of this course belong to it only
+    student->setBookedSlots(student->getBookedSlots() & ~course->getMeetingSlots());
+    indexStudent(*student);
+    indexCourse(*course);
+    return true;
+}
+
+
+Student *Registry::moveStudent(Student *student, LListWithDummyNode<Student> &from, LListWithDummyNode<Student> &to) {
+    // the copy inserted at the beginning of 'to' becomes the student, the old node is then deleted
+    to.insertAtBegin(*student);
+    Student *moved = &to.retrieveAtIndex(0);
+    from.deleteAtElement(*moved);
+
+    studentIndex[moved->getStudentId()] = moved;
+    return moved;
+}
+
+
+void Registry::indexStudent(Student &student) {
+    queryIndex.setStudent(student.getStudentId(), student.getGpa(), student.getNumberOfcredits(),
+                          !student.getRegisteredCourse().empty());
+}
+
+
+void Registry::indexCourse(const Course &course) {
+    queryIndex.setCourse(course.getCourseCode(), course.getNumberOfCredits(),
+                         course.getCapacity() - course.getNumberOfEnrolled());
+}
+
+
+void Registry::rebuildQueryIndex() {
+    queryIndex.clear();
+    for (auto itr = studentIndex.begin(); itr != studentIndex.end(); ++itr)
+        indexStudent(*itr->second);
+    for (auto itr = courseIndex.begin(); itr != courseIndex.end(); ++itr)
+        indexCourse(*itr->second);
+}
+
+
+QueryResult Registry::findStudents(const StudentFilter &filter) const {
+    shared_lock<shared_mutex> lock(registryMutex);
+    return queryIndex.findStudents(filter);
+}
+
+
+QueryResult Registry::findCourses(const CourseFilter &filter) const {
+    shared_lock<shared_mutex> lock(registryMutex);
+    return queryIndex.findCourses(filter);
+}
+
+
+bool Registry::loadPrerequisites(const vector<string> &prerequisiteLines, const vector<string> &transcriptLines) {
+    lock_guard<shared_mutex> lock(registryMutex);
+
+    if (!prerequisites.build(prerequisiteLines))
+        return false;
+
+    // each transcript line is a student ID followed by the courses they completed
+    for (const string &line: transcriptLines) {
+        vector<string> values = split(line);
+        if (values.empty())
+            continue;
+
+        Student *student = lookupStudent(values[0]);
+        if (student != nullptr)
+            student->setCompletedCourses(prerequisites.toSet(vector<string>(values.begin() + 1, values.end())));
+    }
+
+    return true;
+}
+
+
+const PrerequisiteGraph &Registry::getPrerequisites() const {
+    return prerequisites;
+}
+
+
+int Registry::loadSections(const vector<string> &sectionLines) {
+    lock_guard<shared_mutex> lock(registryMutex);
+
+    // course code -> number and capacity of each of its sections, in the order of the lines
+    map<string, vector<pair<int, int>>> sections;
+    for (const string &line: sectionLines) {
+        vector<string> values = split(line);
+        if (values.size() != 3 || lookupCourse(values[0]) == nullptr ||
+            !isdigit(values[1][0]) || !isdigit(values[2][0])) {
+            cerr << "The section \"" << line << "\" is invalid and was skipped." << endl;
+            continue;
+        }
+        sections[values[0]].push_back(make_pair(stoi(values[1]), stoi(values[2])));
+    }
+
+    int numberOfCourses = 0;
+    for (auto itr = sections.begin(); itr != sections.end(); ++itr) {
+        if (lookupCourse(itr->first)->setSections(itr->second))
+            numberOfCourses++;
+    }
+    rebuildQueryIndex();
+    return numberOfCourses;
+}
+
+
+CatalogReload Registry::reloadCourses(const vector<string> &courseLines) {
+    lock_guard<shared_mutex> lock(registryMutex);
+    CatalogReload reload;
+
+    unordered_set<string> listed;
+    for (const string &line: courseLines) {
+        // a course whose code or title doesn't fit in Course.map is refused as it is at the start
+        Course newCourse(line);
+        CourseRecord record;
+        if (newCourse.getCourseCode().empty() || !newCourse.toRecord(record) ||
+            !listed.insert(newCourse.getCourseCode()).second) {
+            cerr << "The course \"" << line << "\" is invalid, too long or listed twice and was skipped." << endl;
+            reload.invalid++;
+            continue;
+        }
+
+        // the coordinator counts the seats reported at the start, it would refuse every seat of a new course
+        Course *course = lookupCourse(newCourse.getCourseCode());
+        if (course == nullptr && seatCoordinator != nullptr) {
+            reload.coordinatedSeats++;
+            continue;
+        }
+        if (course == nullptr) {
+            courseList.insertAtBegin(newCourse);
+            courseIndex[newCourse.getCourseCode()] = &courseList.retrieveAtIndex(0);
+            reload.added++;
+            continue;
+        }
+
+        if (course->getCourseTitle() != newCourse.getCourseTitle()) {
+            string title = newCourse.getCourseTitle();
+            course->setCourseTitle(title);
+            reload.titleChanges++;
+        }
+
+        if (course->getCapacity() != newCourse.getCapacity()) {
+            if (seatCoordinator != nullptr) {
+                reload.coordinatedSeats++;
+            } else if (course->getSections().size() > 1) {
+                reload.sectionedCourses++;
+            } else {
+                course->setCapacity(newCourse.getCapacity());
+                reload.capacityChanges++;
+                if (course->getNumberOfEnrolled() > newCourse.getCapacity())
+                    reload.overfull++;
+            }
+        }
+
+        // the students of the course carry its credits and its hours, they follow the new values
+        const map<string, string> &students = course->getRegisteredStudents();
+        int creditChange = newCourse.getNumberOfCredits() - course->getNumberOfCredits();
+        if (creditChange != 0) {
+            course->setNumberOfCredits(newCourse.getNumberOfCredits());
+            for (auto itr = students.begin(); itr != students.end(); ++itr) {
+                Student *student = lookupStudent(itr->first);
+                if (student != nullptr)
+                    student->setNumberOfCredits(student->getNumberOfcredits() + creditChange);
+            }
+            reload.creditChanges++;
+        }
+
+        if (course->getMeetingSlots() != newCourse.getMeetingSlots()) {
+            course->setMeetingSlots(newCourse.getMeetingSlots());
+            for (auto itr = students.begin(); itr != students.end(); ++itr) {
+                Student *student = lookupStudent(itr->first);
+                if (student == nullptr)
+                    continue;
+                unsigned long long slots = 0;
+                for (const string &courseCode: student->getRegisteredCourse()) {
+                    Course *taken = lookupCourse(courseCode);
+                    if (taken != nullptr)
+                        slots |= taken->getMeetingSlots();
+                }
+                student->setBookedSlots(slots);
+            }
+            reload.scheduleChanges++;
+        }
+    }
+
+    for (auto itr = courseIndex.begin(); itr != courseIndex.end(); ++itr) {
+        if (listed.count(itr->first) == 0)
+            reload.missing++;
+    }
+
+    // a reload changes the credits of students and the seats of courses, the index is built again
+    rebuildQueryIndex();
+    return reload;
+}
+
+
+int Registry::importEnrollments(const string &textPath, const string &snapshotPath, const string &journalPath) {
+    lock_guard<shared_mutex> lock(registryMutex);
+
+    // the snapshot and the journal hold the enrollments as soon as there is one of them
+    vector<JournalRecord> records;
+    unsigned long long lastSequence, segmentSequence;
+    long long validLength, segmentLength;
+    if (access(snapshotPath.c_str(), F_OK) == 0 ||
+        Journal::readRecords(journalPath + JOURNAL_SEGMENT_SUFFIX, 0, records, segmentSequence, segmentLength) != 0 ||
+        Journal::readRecords(journalPath, 0, records, lastSequence, validLength) != 0)
+        return 0;
+
+    ifstream file(textPath);
+    string line;
+    if (!file.is_open() || !getline(file, line))
+        return 0;
+
+    // the first line is the number of enrollments, then one "ID CODE SECTION" per line as exportText writes them
+    vector<JournalRecord> entries;
+    while (getline(file, line)) {
+        if (!line.empty() && line[line.length() - 1] == '\r')
+            line.erase(line.length() - 1);
+        vector<string> values = split(line);
+        if (values.size() != 3 || lookupStudent(values[0]) == nullptr || lookupCourse(values[1]) == nullptr ||
+            !isdigit(values[2][0])) {
+            cerr << "The enrollment \"" << line << "\" is invalid and was skipped." << endl;
+            continue;
+        }
+        entries.push_back(makeJournalRecord(JOURNAL_REGISTER, values[0], values[1], stoi(values[2])));
+    }
+
+    // a snapshot at sequence 0 is replayed by recover before every record of the new journal
+    if (!writeSnapshot(snapshotPath, 0, entries))
+        return -1;
+    return (int) entries.size();
+}
+
+
+bool Registry::recover(const string &snapshotPath, const string &journalPath, int numberOfThreads) {
+    lock_guard<shared_mutex> lock(registryMutex);
+    auto start = chrono::steady_clock::now();
+    int threads = max(numberOfThreads, 1);
+
+    // the snapshot first, then the journal records written after it, in the order they were applied: those of
+    // the segment a compaction didn't finish to fold, then those of the journal file
+    vector<JournalRecord> records;
+    unsigned long long snapshotSequence;
+    bool snapshotRead = readSnapshot(snapshotPath, snapshotSequence, records);
+    size_t snapshotEnrollments = records.size();
+
+    string segmentPath = journalPath + JOURNAL_SEGMENT_SUFFIX;
+    unsigned long long segmentSequence;
+    long long segmentLength;
+    long long segmentOperations = Journal::readRecords(segmentPath, snapshotSequence, records, segmentSequence,
+                                                       segmentLength);
+
+    unsigned long long lastSequence;
+    long long validLength;
+    long long operations = Journal::readRecords(journalPath, max(snapshotSequence, segmentSequence), records,
+                                                lastSequence, validLength);
+    if (operations == -1 || segmentOperations == -1) {
+        cerr << "The journal " << journalPath << " can't be read." << endl;
+        return false;
+    }
+    // without the snapshot only a journal starting at its first record holds every enrollment
+    if (!snapshotRead && (records.empty() || records.front().sequence != 1)) {
+        cerr << "The snapshot " << snapshotPath << " is damaged and the journal doesn't start at its first record, "
+             << "the enrollments can't be restored." << endl;
+        return false;
+    }
+    operations += segmentOperations;
+    lastSequence = max(lastSequence, segmentSequence);
+
+    // the courses are numbered so each thread can keep one bucket of seats per course
+    vector<Course *> courses;
+    unordered_map<string, int> courseNumbers;
+    for (auto itr = courseIndex.begin(); itr != courseIndex.end(); ++itr) {
+        courseNumbers[itr->first] = courses.size();
+        courses.push_back(itr->second);
+    }
+
+    // partitions[slice][partition]: the records of a slice whose student belongs to the partition
+    vector<vector<vector<const JournalRecord *>>> partitions(threads, vector<vector<const JournalRecord *>>(threads));
+    runOnThreads(threads, [&](int slice) {
+        size_t from = records.size() * slice / threads, to = records.size() * (slice + 1) / threads;
+        for (size_t i = from; i < to; i++) {
+            unsigned int partition = journalChecksum(records[i].studentId, sizeof(records[i].studentId)) % threads;
+            partitions[slice][partition].push_back(&records[i]);
+        }
+    });
+
+    // seats[partition][course]: the students of the partition enrolled in the course with their section
+    vector<vector<vector<pair<Student *, int>>>> seats(threads, vector<vector<pair<Student *, int>>>(courses.size()));
+    vector<unsigned long long> skipped(threads, 0);
+    runOnThreads(threads, [&](int partition) {
+        // the final courses of each student of the partition: course number -> section
+        unordered_map<Student *, vector<pair<int, int>>> enrollments;
+        for (int slice = 0; slice < threads; slice++) {
+            for (const JournalRecord *record: partitions[slice][partition]) {
+                Student *student = lookupStudent(record->studentId);
+                auto course = courseNumbers.find(record->courseCode);
+                if (student == nullptr || course == courseNumbers.end()) {
+                    skipped[partition]++;
+                    continue;
+                }
+
+                vector<pair<int, int>> &taken = enrollments[student];
+                auto seat = find_if(taken.begin(), taken.end(),
+                                    [&course](const pair<int, int> &entry) { return entry.first == course->second; });
+                if (record->type == JOURNAL_REGISTER && seat == taken.end())
+                    taken.push_back(make_pair(course->second, (int) record->section));
+                else if (record->type == JOURNAL_DROP && seat != taken.end())
+                    taken.erase(seat);
+            }
+        }
+
+        // the students of the partition belong to this thread only, their side is written directly
+        for (auto itr = enrollments.begin(); itr != enrollments.end(); ++itr) {
+            Student *student = itr->first;
+            for (const pair<int, int> &entry: itr->second) {
+                Course *course = courses[entry.first];
+                student->addCourse(course->getCourseCode());
+                student->setNumberOfCredits(student->getNumberOfcredits() + course->getNumberOfCredits());
+                student->setBookedSlots(student->getBookedSlots() | course->getMeetingSlots());
+                seats[partition][entry.first].push_back(make_pair(student, entry.second));
+            }
+        }
+    });
+
+    // the courses are shared by the partitions, so each one is rebuilt by a single thread from all its seats
+    runOnThreads(threads, [&](int thread) {
+        for (size_t number = thread; number < courses.size(); number += threads) {
+            vector<pair<Student *, int>> roster;
+            for (int partition = 0; partition < threads; partition++)
+                roster.insert(roster.end(), seats[partition][number].begin(), seats[partition][number].end());
+
+            sort(roster.begin(), roster.end(), [](const pair<Student *, int> &first, const pair<Student *, int> &second) {
+                return first.first->getStudentId() < second.first->getStudentId();
+            });
+            for (const pair<Student *, int> &seat: roster)
+                courses[number]->restoreStudent(seat.first->getStudentId(), seat.first->getFullName(), seat.second);
+            courses[number]->rebuildOpenSections();
+        }
+    });
+
+    // the replay only changed the courses of the students, now put each one in the list matching its courses
+    vector<Student *> nowRegistered, nowUnregistered;
+    unregistered.forEach([&nowRegistered](Student &student) {
+        if (!student.getRegisteredCourse().empty())
+            nowRegistered.push_back(&student);
+    });
+    registered.forEach([&nowUnregistered](Student &student) {
+        if (student.getRegisteredCourse().empty())
+            nowUnregistered.push_back(&student);
+    });
+    settleMoves(nowRegistered, unregistered, registered);
+    settleMoves(nowUnregistered, registered, unregistered);
+    rebuildQueryIndex();
+
+    // the journal continues after the last record, whether it is in the journal or only in the snapshot; a journal
+    // file ending before the snapshot is folded in it and emptied, so no gap is ever written after its last record
+    if (snapshotSequence > lastSequence)
+        validLength = 0;
+    bool opened = journal.open(journalPath, max(lastSequence, snapshotSequence) + 1, validLength);
+    this->snapshotPath = snapshotPath;
+    this->journalPath = journalPath;
+    checkpointSequence = snapshotSequence;
+    compactionSequence = snapshotSequence;
+
+    recoveryStats.snapshotEnrollments = snapshotEnrollments;
+    recoveryStats.journalRecords = records.size() - snapshotEnrollments;
+    recoveryStats.journalOperations = operations;
+    recoveryStats.skippedRecords = 0;
+    for (unsigned long long count: skipped)
+        recoveryStats.skippedRecords += count;
+    recoveryStats.threads = threads;
+    recoveryStats.milliseconds = chrono::duration<double, milli>(chrono::steady_clock::now() - start).count();
+
+    if (recoveryStats.skippedRecords > 0)
+        cerr << recoveryStats.skippedRecords << " enrollments refer to students or courses that are not in the data "
+                "files anymore and were skipped." << endl;
+    return opened;
+}
+
+
+const Journal &Registry::getJournal() const {
+    return journal;
+}
+
+
+const string &Registry::getSnapshotPath() const {
+    return snapshotPath;
+}
+
+
+bool Registry::saveSnapshot(const string &path) {
+    CheckpointView view;
+    while (true) {
+        {
+            lock_guard<shared_mutex> lock(registryMutex);
+            if (!checkpointRunning) {
+                view = captureCheckpoint();
+                checkpointRunning = true;
+                checkpointSequence = view.sequence;
+                break;
+            }
+        }
+        // only one checkpoint writes the snapshot file at a time
+        waitForCheckpoint();
+        this_thread::sleep_for(chrono::milliseconds(1));
+    }
+
+    return writeCheckpoint(view, path);
+}
+
+
+bool Registry::startCheckpoint(const string &path) {
+    lock_guard<shared_mutex> lock(registryMutex);
+    if (checkpointRunning)
+        return false;
+
+    return launchCheckpoint(captureCheckpoint(), path);
+}
+
+
+void Registry::waitForCheckpoint() {
+    // the thread is joined without the lock, it takes the lock to publish its figures
+    thread finishing;
+    {
+        lock_guard<mutex> lock(checkpointMutex);
+        finishing = move(checkpointThread);
+    }
+    if (finishing.joinable())
+        finishing.join();
+}
+
+
+CheckpointStats Registry::getCheckpointStats() const {
+    lock_guard<mutex> lock(checkpointMutex);
+    CheckpointStats stats = checkpointStats;
+    stats.running = checkpointRunning;
+    return stats;
+}
+
+
+Registry::CheckpointView Registry::captureCheckpoint() const {
+    CheckpointView view;
+    view.capturedAt = chrono::steady_clock::now();
+
+    // one shared pointer per course: the students are copied later, by the courses that change meanwhile
+    view.sequence = journal.getLastSequence();
+    view.rosters.reserve(courseIndex.size());
+    for (auto itr = courseIndex.begin(); itr != courseIndex.end(); ++itr)
+        view.rosters.push_back(make_pair(itr->first, itr->second->shareRoster()));
+
+    view.pauseMicroseconds = chrono::duration<double, micro>(chrono::steady_clock::now() - view.capturedAt).count();
+    return view;
+}
+
+
+bool Registry::writeCheckpoint(const CheckpointView &view, const string &path) {
+    vector<JournalRecord> entries;
+    for (const pair<string, shared_ptr<const Roster>> &course: view.rosters) {
+        const map<string, int> &students = course.second->studentSections;
+        for (auto student = students.begin(); student != students.end(); ++student)
+            entries.push_back(makeJournalRecord(JOURNAL_REGISTER, student->first, course.first, student->second));
+    }
+
+    // the view holds every record appended up to its sequence: a snapshot must never be ahead of the journal on the
+    // disk, or a crash would leave a gap after the records that were not synced
+    bool written = journal.waitDurable(view.sequence);
+    if (!written)
+        cerr << "The journal failed before the checkpoint was durable, the snapshot " << path << " is not written."
+             << endl;
+    written = written && writeSnapshot(path, view.sequence, entries);
+
+    {
+        lock_guard<mutex> lock(checkpointMutex);
+        if (written) {
+            checkpointStats.checkpoints++;
+            checkpointStats.enrollments = entries.size();
+            checkpointStats.sequence = view.sequence;
+            checkpointStats.pauseMicroseconds = view.pauseMicroseconds;
+            checkpointStats.durationMilliseconds =
+                    chrono::duration<double, milli>(chrono::steady_clock::now() - view.capturedAt).count();
+        }
+    }
+    checkpointRunning = false;
+    return written;
+}
+
+
+bool Registry::launchCheckpoint(CheckpointView view, const string &path) {
+    checkpointRunning = true;
+    checkpointSequence = view.sequence;
+
+    lock_guard<mutex> lock(checkpointMutex);
+    // the previous checkpoint thread has finished since checkpointRunning was false
+    if (checkpointThread.joinable())
+        checkpointThread.join();
+    checkpointThread = thread([this, view = move(view), path]() { writeCheckpoint(view, path); });
+    return true;
+}
+
+
+bool Registry::exportText(const string &directory, const string &fileSuffix) {
+    BufferedTextFile students(directory + "Student" + fileSuffix + ".txt");
+    BufferedTextFile courses(directory + "Course" + fileSuffix + ".txt");
+    BufferedTextFile sections(directory + "Section" + fileSuffix + ".txt");
+    BufferedTextFile enrollments(directory + "Enrollment" + fileSuffix + ".txt");
+    if (!students.isOpen() || !courses.isOpen() || !sections.isOpen() || !enrollments.isOpen())
+        return false;
+
+    // the text is written under the lock, the syncs of the files are not: the registrations go on meanwhile
+    unique_lock<shared_mutex> lock(registryMutex);
+
+    // Student.txt: ID First Last GPA
+    students.writeInteger(studentIndex.size());
+    students.write('\n');
+    auto writeStudent = [&students](Student &student) {
+        students.write(student.getStudentId());
+        students.write(' ');
+        students.write(student.getFirstName());
+        students.write(' ');
+        students.write(student.getLastName());
+        students.write(' ');
+        students.writeDecimal(student.getGpa());
+        students.write('\n');
+    };
+    unregistered.forEach(writeStudent);
+    registered.forEach(writeStudent);
+
+    // the number of lines of the other files is known before writing them
+    long long numberOfSections = 0, numberOfEnrollments = 0;
+    courseList.forEach([&numberOfSections, &numberOfEnrollments](Course &course) {
+        if (course.getSections().size() > 1)
+            numberOfSections += course.getSections().size();
+        numberOfEnrollments += course.getNumberOfEnrolled();
+    });
+
+    // Course.txt: CODE Title words credits capacity [meeting times]
+    courses.writeInteger(courseIndex.size());
+    courses.write('\n');
+    sections.writeInteger(numberOfSections);
+    sections.write('\n');
+    enrollments.writeInteger(numberOfEnrollments);
+    enrollments.write('\n');
+    courseList.forEach([&courses, &sections, &enrollments](Course &course) {
+        string title = course.getCourseTitle();
+        while (!title.empty() && title[title.length() - 1] == ' ')
+            title.erase(title.length() - 1);
+
+        courses.write(course.getCourseCode());
+        courses.write(' ');
+        courses.write(title);
+        courses.write(' ');
+        courses.writeInteger(course.getNumberOfCredits());
+        courses.write(' ');
+        courses.writeInteger(course.getCapacity());
+        if (course.getMeetingSlots() != 0) {
+            courses.write(' ');
+            courses.write(formatMeetingSlots(course.getMeetingSlots()));
+        }
+        courses.write('\n');
+
+        // Section.txt: CODE SECTION CAPACITY
+        if (course.getSections().size() > 1) {
+            for (const Section &section: course.getSections()) {
+                sections.write(course.getCourseCode());
+                sections.write(' ');
+                sections.writeInteger(section.number);
+                sections.write(' ');
+                sections.writeInteger(section.capacity);
+                sections.write('\n');
+            }
+        }
+
+        // Enrollment.txt: ID CODE SECTION
+        const map<string, int> &roster = course.shareRoster()->studentSections;
+        for (auto itr = roster.begin(); itr != roster.end(); ++itr) {
+            enrollments.write(itr->first);
+            enrollments.write(' ');
+            enrollments.write(course.getCourseCode());
+            enrollments.write(' ');
+            enrollments.writeInteger(itr->second);
+            enrollments.write('\n');
+        }
+    });
+    lock.unlock();
+
+    bool written = students.commit();
+    written = courses.commit() && written;
+    written = sections.commit() && written;
+    written = enrollments.commit() && written;
+    return written;
+}
+
+RegistryView Registry::pinView() const {
+    shared_lock<shared_mutex> lock(registryMutex);
+
+    RegistryView view;
+    view.sequence = journal.getLastSequence();
+    courseList.forEach([&view](Course &course) {
+        CourseVersion version;
+        version.courseCode = course.getCourseCode();
+        version.courseTitle = course.getCourseTitle();
+        version.numberOfCredits = course.getNumberOfCredits();
+        for (const Section &section: course.getSections())
+            version.sections.push_back(make_pair(section.number, section.capacity));
+        version.roster = course.shareRoster();
+        view.courses.push_back(move(version));
+    });
+    return view;
+}
+
+
+bool Registry::startCompaction(long long bytesPerSecond) {
+    lock_guard<shared_mutex> lock(registryMutex);
+    if (checkpointRunning || journalPath.empty())
+        return false;
+
+    return launchCompaction(bytesPerSecond);
+}
+
+
+CompactionStats Registry::getCompactionStats() const {
+    lock_guard<mutex> lock(checkpointMutex);
+    CompactionStats stats = compactionStats;
+    stats.running = checkpointRunning;
+    return stats;
+}
+
+
+bool Registry::launchCompaction(long long bytesPerSecond) {
+    auto start = chrono::steady_clock::now();
+    string segmentPath = journalPath + JOURNAL_SEGMENT_SUFFIX;
+
+    // a segment left by an interrupted compaction holds the older records: it is folded first, the journal file
+    // is rotated by the next compaction
+    if (access(segmentPath.c_str(), F_OK) != 0) {
+        if (!journal.rotate(segmentPath))
+            return false;
+        checkpointSequence = journal.getDurableSequence();
+    }
+    compactionSequence = journal.getLastSequence();
+    checkpointRunning = true;
+
+    lock_guard<mutex> lock(checkpointMutex);
+    // the previous thread has finished since checkpointRunning was false
+    if (checkpointThread.joinable())
+        checkpointThread.join();
+    checkpointThread = thread([this, segmentPath, bytesPerSecond, start]() {
+        compactJournal(segmentPath, bytesPerSecond, start);
+    });
+    return true;
+}
+
+
+bool Registry::compactJournal(const string &segmentPath, long long bytesPerSecond,
+                              chrono::steady_clock::time_point start) {
+    RateLimiter limiter(bytesPerSecond);
+
+    // the previous snapshot and the records of the segment written after it
+    vector<JournalRecord> entries;
+    unsigned long long snapshotSequence;
+    bool folded = readSnapshot(snapshotPath, snapshotSequence, entries, &limiter);
+
+    vector<JournalRecord> records;
+    unsigned long long lastSequence = 0;
+    long long validLength;
+    if (folded && Journal::readRecords(segmentPath, snapshotSequence, records, lastSequence, validLength,
+                                       &limiter) == -1)
+        folded = false;
+
+    // one entry per live enrollment, keyed by student ID and course code
+    unordered_map<string, JournalRecord> live;
+    if (folded) {
+        live.reserve(entries.size() + records.size());
+        for (const JournalRecord &entry: entries)
+            live.emplace(string(entry.studentId) + ' ' + entry.courseCode, entry);
+        for (const JournalRecord &record: records) {
+            string key = string(record.studentId) + ' ' + record.courseCode;
+            if (record.type == JOURNAL_REGISTER)
+                live.emplace(key, makeJournalRecord(JOURNAL_REGISTER, record.studentId, record.courseCode,
+                                                    record.section));
+            else
+                live.erase(key);
+        }
+    }
+
+    vector<JournalRecord> snapshot;
+    snapshot.reserve(live.size());
+    for (auto itr = live.begin(); itr != live.end(); ++itr)
+        snapshot.push_back(itr->second);
+
+    // the segment is deleted only once the snapshot replacing it is on the disk
+    unsigned long long sequence = max(snapshotSequence, lastSequence);
+    folded = folded && writeSnapshot(snapshotPath, sequence, snapshot, &limiter) && remove(segmentPath.c_str()) == 0;
+    if (!folded)
+        cerr << "The journal segment " << segmentPath << " couldn't be compacted, it is kept for the next try." << endl;
+
+    {
+        lock_guard<mutex> lock(checkpointMutex);
+        if (folded) {
+            compactionStats.compactions++;
+            compactionStats.foldedRecords = records.size();
+            compactionStats.liveEnrollments = snapshot.size();
+            compactionStats.deadRecords = entries.size() + records.size() - snapshot.size();
+            compactionStats.sequence = sequence;
+            compactionStats.bytes = limiter.getBytes();
+            compactionStats.durationMilliseconds =
+                    chrono::duration<double, milli>(chrono::steady_clock::now() - start).count();
+        }
+    }
+    checkpointRunning = false;
+    return folded;
+}
+
+
+const RecoveryStats &Registry::getRecoveryStats() const {
+    return recoveryStats;
+}
+
+
+void Registry::endJournalOperation() {
+    if (!journalRecords.empty())
+        journalRecords.back().flags |= JOURNAL_END;
+}
+
+
+bool Registry::commitJournal(unique_lock<shared_mutex> &lock, unsigned long long *pendingSequence) {
+    endJournalOperation();
+    bool journaled = !journalRecords.empty();
+    unsigned long long sequence = journal.append(journalRecords);
+    journalRecords.clear();
+
+    // a journal which failed refuses the records: the change is made but can't be saved
+    if (journaled && sequence == 0) {
+        lock.unlock();
+        return false;
+    }
+
+    // the journal grew enough since the last compaction or checkpoint: start a new one, it runs in the background
+    if (!snapshotPath.empty() && !checkpointRunning) {
+        if (sequence >= compactionSequence + COMPACTION_INTERVAL_RECORDS)
+            launchCompaction(COMPACTION_BYTES_PER_SECOND);
+        else if (sequence >= checkpointSequence + CHECKPOINT_INTERVAL_RECORDS)
+            launchCheckpoint(captureCheckpoint(), snapshotPath);
+    }
+
+    // other registrations can run while this one waits for the sync, and join the same group
+    lock.unlock();
+    if (pendingSequence != nullptr) {
+        *pendingSequence = sequence;
+        return true;
+    }
+    return journal.waitDurable(sequence);
+}
+
+
+bool Registry::waitDurable(unsigned long long sequence) {
+    return sequence == 0 || journal.waitDurable(sequence);
+}
+
+
+void Registry::setSeatCoordinator(SeatCoordinator *coordinator) {
+    lock_guard<shared_mutex> lock(registryMutex);
+    seatCoordinator = coordinator;
+}
+
+
+void Registry::runOnThreads(int numberOfThreads, const function<void(int)> &work) {
+    vector<thread> workers;
+    for (int i = 1; i < numberOfThreads; i++)
+        workers.emplace_back(work, i);
+
+    work(0);
+    for (thread &worker: workers)
+        worker.join();
+}
+
+
+void Registry::settleMoves(const vector<Student *> &students, LListWithDummyNode<Student> &from,
+                           LListWithDummyNode<Student> &to) {
+    if (students.empty())
+        return;
+
+    // copy the students to the other list and point the index to the copies
+    unordered_set<string> moved;
+    for (Student *student: students) {
+        to.insertAtBegin(*student);
+        studentIndex[student->getStudentId()] = &to.retrieveAtIndex(0);
+        moved.insert(student->getStudentId());
+    }
+
+    // then delete all the old nodes in a single traversal of the first list
+    from.deleteIf([&moved](const Student &student) { return moved.count(student.getStudentId()) > 0; });
+}
+
+
+string resultMessage(RegistrationResult result) {
+    switch (result) {
+        case REGISTRATION_OK:
+            return "Successfully registered.";
+        case STUDENT_NOT_FOUND:
+            return "The student you are looking for doesn't exists!";
+        case COURSE_NOT_FOUND:
+            return "The course is not offered.";
+        case ALREADY_REGISTERED:
+            return "Course already registered!!!";
+        case NOT_REGISTERED:
+            return "The course is not registered by this student.";
+        case COURSE_FULL:
+            return "The course has already reached its maximum capacity!!";
+        case CREDIT_LIMIT_PROBATION:
+            return "The student has reached their maximum allowed credits this semester as they are in probation.";
+        case CREDIT_LIMIT_REGULAR:
+            return "The student has reached their maximum allowed credits this semester.";
+        case TIME_CONFLICT:
+            return "The course meets at the same time as another course of the student.";
+        case MISSING_PREREQUISITE:
+            return "The student hasn't completed the prerequisites of the course.";
+        case JOURNAL_FAILED:
+            return "The journal can't be written, the registration is not saved and is lost at the next start.";
+    }
+    return "Unknown registration result.";
+}
+
+
+string resultName(RegistrationResult result) {
+    switch (result) {
+        case REGISTRATION_OK:
+            return "REGISTRATION_OK";
+        case STUDENT_NOT_FOUND:
+            return "STUDENT_NOT_FOUND";
+        case COURSE_NOT_FOUND:
+            return "COURSE_NOT_FOUND";
+        case ALREADY_REGISTERED:
+            return "ALREADY_REGISTERED";
+        case NOT_REGISTERED:
+            return "NOT_REGISTERED";
+        case COURSE_FULL:
+            return "COURSE_FULL";
+        case CREDIT_LIMIT_PROBATION:
+            return "CREDIT_LIMIT_PROBATION";
+        case CREDIT_LIMIT_REGULAR:
+            return "CREDIT_LIMIT_REGULAR";
+        case TIME_CONFLICT:
+            return "TIME_CONFLICT";
+        case MISSING_PREREQUISITE:
+            return "MISSING_PREREQUISITE";
+        case JOURNAL_FAILED:
+            return "JOURNAL_FAILED";
+    }
+    return "UNKNOWN_RESULT";
+}
+
+// Recover a registry of four students and one course from scratch files, give the students enrolled in the course
+// and run some registrations on it
+static bool runRecovered(const string &path, string &enrolled, const function<void(Registry &)> &work) {
+    LListWithDummyNode<Student> unregistered, registered;
+    DoublyLinkedList<Course> courses;
+    for (int i = 1; i <= 4; i++)
+        unregistered.insertAtBegin(Student(3, "A100000" + to_string(i), "Recovery", "Check"));
+    courses.insertAtBegin(Course(3, "CHECK100", "Recovery check", 10));
+
+    Registry registry(unregistered, registered, courses);
+    if (!registry.recover(path + "-Snapshot.bin", path + "-Journal.bin", 1))
+        return false;
+
+    enrolled.clear();
+    const map<string, string> &students = registry.findCourse("CHECK100")->getRegisteredStudents();
+    for (auto itr = students.begin(); itr != students.end(); ++itr)
+        enrolled += (enrolled.empty() ? "" : " ") + itr->first;
+    work(registry);
+    return true;
+}
+
+
+bool checkCrashRecovery(const string &path, ostream &out) {
+    string snapshotPath = path + "-Snapshot.bin", journalPath = path + "-Journal.bin";
+    remove(snapshotPath.c_str());
+    remove(journalPath.c_str());
+    bool passed = true;
+    auto expect = [&out, &passed](const string &step, const string &enrolled, const string &expected) {
+        out << step << ": " << (enrolled == expected ? "OK" : "FAILED") << " (" << enrolled << " / expected "
+            << expected << ")" << endl;
+        passed = passed && enrolled == expected;
+    };
+
+    // the child crashes with the third registration appended but not synced
+    pid_t child = fork();
+    if (child == 0) {
+        string enrolled;
+        runRecovered(path, enrolled, [&snapshotPath](Registry &registry) {
+            unsigned long long pending;
+            registry.addCourse("A1000001", "CHECK100");
+            registry.addCourse("A1000002", "CHECK100", &pending);
+            registry.saveSnapshot(snapshotPath);
+            registry.addCourse("A1000003", "CHECK100", &pending);
+            _exit(0);
+        });
+        _exit(1);
+    }
+    int status = -1;
+    if (child == -1 || waitpid(child, &status, 0) != child || !WIFEXITED(status) || WEXITSTATUS(status) != 0) {
+        out << "The process crashing in the middle of a group couldn't run." << endl;
+        return false;
+    }
+
+    string enrolled;
+    auto registerFourth = [](Registry &registry) { registry.addCourse("A1000004", "CHECK100"); };
+    auto registerNothing = [](Registry &) {};
+    passed = runRecovered(path, enrolled, registerFourth) && passed;
+    expect("First recovery after the crash", enrolled, "A1000001 A1000002");
+    passed = runRecovered(path, enrolled, registerNothing) && passed;
+    expect("Second recovery after the crash", enrolled, "A1000001 A1000002 A1000004");
+
+    // a snapshot ahead of the last record of the journal file
+    vector<JournalRecord> entries(1, makeJournalRecord(JOURNAL_REGISTER, "A1000001", "CHECK100", 1));
+    writeSnapshot(snapshotPath, 100, entries);
+    passed = runRecovered(path, enrolled, [](Registry &registry) {
+        registry.addCourse("A1000003", "CHECK100");
+    }) && passed;
+    expect("First recovery from a snapshot ahead of the journal", enrolled, "A1000001");
+    passed = runRecovered(path, enrolled, registerNothing) && passed;
+    expect("Second recovery from a snapshot ahead of the journal", enrolled, "A1000001 A1000003");
+
+    // a damaged snapshot is refused while the journal starts after it, and ignored when the journal starts at 1
+    auto damageSnapshot = [&snapshotPath]() {
+        FILE *snapshot = fopen(snapshotPath.c_str(), "r+b");
+        bool damaged = snapshot != nullptr && fseek(snapshot, sizeof(SnapshotHeader), SEEK_SET) == 0 &&
+                       fputc('#', snapshot) != EOF;
+        return (snapshot == nullptr || fclose(snapshot) == 0) && damaged;
+    };
+    bool refused = damageSnapshot() && !runRecovered(path, enrolled, registerNothing);
+    expect("Recovery from a damaged snapshot and a journal after it", refused ? "refused" : enrolled, "refused");
+    remove(snapshotPath.c_str());
+    remove(journalPath.c_str());
+    runRecovered(path, enrolled, [&snapshotPath](Registry &registry) {
+        registry.addCourse("A1000002", "CHECK100");
+        registry.saveSnapshot(snapshotPath);
+    });
+    passed = damageSnapshot() && runRecovered(path, enrolled, registerNothing) && passed;
+    expect("Recovery from a damaged snapshot and the whole journal", enrolled, "A1000002");
+
+    remove(snapshotPath.c_str());
+    remove(journalPath.c_str());
+    return passed;
+}
@@ -0,0 +1,823 @@
+/**
+
+    @file Registry.h
+    @brief Declaration of the Registry class and its member functions.
+
+    This file contains the declaration of the Registry class, which groups the list of unregistered students,
+    the list of registered students and the list of offered courses behind a single registration API.
+
+    date 18 Oct 2026
+
+    The purpose of this class is to be the only place where enrollments are created or removed. Every
+    registration checks the same rules (course already taken, capacity, credit limit) and keeps
+    Course::registeredStudents, Student::courseRegistred, the student's credits and the student's list
+    (registered or unregistered) consistent with each other. All mutations hold one shared_mutex exclusively so
+    registrations coming from several threads can't interleave, while the lookups and the queries only share it,
+    eg: the reads of a WorkStealingPool run side by side and only wait for a registration being applied.
+
+    Once a journal is open every mutation is appended to it under the lock, and the caller waits for it to be
+    durable after the lock is released, so the fsync of one registration never blocks the next ones. A caller which
+    can't block, eg: the loop of the server, passes a pendingSequence instead and waits with waitDurable later.
+    A registration whose records couldn't be written is answered JOURNAL_FAILED, and once the journal failed every
+    new registration is refused with JOURNAL_FAILED before changing anything, since none could be saved.
+
+    When the students are split over several registries which offer the same courses, eg: the shards of
+    Sharding.h, the seats of a section are counted by a SeatCoordinator: a registration which passed every check
+    of this registry takes its seats from the coordinator, all or none, in the sections it chooses, before
+    enrolling, and a drop gives the seat of its section back.
+
+    The fields the filter queries read (GPA, credits and courses of the students, credits and seats of the courses)
+    are copied into a QueryIndex, rebuilt after a recovery or a reload and updated by every enrollment and drop, so
+    findStudents and findCourses never walk the lists.
+
+    Public Member Functions:
+        1. Registry(LListWithDummyNode<Student> &, LListWithDummyNode<Student> &, DoublyLinkedList<Course> &)
+        2. findStudent(const string &) const: Student *
+        3. findCourse(const string &) const: Course *
+        4. isRegistered(const string &) const: bool
+        5. checkEligibility(const Student &, const Course &, int, unsigned long long) const: RegistrationResult
+        6. addCourse(const string &, const string &): RegistrationResult
+        7. dropCourse(const string &, const string &): RegistrationResult
+        8. registerBundle(const string &, const vector<string> &, string &): RegistrationResult
+        9. registerBundles(const vector<BundleRequest *> &): int
+        10. loadPrerequisites(const vector<string> &, const vector<string> &): bool
+        11. getPrerequisites() const: const PrerequisiteGraph &
+        12. loadSections(const vector<string> &): int
+        13. recover(const string &, const string &, int): bool
+        14. getJournal() const: const Journal &
+        15. saveSnapshot(const string &): bool
+        16. getRecoveryStats() const: const RecoveryStats &
+        17. ~Registry()
+        18. startCheckpoint(const string &): bool
+        19. waitForCheckpoint(): void
+        20. getCheckpointStats() const: CheckpointStats
+        21. exportText(const string &, const string &): bool
+        22. startCompaction(long long): bool
+        23. getCompactionStats() const: CompactionStats
+        24. pinView() const: RegistryView
+        25. reloadCourses(const vector<string> &): CatalogReload
+        26. getSnapshotPath() const: const string &
+        27. waitDurable(unsigned long long): bool
+        28. setSeatCoordinator(SeatCoordinator *): void
+        29. findStudents(const StudentFilter &) const: QueryResult
+        30. findCourses(const CourseFilter &) const: QueryResult
+        31. importEnrollments(const string &, const string &, const string &): int
+
+    Free Functions:
+        1. resultMessage(RegistrationResult): string
+        2. resultName(RegistrationResult): string
+        3. checkCrashRecovery(const string &, ostream &): bool
+*/
+
+#ifndef DSPROJ_REGISTRY_H
+#define DSPROJ_REGISTRY_H
+
+#include "Course.h"
+#include "Student.h"
+#include "LListWithDummyNode.h"
+#include "DoublyLinkedList.h"
+#include "PrerequisiteGraph.h"
+#include "Journal.h"
+#include "Snapshot.h"
+#include "BufferedTextFile.h"
+#include "RegistryView.h"
+#include "QueryIndex.h"
+
+#include <string>
+#include <vector>
+#include <mutex>
+#include <shared_mutex>
+#include <unordered_map>
+#include <functional>
+#include <memory>
+#include <thread>
+#include <atomic>
+#include <chrono>
+
+using namespace std;
+
+// maximum number of credits a student may register in one semester
+const int MAX_CREDITS_REGULAR = 18;
+const int MAX_CREDITS_PROBATION = 12;
+
+// a checkpoint is started in the background every time the journal grows by this number of records
+const unsigned long long CHECKPOINT_INTERVAL_RECORDS = 50000;
+
+// a compaction is started in the background every time the journal grows by this number of records
+const unsigned long long COMPACTION_INTERVAL_RECORDS = 200000;
+
+// disk bandwidth a compaction may use, its reads and writes together
+const long long COMPACTION_BYTES_PER_SECOND = 32LL << 20;
+
+/**
+ * @brief Outcome of a registration request.
+ *
+ * Every registration method of the Registry returns one of these values instead of printing, so the
+ * caller decides how to report it (menu, file, ...). resultMessage() gives the text shown to the user.
+ */
+enum RegistrationResult {
+    REGISTRATION_OK,
+    STUDENT_NOT_FOUND,
+    COURSE_NOT_FOUND,
+    ALREADY_REGISTERED,
+    NOT_REGISTERED,
+    COURSE_FULL,
+    CREDIT_LIMIT_PROBATION,
+    CREDIT_LIMIT_REGULAR,
+    TIME_CONFLICT,
+    MISSING_PREREQUISITE,
+    JOURNAL_FAILED          // the change was made but the journal failed to write it, it is lost at the next start
+};
+
+/**
+ * @brief One bundle of a batch given to Registry::registerBundles.
+ *
+ * The registry fills 'result' and 'failedCourse' the same way registerBundle does.
+ */
+struct BundleRequest {
+    string studentId;
+    vector<string> courseCodes;
+    RegistrationResult result = REGISTRATION_OK;
+    string failedCourse;
+};
+
+// what the last recovery found and how long it took
+struct RecoveryStats {
+    unsigned long long snapshotEnrollments = 0; // enrollments loaded from the snapshot
+    unsigned long long journalRecords = 0;      // records of the journal written after the snapshot
+    long long journalOperations = 0;            // complete operations among them
+    unsigned long long skippedRecords = 0;      // records of students or courses that are not in the data files
+    int threads = 0;
+    double milliseconds = 0;                    // from reading the snapshot to the journal open for appending
+};
+
+// what the last checkpoint wrote and what it cost
+struct CheckpointStats {
+    unsigned long long checkpoints = 0;  // checkpoints written since the start
+    unsigned long long enrollments = 0;  // enrollments in the last checkpoint
+    unsigned long long sequence = 0;     // last journal record included in the last checkpoint
+    double pauseMicroseconds = 0;        // time the registrations were blocked to capture the last checkpoint
+    double durationMilliseconds = 0;     // from the capture to the last checkpoint synced on the disk
+    bool running = false;                // a checkpoint is being written
+};
+
+// what a reload of the course catalog changed
+struct CatalogReload {
+    int added = 0;             // courses offered from now on
+    int capacityChanges = 0;
+    int creditChanges = 0;
+    int scheduleChanges = 0;   // courses meeting at other times
+    int titleChanges = 0;
+    int overfull = 0;          // courses whose new capacity is below their number of students, they keep them
+    int sectionedCourses = 0;  // courses split in sections, their capacity is set by Section.txt and was not changed
+    int coordinatedSeats = 0;  // new courses and capacities refused, the seats are counted by a SeatCoordinator
+    int missing = 0;           // courses not in the new catalog, kept with their students
+    int invalid = 0;           // lines skipped: invalid format, too long for Course.map or course listed twice
+};
+
+// what the last compaction folded and what it cost
+struct CompactionStats {
+    unsigned long long compactions = 0;     // compactions finished since the start
+    unsigned long long foldedRecords = 0;   // journal records folded into the last snapshot
+    unsigned long long liveEnrollments = 0; // enrollments in the last snapshot
+    unsigned long long deadRecords = 0;     // snapshot entries and records that cancelled each other out
+    unsigned long long sequence = 0;        // last journal record included in the last snapshot
+    unsigned long long bytes = 0;           // bytes read and written by the last compaction
+    double durationMilliseconds = 0;        // from the rotation of the journal to the segment deleted
+    bool running = false;                   // a compaction is running
+};
+
+/**
+ * @brief Counts the seats of courses shared by several registries.
+ *
+ * A registry with a coordinator still checks the capacity of its own courses, which only hold its own students,
+ * and asks the coordinator for the seats once everything else is accepted. The coordinator chooses the section of
+ * every seat, since only it knows how loaded the sections are in all the registries. It is called under the lock
+ * of the registry and may block on it, eg: ShardSeats waits for an answer from another process.
+ */
+class SeatCoordinator {
+public:
+    virtual ~SeatCoordinator() {}
+
+    // Take one seat in every course, all or none, and set the section of each; false with the code of a course
+    // without a seat left
+    virtual bool takeSeats(const vector<string> &, vector<int> &, string &) = 0;
+
+    // Give back one seat in every course, in its section
+    virtual void releaseSeats(const vector<string> &, const vector<int> &) = 0;
+};
+
+class Registry {
+public:
+
+    // Constructor
+
+    /**
+ * @brief Constructor for the Registry class.
+ *
+ * This constructor attaches the registry to the three lists built in main() and indexes their content.
+ *
+ * @param unregistered The list of students that are not registered in any course.
+ * @param registered The list of students registered in at least one course.
+ * @param courseList The list of offered courses.
+ *
+ * @pre The lists outlive the Registry object and are only modified through it from now on.
+ *
+ * @post Every student and course of the lists can be found by id or code in constant time.
+ *
+ * @details The lists are walked once with forEach and a pointer to every element is stored in a hash map
+ * keyed by the student id or the course code. The registry keeps the maps up to date whenever it moves a
+ * student from one list to the other.
+ */
+    Registry(LListWithDummyNode<Student> &, LListWithDummyNode<Student> &, DoublyLinkedList<Course> &);
+
+    /**
+ * @brief Destructor for the Registry class.
+ *
+ * @pre None.
+ *
+ * @post The checkpoint being written, if any, is finished.
+ */
+    ~Registry();
+
+    // Lookup methods
+
+    /**
+ * @brief Find a student by id in both lists.
+ *
+ * @param studentId The id of the student (uppercase).
+ * @return Student* A pointer to the student, or nullptr if no student has this id.
+ *
+ * @pre None.
+ *
+ * @post None.
+ *
+ * @details The index is read under a shared lock of the registry, so lookups from any number of threads run
+ * together and only wait for a mutation. The student itself is not locked: the pointer stays valid until a
+ * registration or a drop moves the student to the other list, so it is used by the thread which registers, or
+ * while that thread waits (eg: the pool of executeAll).
+ */
+    Student *findStudent(const string &) const;
+
+    /**
+ * @brief Find an offered course by code.
+ *
+ * @param courseCode The code of the course (uppercase).
+ * @return Course* A pointer to the course, or nullptr if the course is not offered.
+ *
+ * @pre None.
+ *
+ * @post None.
+ *
+ * @details The index is read under a shared lock of the registry, the course stays at the same address until the
+ * registry is destroyed.
+ */
+    Course *findCourse(const string &) const;
+
+    /**
+ * @brief Check if a student is in the list of registered students.
+ *
+ * @param studentId The id of the student (uppercase).
+ * @return bool True if the student exists and is registered in at least one course.
+ *
+ * @pre None.
+ *
+ * @post None.
+ */
+    bool isRegistered(const string &) const;
+
+    // Registration methods
+
+    /**
+ * @brief Check if a student can take a course.
+ *
+ * @param student The student who wants to register.
+ * @param course The course to register.
+ * @param pendingCredits Credits already accepted for the student but not applied yet (used by bundles).
+ * @param pendingSlots Meeting times already accepted for the student but not applied yet (used by bundles).
+ * @return RegistrationResult REGISTRATION_OK if the student can take the course, the reason otherwise.
+ *
+ * @pre None.
+ *
+ * @post None, the student and the course are not modified.
+ *
+ * @details The rules are the ones of the registration menu: the course must not be taken already, it must
+ * have a free seat, and the credits of the student must stay under 12 on probation or 18 otherwise.
+ * The course must also not meet at the same time as a course of the student: since both schedules are
+ * weekly bitmasks this is a single AND with the booked hours of the student. Finally every course required
+ * before the course must be completed, which is an AND between the precomputed closure of its prerequisites
+ * and the completed courses of the student.
+ */
+    RegistrationResult checkEligibility(const Student &, const Course &, int, unsigned long long) const;
+
+    /**
+ * @brief Register one course for a student.
+ *
+ * @param studentId The id of the student (uppercase).
+ * @param courseCode The code of the course (uppercase).
+ * @param pendingSequence When not null the call doesn't wait for the journal: it is set to the sequence to give
+ *                        to waitDurable, or 0 if nothing was journaled.
+ * @return RegistrationResult REGISTRATION_OK on success, the reason of the failure otherwise. JOURNAL_FAILED
+ *         when the enrollment was made but the journal failed to write it, or before anything is checked when
+ *         the journal had already failed.
+ *
+ * @pre None.
+ *
+ * @post On success the student is enrolled in the course, their credits are updated and they are moved
+ *       to the registered list if they were unregistered.
+ */
+    RegistrationResult addCourse(const string &, const string &, unsigned long long *pendingSequence = nullptr);
+
+    /**
+ * @brief Drop one course for a student.
+ *
+ * @param studentId The id of the student (uppercase).
+ * @param courseCode The code of the course (uppercase).
+ * @param pendingSequence As for addCourse.
+ * @return RegistrationResult REGISTRATION_OK on success, the reason of the failure otherwise.
+ *
+ * @pre None.
+ *
+ * @post On success the student is removed from the course, their credits are updated and they are moved
+ *       back to the unregistered list if it was their last course.
+ */
+    RegistrationResult dropCourse(const string &, const string &, unsigned long long *pendingSequence = nullptr);
+
+    /**
+ * @brief Register a bundle of courses for a student, all or nothing.
+ *
+ * @param studentId The id of the student (uppercase).
+ * @param courseCodes The codes of the courses to register (uppercase).
+ * @param failedCourse Set to the code of the course that made the bundle fail, empty on success.
+ * @param pendingSequence As for addCourse.
+ * @return RegistrationResult REGISTRATION_OK if every course was registered, the reason otherwise.
+ *
+ * @pre None.
+ *
+ * @post Either the student is enrolled in every course of the bundle, or nothing was changed.
+ *
+ * @details The whole bundle is handled under one lock. Every course is first validated with the credits
+ * of the previous courses of the bundle counted as pending, so nothing is touched if one of them fails.
+ * The seats are then taken one by one and every step is recorded; if a step is refused the recorded
+ * steps are undone in reverse order before returning.
+ */
+    RegistrationResult registerBundle(const string &, const vector<string> &, string &,
+                                      unsigned long long *pendingSequence = nullptr);
+
+    /**
+ * @brief Register a batch of bundles under a single lock.
+ *
+ * @param batch The bundles to register, in the order they must be applied.
+ * @return int The number of bundles that were registered, 0 if the journal failed to write them.
+ *
+ * @pre None.
+ *
+ * @post Every bundle of the batch was applied all or nothing, in order, and its result is stored in it. The
+ *       bundles applied are JOURNAL_FAILED when the journal failed to write the batch.
+ *
+ * @details This is the bulk version of registerBundle used when many requests arrive together. The lock is
+ * taken once for the whole batch, and the students registered for the first time are moved to the registered
+ * list in one pass over the unregistered list at the end of the batch instead of one search per student.
+ */
+    int registerBundles(const vector<BundleRequest *> &);
+
+    // Prerequisite methods
+
+    /**
+ * @brief Load the prerequisites of the catalog and the courses completed by the students.
+ *
+ * @param prerequisiteLines One line per course: the course code followed by the codes of its direct prerequisites.
+ * @param transcriptLines One line per student: the student ID followed by the codes of the completed courses.
+ * @return bool True if the prerequisites were loaded, false if they contain a cycle.
+ *
+ * @pre The codes and IDs are uppercase.
+ *
+ * @post The registry refuses a course to a student who hasn't completed every course required before it.
+ *       If the prerequisites contain a cycle they are not checked at all.
+ *
+ * @details The transitive closure of the prerequisites is computed here, once, see PrerequisiteGraph::build.
+ * Students that are not in the transcript lines have no completed course.
+ */
+    bool loadPrerequisites(const vector<string> &, const vector<string> &);
+
+    /**
+ * @brief Get the prerequisite graph of the catalog.
+ *
+ * @return const PrerequisiteGraph & The graph loaded by loadPrerequisites, empty before.
+ */
+    const PrerequisiteGraph &getPrerequisites() const;
+
+    // Section methods
+
+    /**
+ * @brief Split the courses of the catalog in sections.
+ *
+ * @param sectionLines One line per section: the course code, the section number and the section capacity,
+ * eg: "ENGL101 2 30".
+ * @return int The number of courses whose sections were set.
+ *
+ * @pre No student is registered yet.
+ *
+ * @post Every course listed in the lines has exactly the sections of the lines and its capacity is their sum,
+ *       the other courses keep a single section. Registrations then place the student in the least loaded open
+ *       section of the course, see Course::registerStudent.
+ *
+ * @details Lines with an unknown course or an invalid format are reported on the standard error stream (cerr)
+ * and skipped.
+ */
+    int loadSections(const vector<string> &);
+
+    // Catalog methods
+
+    /**
+ * @brief Apply a new version of the course catalog while the program runs.
+ *
+ * @param courseLines One line per course in the format of Course.txt.
+ * @return CatalogReload The number of courses added and changed, by kind of change.
+ *
+ * @pre None.
+ *
+ * @post The new courses are offered and indexed, the existing courses have the title, credits, capacity and meeting
+ *       times of the lines, and every roster is kept. The registered students have their credits and booked hours
+ *       updated to the new values of their courses.
+ *
+ * @details Each line is parsed into a Course and compared with the course of the same code found through the
+ * index, so only the courses that differ are touched and the index only receives the new ones. A new course is
+ * inserted at the beginning of the course list, which is where main() puts the courses read at the start. A course
+ * missing from the lines is kept since its students can't be dropped silently. A capacity below the number of
+ * students closes the course without dropping anyone, and the capacity of a course split in sections stays the sum
+ * of its sections, as it is at the start. With a SeatCoordinator the new courses and the capacity changes are
+ * refused, the coordinator only counts the seats reported at the start.
+ */
+    CatalogReload reloadCourses(const vector<string> &);
+
+    // Journal methods
+
+    /**
+ * @brief Turn the enrollments of Enrollment.txt into the first snapshot of a registry that has none.
+ *
+ * @param textPath The path of the enrollment file written by exportText.
+ * @param snapshotPath The path of the snapshot recover() will read.
+ * @param journalPath The path of the journal recover() will read.
+ * @return int The number of enrollments written to the snapshot, 0 if none was imported, -1 if the snapshot
+ * couldn't be written.
+ *
+ * @pre The sections are loaded and recover() was not called yet.
+ *
+ * @post When there is no snapshot and the journal holds no record, the valid lines of the file are written to a
+ *       snapshot at sequence 0, which the following recover() restores like any other snapshot. Otherwise nothing
+ *       changes: the snapshot and the journal are newer than any export.
+ *
+ * @details Lines with an unknown student, an unknown course or an invalid format are reported on the standard
+ * error stream (cerr) and skipped. A section the course doesn't have is restored in its first section.
+ */
+    int importEnrollments(const string &, const string &, const string &);
+
+    /**
+ * @brief Restore the enrollments of the previous runs and journal the next mutations.
+ *
+ * @param snapshotPath The path of the latest snapshot, a missing snapshot means the whole journal is replayed.
+ * @param journalPath The path of the journal file, it is created if it doesn't exist.
+ * @param numberOfThreads The number of threads replaying the records.
+ * @return bool True if the registry was restored and the journal is open, false otherwise, eg: the snapshot is
+ * damaged and the journal doesn't start at its first record.
+ *
+ * @pre The sections are loaded and no student is registered yet, so the replay finds the state in which
+ * the journal was written.
+ *
+ * @post The enrollments of the snapshot and of the journal records written after it are applied without checking
+ *       them again, the students are moved to the list matching their courses, and every following registration
+ *       or drop is durable when it returns. The figures of the recovery are kept, see getRecoveryStats().
+ *
+ * @details The records are partitioned by student ID. Each thread first splits a slice of the records by
+ * partition, then replays the records of one partition in their journal order: the final courses of a student
+ * only depend on their own records, so the partitions don't share anything. Each thread fills
+ * Student::courseRegistred for its students and collects their seats per course, then the courses are split
+ * between the threads and each Course::registeredStudents is built from its sorted seats in one pass. An operation
+ * interrupted by a crash is not replayed and its torn records are cut off the file. The records of a journal segment
+ * left by an interrupted compaction are read before those of the journal file. A journal file whose last record is
+ * older than the snapshot is emptied, so the next record never follows it with a gap in the sequence. A damaged
+ * snapshot is ignored only when the journal still starts at its first record, otherwise the enrollments folded into
+ * it would be lost and the recovery is refused.
+ */
+    bool recover(const string &, const string &, int);
+
+    /**
+ * @brief Get the journal of the registry.
+ *
+ * @return const Journal & The journal, closed until recover is called.
+ */
+    const Journal &getJournal() const;
+
+    /**
+ * @brief Get the path of the snapshot of the registry.
+ *
+ * @return const string & The snapshot path given to recover, where the checkpoints of this registry go, empty before.
+ */
+    const string &getSnapshotPath() const;
+
+    /**
+ * @brief Write a snapshot of every enrollment of the registry and wait for it.
+ *
+ * @param path The path of the snapshot file.
+ * @return bool True if the snapshot was written.
+ *
+ * @pre None.
+ *
+ * @post The next recovery loads this snapshot and only replays the journal records written after it.
+ *
+ * @details Same capture as startCheckpoint, but the file is written by the calling thread, eg: when quitting.
+ */
+    bool saveSnapshot(const string &);
+
+    /**
+ * @brief Start writing a checkpoint of every enrollment on a background thread.
+ *
+ * @param path The path of the snapshot file.
+ * @return bool True if the checkpoint was started, false if another one is still being written.
+ *
+ * @pre None.
+ *
+ * @post The registrations continue while the checkpoint is written, see getCheckpointStats().
+ *
+ * @details The point-in-time view is captured under the lock by sharing the roster of every course
+ * (Course::shareRoster), which only copies one pointer per course. A course changed during the checkpoint
+ * copies its roster before the change, so the checkpoint thread keeps reading the rosters exactly as they were
+ * at the sequence number of the capture. The checkpoint thread waits for the journal records up to that sequence
+ * to be durable before writing the snapshot, so it never holds a registration a crash could take out of the
+ * journal. The journal also starts a checkpoint by itself every CHECKPOINT_INTERVAL_RECORDS records once recover
+ * has been called.
+ */
+    bool startCheckpoint(const string &);
+
+    /**
+ * @brief Wait for the checkpoint being written, if any.
+ *
+ * @pre None.
+ *
+ * @post No checkpoint is running.
+ */
+    void waitForCheckpoint();
+
+    /**
+ * @brief Get the figures of the checkpoints, including the pause and the duration of the last one.
+ *
+ * @return CheckpointStats A copy of the figures.
+ */
+    CheckpointStats getCheckpointStats() const;
+
+    /**
+ * @brief Start folding the journal into a fresh snapshot on a background thread, then delete the folded records.
+ *
+ * @param bytesPerSecond The disk bandwidth the compaction may use, 0 for no limit.
+ * @return bool True if the compaction was started, false if a checkpoint or a compaction is still running or
+ * the journal is not open.
+ *
+ * @pre recover has been called.
+ *
+ * @post The registrations continue while the compaction runs, see getCompactionStats(). Once it has finished the
+ *       snapshot holds the live enrollments up to the rotation and the journal only the records written after it.
+ *
+ * @details Under the lock the journal is only rotated, see Journal::rotate. The thread then reads the previous
+ * snapshot and the segment, keeps one entry per live enrollment (a drop removes the registration it follows),
+ * writes the new snapshot and deletes the segment. Unlike a checkpoint it never looks at the courses, so it doesn't
+ * make them copy their rosters. Every block read or written goes through one RateLimiter, so the compaction
+ * doesn't take the disk away from the journal syncs. A segment left by an interrupted compaction is folded first,
+ * without rotating. The journal also starts a compaction by itself every COMPACTION_INTERVAL_RECORDS records.
+ */
+    bool startCompaction(long long bytesPerSecond = COMPACTION_BYTES_PER_SECOND);
+
+    /**
+ * @brief Get the figures of the compactions, including the duration of the last one.
+ *
+ * @return CompactionStats A copy of the figures.
+ */
+    CompactionStats getCompactionStats() const;
+
+    // Report methods
+
+    /**
+ * @brief Pin a consistent version of the rosters for a report.
+ *
+ * @return RegistryView The rosters of every course at the current point of the registrations.
+ *
+ * @pre None.
+ *
+ * @post The registrations continue while the view is read, the view keeps showing the rosters as they were.
+ *
+ * @details The lock is held only to take one shared reference to the roster of every course, in the order of
+ * the course list. A course changed while the view is alive copies its roster once before the change, so the
+ * writers pay one copy per changed course instead of waiting for the report, see RegistryView.
+ */
+    RegistryView pinView() const;
+
+    // Export methods
+
+    /**
+ * @brief Write the students, the courses and the enrollments back to text files.
+ *
+ * @param directory The directory of the files, ending with a path separator.
+ * @param fileSuffix Added to the name of every file, eg: "-SUMMER" writes Course-SUMMER.txt for a term.
+ * @return bool True if every file was written.
+ *
+ * @pre None.
+ *
+ * @post The directory holds Student.txt and Course.txt in the format read at the start, Section.txt with the
+ *       sections of the courses that have more than one, and Enrollment.txt with one "ID CODE SECTION" line
+ *       per enrollment. Each file starts with its number of lines. A file that fails keeps its previous content.
+ *       The registry restores the enrollments from the snapshot and the journal (see recover), Enrollment.txt is
+ *       only read back when both are missing, see importEnrollments.
+ *
+ * @details The registrations are blocked while the text is written so the four files describe the same state.
+ * Each file is streamed through a BufferedTextFile, a large buffer written in blocks, and synced and renamed
+ * into place once the lock is released, so no registration waits for the disk.
+ */
+    bool exportText(const string &, const string &fileSuffix = "");
+
+    /**
+ * @brief Get the figures of the last recovery, including its duration.
+ *
+ * @return const RecoveryStats & The figures, all 0 before recover is called.
+ */
+    const RecoveryStats &getRecoveryStats() const;
+
+    /**
+ * @brief Wait until the journal records of a registration made with a pendingSequence are durable.
+ *
+ * @param sequence The pendingSequence set by addCourse, dropCourse or registerBundle.
+ * @return bool True if the records are durable or there were none, false if writing the journal failed.
+ *
+ * @pre None.
+ *
+ * @post As Journal::waitDurable, this thread may write and sync the group of every registration waiting.
+ */
+    bool waitDurable(unsigned long long);
+
+    /**
+ * @brief Count the seats of the courses with a coordinator shared with other registries.
+ *
+ * @param coordinator Asked for the seats of every registration and given back the seats of every drop,
+ *                    nullptr to count the seats of this registry only.
+ *
+ * @pre Called before the registrations start, the coordinator outlives the registry or is replaced.
+ *
+ * @post A registration refused by the coordinator fails with COURSE_FULL, an accepted one enrolls the student in
+ *       the sections it chose. The recovery never asks it: the coordinator learns the enrollments recovered from
+ *       the registries themselves.
+ */
+    void setSeatCoordinator(SeatCoordinator *);
+
+    /**
+ * @brief Find the students matching a filter, from the QueryIndex.
+ *
+ * @param filter The bounds of the GPA and the credits and the registration of the students.
+ * @return QueryResult The IDs of the students, sorted, with the plan chosen and the rows read.
+ *
+ * @pre None.
+ *
+ * @post None, the registrations wait for the query, which reads no list.
+ */
+    QueryResult findStudents(const StudentFilter &) const;
+
+    /**
+ * @brief Find the courses matching a filter, from the QueryIndex.
+ *
+ * @param filter The prefix of the code and the bounds of the credits and the seats left.
+ * @return QueryResult The codes of the courses, sorted, with the plan chosen and the rows read.
+ *
+ * @pre None.
+ *
+ * @post None.
+ */
+    QueryResult findCourses(const CourseFilter &) const;
+
+private:
+    // findStudent / findCourse without the lock, the caller holds it
+    Student *lookupStudent(const string &) const;
+    Course *lookupCourse(const string &) const;
+
+    // Validate and reserve the seats of a bundle, the caller holds the lock
+    RegistrationResult reserveBundle(Student *, const vector<string> &, string &);
+
+    // Move students from one list to the other, deleting the old nodes in one pass over the first list
+    void settleMoves(const vector<Student *> &, LListWithDummyNode<Student> &, LListWithDummyNode<Student> &);
+
+    // Enroll / unenroll without any check, the caller holds the lock
+    bool enroll(Student *, Course *, int sectionNumber = AUTO_SECTION);
+    bool unenroll(Student *, Course *);
+
+    // Flag the last journal record of the operation in progress as its end
+    void endJournalOperation();
+
+    // End the operation, append its records to the journal, release the lock and wait for them to be durable,
+    // or only give their sequence when the caller waits later; false if the journal refused or lost them
+    bool commitJournal(unique_lock<shared_mutex> &, unsigned long long * = nullptr);
+
+    // Run a function on a number of threads, the current one included, and wait for all of them
+    static void runOnThreads(int, const function<void(int)> &);
+
+    // A consistent view of the enrollments: the rosters of the courses at a journal sequence number
+    struct CheckpointView {
+        unsigned long long sequence = 0;
+        vector<pair<string, shared_ptr<const Roster>>> rosters; // course code -> roster
+        chrono::steady_clock::time_point capturedAt;
+        double pauseMicroseconds = 0;
+    };
+
+    // Capture the view of a checkpoint, the caller holds the lock
+    CheckpointView captureCheckpoint() const;
+
+    // Wait for the journal records of a captured view to be durable, then write the view to the snapshot file and
+    // update the figures of the checkpoints
+    bool writeCheckpoint(const CheckpointView &, const string &);
+
+    // Start a background checkpoint of a captured view, the caller holds the lock
+    bool launchCheckpoint(CheckpointView, const string &);
+
+    // Rotate the journal and start folding the segment into the snapshot, the caller holds the lock
+    bool launchCompaction(long long);
+
+    // Fold a journal segment into the snapshot file, delete it and update the figures of the compactions
+    bool compactJournal(const string &, long long, chrono::steady_clock::time_point);
+
+    // Move a student between the two lists and return the address of the moved copy
+    Student *moveStudent(Student *, LListWithDummyNode<Student> &, LListWithDummyNode<Student> &);
+
+    // Copy the fields of a student and of a course into the query index, the caller holds the lock
+    void indexStudent(Student &);
+    void indexCourse(const Course &);
+
+    // Index every student and every course again, the caller holds the lock
+    void rebuildQueryIndex();
+
+    LListWithDummyNode<Student> &unregistered;
+    LListWithDummyNode<Student> &registered;
+    DoublyLinkedList<Course> &courseList;
+
+    unordered_map<string, Student *> studentIndex; // student id -> student in one of the two lists
+    unordered_map<string, Course *> courseIndex;   // course code -> course in courseList
+    PrerequisiteGraph prerequisites;               // prerequisites of the catalog with their closure
+    Journal journal;                               // write-ahead journal of the enrollments
+    vector<JournalRecord> journalRecords;          // records of the operations not appended to the journal yet
+    RecoveryStats recoveryStats;                   // figures of the last recovery
+    string snapshotPath;                           // snapshot of the recovery, where the periodic checkpoints go
+    string journalPath;                            // journal of the recovery, its segment is journalPath + JOURNAL_SEGMENT_SUFFIX
+    unsigned long long checkpointSequence;         // journal sequence of the last captured checkpoint
+    unsigned long long compactionSequence;         // journal sequence of the last started compaction
+    SeatCoordinator *seatCoordinator;              // nullptr when the seats are only counted by the courses
+    QueryIndex queryIndex;                         // the fields of the filter queries, by column
+
+    thread checkpointThread;                       // writes the background checkpoint or compaction
+    atomic<bool> checkpointRunning;                // a checkpoint or a compaction owns the snapshot file
+    CheckpointStats checkpointStats;
+    CompactionStats compactionStats;
+    mutable mutex checkpointMutex;                 // protects checkpointStats, compactionStats and checkpointThread
+
+    mutable shared_mutex registryMutex; // exclusive for every mutation, shared by the lookups and the queries
+
+};
+
+/**
+ * @brief Get the message shown to the user for a registration result.
+ *
+ * @param result The result returned by one of the registration methods.
+ * @return string A sentence describing the result.
+ *
+ * @pre None.
+ *
+ * @post None.
+ */
+string resultMessage(RegistrationResult);
+
+/**
+ * @brief Get the name of a registration result, for the answers read by programs.
+ *
+ * @param result The result returned by one of the registration methods.
+ * @return string The name of the enumerator, eg: COURSE_FULL.
+ *
+ * @pre None.
+ *
+ * @post None.
+ */
+string resultName(RegistrationResult);
+
+/**
+ * @brief Check that the enrollments survive a crash in the middle of a group commit and the recoveries after it.
+ *
+ * @param path The start of the paths of a scratch snapshot and journal, they are deleted at the end.
+ * @param out The output stream of the results.
+ * @return bool True if every recovery found the enrollments expected.
+ *
+ * @pre The directory of the path is writable.
+ *
+ * @post One line per case is written to out with the enrollments found and expected.
+ *
+ * @details A child process registers a student durably, appends a second one, saves a snapshot, appends a third
+ * one and exits without syncing, as a crash in the middle of a group would. The registry is then recovered,
+ * registers a fourth student and is recovered again: the second student is in the journal since the snapshot
+ * waited for it, and the fourth one follows it without a gap. The second case recovers from a snapshot ahead of
+ * the journal file, registers a student and recovers again, the journal file must have been emptied first.
+ */
+bool checkCrashRecovery(const string &, ostream &);
+
+#endif //DSPROJ_REGISTRY_H
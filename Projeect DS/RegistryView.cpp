@@ -0,0 +1,111 @@
+#include "RegistryView.h"
+#include <sstream>
+
+using namespace std;
+
+
+// Display one course with its registered students and the load of its sections
+static void displayCourseRoster(const CourseVersion &course, ostream &out) {
+    out << course.courseCode << " - " << course.courseTitle << endl;
+
+    const Roster &roster = *course.roster;
+    if (roster.registeredStudents.empty())
+        out << "No student is registered yet in this course." << endl;
+    for (auto itr = roster.registeredStudents.begin(); itr != roster.registeredStudents.end(); ++itr) {
+        out << itr->first << ' ' << itr->second;
+        if (course.sections.size() > 1) {
+            auto section = roster.studentSections.find(itr->first);
+            out << " (section " << (section == roster.studentSections.end() ? AUTO_SECTION : section->second) << ")";
+        }
+        out << endl;
+    }
+
+    // the load of the sections is counted from the pinned roster, the live counters may be ahead of it
+    if (course.sections.size() > 1) {
+        map<int, int> enrolled;
+        for (auto itr = roster.studentSections.begin(); itr != roster.studentSections.end(); ++itr)
+            enrolled[itr->second]++;
+
+        out << endl;
+        for (const pair<int, int> &section: course.sections)
+            out << "Section " << section.first << ": " << enrolled[section.first] << '/' << section.second << endl;
+    }
+
+    out << endl << endl << endl;
+}
+
+
+RegistryView::RegistryView() {
+    sequence = 0;
+}
+
+
+unsigned long long RegistryView::getSequence() const {
+    return sequence;
+}
+
+
+int RegistryView::getNumberOfCourses() const {
+    return courses.size();
+}
+
+
+unsigned long long RegistryView::getNumberOfEnrollments() const {
+    unsigned long long enrollments = 0;
+    for (const CourseVersion &course: courses)
+        enrollments += course.roster->registeredStudents.size();
+    return enrollments;
+}
+
+
+const vector<CourseVersion> &RegistryView::getCourses() const {
+    return courses;
+}
+
+
+map<string, StudentVersion> RegistryView::getStudentCourses() const {
+    map<string, StudentVersion> students;
+    for (const CourseVersion &course: courses) {
+        const map<string, string> &registeredStudents = course.roster->registeredStudents;
+        for (auto itr = registeredStudents.begin(); itr != registeredStudents.end(); ++itr) {
+            StudentVersion &student = students[itr->first];
+            student.fullName = itr->second;
+            student.courseCodes.push_back(course.courseCode);
+        }
+    }
+    return students;
+}
+
+
+void RegistryView::displayCourseRosters(ostream &out, WorkStealingPool *pool) const {
+    if (pool == nullptr || pool->getNumberOfThreads() == 1) {
+        for (const CourseVersion &course: courses)
+            displayCourseRoster(course, out);
+        return;
+    }
+
+    // every course is written to its own text on any thread, the texts are then written in the order of the list
+    vector<string> texts(courses.size());
+    pool->parallelFor(courses.size(), 1, [this, &texts](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; i++) {
+            ostringstream text;
+            displayCourseRoster(courses[i], text);
+            texts[i] = text.str();
+        }
+    });
+    for (const string &text: texts)
+        out << text;
+    out.flush();
+}
+
+
+int RegistryView::displayStudentCourses(ostream &out) const {
+    map<string, StudentVersion> students = getStudentCourses();
+    for (auto itr = students.begin(); itr != students.end(); ++itr) {
+        out << "Student " << itr->first << " - " << itr->second.fullName << "\nCourses:\n\n";
+        for (const string &courseCode: itr->second.courseCodes)
+            out << "-  " << courseCode << endl;
+        out << endl << endl;
+    }
+    return students.size();
+}
@@ -0,0 +1,147 @@
+/**
+
+    @file RegistryView.h
+    @brief Declaration of the RegistryView class and its member functions.
+
+    This file contains the declaration of the RegistryView class, a pinned version of the enrollments of the
+    registry that reports can read while registrations continue.
+
+    date 18 Oct 2026
+
+    A report walking every course or every registered student takes far longer than a registration. Holding the
+    registry lock for the whole walk would block every writer, and walking without it would mix rosters from
+    before and after a registration. A view is pinned by Registry::pinView: under the lock it takes one shared
+    reference to the roster of every course (Course::shareRoster), which is a version of the roster that never
+    changes, since a course copies its roster before changing one that is shared. The report then reads the view
+    without any lock and every roster belongs to the same point of the registrations.
+
+    The course list of each student is not versioned separately: every enrollment is in exactly one roster, so the
+    courses of the students are rebuilt from the pinned rosters, and they always agree with them.
+
+    Since a view never changes, the rosters can be written by several threads at once: given a WorkStealingPool,
+    displayCourseRosters writes the text of each course on any core and only puts the texts in order on the caller.
+
+    Public Member Functions:
+        1. RegistryView()
+        2. getSequence() const: unsigned long long
+        3. getNumberOfCourses() const: int
+        4. getNumberOfEnrollments() const: unsigned long long
+        5. getStudentCourses() const: map<string, StudentVersion>
+        6. displayCourseRosters(ostream &, WorkStealingPool *) const: void
+        7. displayStudentCourses(ostream &) const: int
+        8. getCourses() const: const vector<CourseVersion> &
+*/
+
+#ifndef DSPROJ_REGISTRYVIEW_H
+#define DSPROJ_REGISTRYVIEW_H
+
+#include "Course.h"
+#include "WorkStealingPool.h"
+
+#include <string>
+#include <vector>
+#include <map>
+#include <memory>
+#include <iostream>
+
+using namespace std;
+
+// a course as it was when the view was pinned
+struct CourseVersion {
+    string courseCode;
+    string courseTitle;
+    int numberOfCredits = 0;
+    vector<pair<int, int>> sections;  // section number -> capacity, in the order of the course
+    shared_ptr<const Roster> roster;  // never changes, the course copies it before its next change
+};
+
+// the courses of a student rebuilt from the rosters of a view
+struct StudentVersion {
+    string fullName;
+    vector<string> courseCodes;       // in the order of the courses of the view
+};
+
+class RegistryView {
+public:
+
+    /**
+ * @brief Constructor for the RegistryView class.
+ *
+ * @pre None.
+ *
+ * @post The view is empty, a filled view is returned by Registry::pinView.
+ */
+    RegistryView();
+
+    /**
+ * @brief Get the point of the registrations the view was pinned at.
+ *
+ * @return unsigned long long The sequence number of the last journal record included, 0 if the journal is closed.
+ */
+    unsigned long long getSequence() const;
+
+    /**
+ * @brief Get the number of courses of the view.
+ *
+ * @return int The number of offered courses when the view was pinned.
+ */
+    int getNumberOfCourses() const;
+
+    /**
+ * @brief Get the number of enrollments of the view.
+ *
+ * @return unsigned long long The sum of the sizes of the pinned rosters.
+ */
+    unsigned long long getNumberOfEnrollments() const;
+
+    /**
+ * @brief Rebuild the course list of every registered student from the pinned rosters.
+ *
+ * @return map<string, StudentVersion> Student ID -> name and courses, only students with at least one course.
+ *
+ * @pre None.
+ *
+ * @post None, the view is not modified.
+ */
+    map<string, StudentVersion> getStudentCourses() const;
+
+    /**
+ * @brief Display every course of the view with its registered students.
+ *
+ * @param out The output stream.
+ * @param pool Writes the texts of the courses on its threads when not null, the caller writes them all otherwise.
+ *
+ * @pre None.
+ *
+ * @post Same text as Course::displayRegisteredStudents for every course, in the order of the course list.
+ */
+    void displayCourseRosters(ostream &, WorkStealingPool * = nullptr) const;
+
+    /**
+ * @brief Display every registered student of the view with their courses.
+ *
+ * @param out The output stream.
+ * @return int The number of students displayed.
+ *
+ * @pre None.
+ *
+ * @post Same text as Student::displayRegisteredCourse for every registered student, ordered by student ID.
+ */
+    int displayStudentCourses(ostream &) const;
+
+    /**
+ * @brief Get the courses of the view.
+ *
+ * @return const vector<CourseVersion> & The courses with their pinned rosters, in the order of the course list.
+ */
+    const vector<CourseVersion> &getCourses() const;
+
+private:
+    friend class Registry; // fills the view under its lock
+
+    unsigned long long sequence;
+    vector<CourseVersion> courses;
+
+};
+
+#endif //DSPROJ_REGISTRYVIEW_H
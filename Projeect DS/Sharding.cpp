@@ -0,0 +1,369 @@
+#include "Sharding.h"
+#include <cerrno>
+#include <csignal>
+#include <cstring>
+#include <sstream>
+#include <poll.h>
+#include <unistd.h>
+#include <sys/signalfd.h>
+#include <sys/socket.h>
+#include <sys/wait.h>
+
+using namespace std;
+
+
+// Split a message in words
+static vector<string> splitMessage(const string &message) {
+    vector<string> words;
+    string word;
+    istringstream stream(message);
+    while (stream >> word)
+        words.push_back(word);
+    return words;
+}
+
+
+// Send one message on a SOCK_SEQPACKET socket, whole or not at all
+static bool sendMessage(int descriptor, const string &message) {
+    return ::send(descriptor, message.data(), message.length(), MSG_NOSIGNAL) == (ssize_t) message.length();
+}
+
+
+// Receive one message; false when the other side closed the socket
+static bool receiveMessage(int descriptor, string &message) {
+    message.resize(SHARD_MESSAGE_LIMIT);
+    ssize_t length;
+    do {
+        length = recv(descriptor, &message[0], message.length(), 0);
+    } while (length < 0 && errno == EINTR);
+    if (length <= 0)
+        return false;
+    message.resize(length);
+    return true;
+}
+
+
+CapacityCoordinator::CapacityCoordinator() {
+}
+
+
+CapacityCoordinator::~CapacityCoordinator() {
+    for (int descriptor: descriptors)
+        if (descriptor != -1)
+            close(descriptor);
+}
+
+
+bool CapacityCoordinator::forkShards(int numberOfShards, int &shard, int &descriptor) {
+    shard = -1;
+    descriptor = -1;
+    if (numberOfShards < 1 || numberOfShards > MAX_SHARDS) {
+        cerr << "The number of shards must be between 1 and " << MAX_SHARDS << "." << endl;
+        return false;
+    }
+
+    for (int i = 0; i < numberOfShards; i++) {
+        int pair[2];
+        pid_t process = -1;
+        if (socketpair(AF_UNIX, SOCK_SEQPACKET | SOCK_CLOEXEC, 0, pair) == 0) {
+            process = fork();
+            if (process == -1) {
+                close(pair[0]);
+                close(pair[1]);
+            }
+        }
+
+        // the shards already started are stopped, nothing would count their seats
+        if (process == -1) {
+            cerr << "Shard " << i << " can't be started." << endl;
+            stopShards(SIGTERM);
+            for (pid_t started: processes)
+                waitpid(started, nullptr, 0);
+            return false;
+        }
+
+        if (process == 0) {
+            // the shard only keeps its own socket, the ones of the shards before it belong to the coordinator
+            close(pair[0]);
+            for (int other: descriptors)
+                close(other);
+            descriptors.clear();
+            processes.clear();
+            shard = i;
+            descriptor = pair[1];
+            return true;
+        }
+
+        close(pair[1]);
+        descriptors.push_back(pair[0]);
+        processes.push_back(process);
+        ready.push_back(false);
+    }
+
+    stats.shards = numberOfShards;
+    return true;
+}
+
+
+void CapacityCoordinator::run(ostream &report) {
+    // SIGINT and SIGTERM are read from a descriptor and passed on to the shards, which stop their servers cleanly
+    sigset_t signals;
+    sigemptyset(&signals);
+    sigaddset(&signals, SIGINT);
+    sigaddset(&signals, SIGTERM);
+    pthread_sigmask(SIG_BLOCK, &signals, nullptr);
+    int signalDescriptor = signalfd(-1, &signals, SFD_CLOEXEC);
+
+    bool started = false;    // every shard reported its seats and was let serve
+    string message, reply;
+    while (true) {
+        vector<pollfd> watched;
+        vector<int> shardOfWatched;
+        for (size_t i = 0; i < descriptors.size(); i++)
+            if (descriptors[i] != -1) {
+                watched.push_back(pollfd{descriptors[i], POLLIN, 0});
+                shardOfWatched.push_back(i);
+            }
+        if (watched.empty())
+            break;
+        watched.push_back(pollfd{signalDescriptor, POLLIN, 0});
+
+        if (poll(watched.data(), watched.size(), -1) < 0) {
+            if (errno == EINTR)
+                continue;
+            cerr << "The coordinator stopped waiting for the shards: " << strerror(errno) << endl;
+            stopShards(SIGTERM);
+            break;
+        }
+
+        if (watched.back().revents != 0) {
+            signalfd_siginfo signal;
+            if (read(signalDescriptor, &signal, sizeof(signal)) > 0)
+                stopShards(signal.ssi_signo);
+        }
+
+        for (size_t w = 0; w + 1 < watched.size(); w++) {
+            if (watched[w].revents == 0)
+                continue;
+            int shard = shardOfWatched[w];
+            if (!receiveMessage(descriptors[shard], message)) {
+                close(descriptors[shard]);
+                descriptors[shard] = -1;
+                int status;
+                waitpid(processes[shard], &status, 0);
+                report << "Shard " << shard << " stopped." << endl;
+                continue;
+            }
+
+            answer(shard, message, reply);
+            if (!reply.empty())
+                sendMessage(descriptors[shard], reply);
+        }
+
+        // the shards serve once all the live ones counted their seats, a shard which stopped meanwhile isn't waited for
+        if (!started) {
+            bool allReady = true;
+            for (size_t i = 0; i < descriptors.size(); i++)
+                allReady = allReady && (descriptors[i] == -1 || ready[i]);
+            if (allReady) {
+                started = true;
+                for (int descriptor: descriptors)
+                    if (descriptor != -1)
+                        sendMessage(descriptor, "GO");
+                report << "The seats of " << stats.courses << " courses are counted for " << stats.shards
+                       << " shards." << endl;
+            }
+        }
+    }
+
+    close(signalDescriptor);
+}
+
+
+const CoordinatorStats &CapacityCoordinator::getStats() const {
+    return stats;
+}
+
+
+void CapacityCoordinator::answer(int shard, const string &message, string &reply) {
+    reply.clear();
+    vector<string> words = splitMessage(message);
+    if (words.empty())
+        return;
+
+    // SEATS <term> <course> <section> <capacity> <enrolled>: the enrollments a shard recovered in a section
+    if (words[0] == "SEATS" && words.size() == 6) {
+        vector<SectionSeats> &sections = seats[words[1] + ' ' + words[2]];
+        if (sections.empty())
+            stats.courses++;
+        int number = stoi(words[3]);
+        size_t index = 0;
+        while (index < sections.size() && sections[index].number != number)
+            index++;
+        if (index == sections.size())
+            sections.push_back(SectionSeats{number, stoi(words[4]), 0});
+        sections[index].enrolled += stoi(words[5]);
+        return;
+    }
+
+    if (words[0] == "READY") {
+        ready[shard] = true;
+        return;
+    }
+
+    // TAKE <term> <course>...: every seat or none, in the least loaded section of each course like
+    // Course::registerStudent, answered OK <section>... or FULL <course>
+    if (words[0] == "TAKE" && words.size() >= 2) {
+        // enrolled / capacity compared without dividing, the lowest section number breaks the ties
+        auto lessLoaded = [](const SectionSeats &first, const SectionSeats &second) {
+            long long firstLoad = (long long) first.enrolled * second.capacity;
+            long long secondLoad = (long long) second.enrolled * first.capacity;
+            return firstLoad != secondLoad ? firstLoad < secondLoad : first.number < second.number;
+        };
+
+        vector<SectionSeats *> chosen;
+        for (size_t i = 2; i < words.size(); i++) {
+            SectionSeats *least = nullptr;
+            auto itr = seats.find(words[1] + ' ' + words[i]);
+            if (itr != seats.end())
+                for (SectionSeats &section: itr->second)
+                    if (section.enrolled < section.capacity && (least == nullptr || lessLoaded(section, *least)))
+                        least = &section;
+            if (least == nullptr) {
+                reply = "FULL " + words[i];
+                stats.refused++;
+                return;
+            }
+            chosen.push_back(least);
+        }
+        reply = "OK";
+        for (SectionSeats *section: chosen) {
+            section->enrolled++;
+            reply += " " + to_string(section->number);
+        }
+        stats.taken += chosen.size();
+        return;
+    }
+
+    // RELEASE <term> <course> <section>...: no answer, the shard doesn't wait
+    if (words[0] == "RELEASE" && words.size() % 2 == 0) {
+        for (size_t i = 2; i + 1 < words.size(); i += 2) {
+            auto itr = seats.find(words[1] + ' ' + words[i]);
+            if (itr == seats.end())
+                continue;
+            int number = stoi(words[i + 1]);
+            for (SectionSeats &section: itr->second)
+                if (section.number == number && section.enrolled > 0)
+                    section.enrolled--;
+        }
+        stats.released += (words.size() - 2) / 2;
+        return;
+    }
+
+    cerr << "Shard " << shard << " sent an unknown message: " << message << endl;
+}
+
+
+void CapacityCoordinator::stopShards(int signal) {
+    for (size_t i = 0; i < processes.size(); i++)
+        if (descriptors[i] != -1)
+            kill(processes[i], signal);
+}
+
+
+ShardLink::ShardLink(int descriptor) : descriptor(descriptor) {
+}
+
+
+ShardLink::~ShardLink() {
+    if (descriptor != -1)
+        close(descriptor);
+}
+
+
+bool ShardLink::reportSeats(TermDirectory &terms) {
+    bool sent = true;
+    terms.forEach([this, &sent](Term &term) {
+        term.courses.forEach([this, &sent, &term](Course &course) {
+            for (const Section &section: course.getSections())
+                sent = sent && sendMessage(descriptor, "SEATS " + term.name + " " + course.getCourseCode() + " " +
+                                                       to_string(section.number) + " " +
+                                                       to_string(section.capacity) + " " +
+                                                       to_string(section.enrolled));
+        });
+    });
+
+    string reply;
+    if (!sent || !request("READY", reply) || reply != "GO") {
+        cerr << "The coordinator of the shards can't be reached." << endl;
+        return false;
+    }
+    return true;
+}
+
+
+bool ShardLink::request(const string &message, string &reply) {
+    lock_guard<mutex> lock(linkMutex);
+    return sendMessage(descriptor, message) && receiveMessage(descriptor, reply);
+}
+
+
+void ShardLink::send(const string &message) {
+    lock_guard<mutex> lock(linkMutex);
+    if (!sendMessage(descriptor, message))
+        cerr << "The coordinator of the shards can't be reached." << endl;
+}
+
+
+ShardSeats::ShardSeats(ShardLink &link, const string &termName) : link(link), termName(termName) {
+}
+
+
+bool ShardSeats::takeSeats(const vector<string> &courseCodes, vector<int> &sectionNumbers, string &fullCourse) {
+    string message = "TAKE " + termName;
+    for (const string &code: courseCodes)
+        message += " " + code;
+
+    // without the coordinator no seat can be counted, the registration is refused
+    string reply;
+    if (!link.request(message, reply)) {
+        fullCourse = courseCodes.empty() ? "" : courseCodes[0];
+        return false;
+    }
+    if (reply.compare(0, 5, "FULL ") == 0) {
+        fullCourse = reply.substr(5);
+        return false;
+    }
+
+    vector<string> words = splitMessage(reply);
+    sectionNumbers.assign(courseCodes.size(), AUTO_SECTION);
+    for (size_t i = 0; i < courseCodes.size() && i + 1 < words.size(); i++)
+        sectionNumbers[i] = stoi(words[i + 1]);
+    return true;
+}
+
+
+void ShardSeats::releaseSeats(const vector<string> &courseCodes, const vector<int> &sectionNumbers) {
+    string message = "RELEASE " + termName;
+    for (size_t i = 0; i < courseCodes.size(); i++)
+        message += " " + courseCodes[i] + " " + to_string(sectionNumbers[i]);
+    link.send(message);
+}
+
+
+int shardOf(const string &studentId, int numberOfShards) {
+    // FNV-1a: unlike hash<string>, the same in every build, so a student stays in its shard between runs
+    unsigned int hash = 2166136261u;
+    for (char character: studentId) {
+        hash ^= (unsigned char) character;
+        hash *= 16777619u;
+    }
+    return numberOfShards <= 1 ? 0 : hash % numberOfShards;
+}
+
+
+string shardAddress(const string &address, int shard) {
+    if (!address.empty() && address.find_first_not_of("0123456789") == string::npos)
+        return to_string(stoi(address) + shard);
+    return address + "." + to_string(shard);
+}
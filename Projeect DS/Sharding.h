@@ -0,0 +1,288 @@
+/**
+
+    @file Sharding.h
+    @brief Declaration of the classes splitting the students over several local processes.
+
+    This file contains the declaration of the CapacityCoordinator class, which starts the shards and counts the
+    seats of every section for all of them, and of the ShardLink and ShardSeats classes, with which a shard asks
+    the coordinator for seats.
+
+    date 18 Oct 2026
+
+    A single process holds every student and makes every registration on one thread. In the sharded mode
+    (--shards <count> <address>) the coordinator forks one process per shard; a shard keeps only the students
+    whose ID hashes to it (shardOf), recovers its own journal and snapshot and serves them on its own address
+    (shardAddress) with a RegistrationServer. A client sends the commands of a student to its shard, any shard
+    answers SHARD <student> with the right one, and a shard answers ERR WRONG_SHARD <shard> to a command about a
+    student of another one.
+
+    Every shard offers all the courses, so a section has students in several shards and only the coordinator knows
+    how many seats are left. The registry of a shard checks everything it knows (prerequisites, credits, times,
+    the students of the course in the shard), then takes the seats of the registration from the coordinator through
+    its ShardSeats, all or none, before enrolling; the coordinator chooses the section of every seat, the least
+    loaded of all the shards, and the shard enrolls the student in it. A drop gives the seat of its section back.
+    The coordinator is a single thread answering the shards over a SOCK_SEQPACKET socket pair each, so the seats of
+    a section are never given twice.
+
+    At the start each shard reports the capacity of its sections and its recovered enrollments, and the coordinator
+    only lets the shards serve once all of them reported, so the seats are counted from the enrollments of every
+    shard. The capacities are those of the start: a shard refuses the new courses and capacities of a reload, see
+    Registry::reloadCourses.
+
+    Public Member Functions:
+        CapacityCoordinator:
+        1. CapacityCoordinator()
+        2. ~CapacityCoordinator()
+        3. forkShards(int, int &, int &): bool
+        4. run(ostream &): void
+        5. getStats() const: const CoordinatorStats &
+
+        ShardLink:
+        1. ShardLink(int)
+        2. ~ShardLink()
+        3. reportSeats(TermDirectory &): bool
+        4. request(const string &, string &): bool
+        5. send(const string &): void
+
+        ShardSeats:
+        1. ShardSeats(ShardLink &, const string &)
+        2. takeSeats(const vector<string> &, string &): bool
+        3. releaseSeats(const vector<string> &): void
+
+    Free Functions:
+        1. shardOf(const string &, int): int
+        2. shardAddress(const string &, int): string
+*/
+
+#ifndef DSPROJ_SHARDING_H
+#define DSPROJ_SHARDING_H
+
+#include "TermDirectory.h"
+#include "Registry.h"
+
+#include <string>
+#include <vector>
+#include <map>
+#include <mutex>
+#include <iostream>
+#include <sys/types.h>
+
+using namespace std;
+
+// most shards started by the coordinator
+const int MAX_SHARDS = 64;
+
+// longest message between a shard and the coordinator, a message is a line of words
+const size_t SHARD_MESSAGE_LIMIT = 64 * 1024;
+
+// what the coordinator did since it started
+struct CoordinatorStats {
+    int shards = 0;                         // shards started
+    unsigned long long courses = 0;         // courses counted, of every term, with all their sections
+    unsigned long long taken = 0;           // seats taken
+    unsigned long long refused = 0;         // registrations refused for lack of a seat
+    unsigned long long released = 0;        // seats given back
+};
+
+class CapacityCoordinator {
+public:
+
+    /**
+ * @brief Constructor for the CapacityCoordinator class.
+ *
+ * @pre None.
+ *
+ * @post No shard is started.
+ */
+    CapacityCoordinator();
+
+    /**
+ * @brief Destructor for the CapacityCoordinator class.
+ *
+ * @pre None.
+ *
+ * @post The sockets of the shards are closed.
+ */
+    ~CapacityCoordinator();
+
+    CapacityCoordinator(const CapacityCoordinator &) = delete;
+    CapacityCoordinator &operator=(const CapacityCoordinator &) = delete;
+
+    /**
+ * @brief Fork one process per shard.
+ *
+ * @param numberOfShards The number of shards, from 1 to MAX_SHARDS.
+ * @param shard Set to the shard of the calling process: -1 in the coordinator, from 0 in a shard.
+ * @param descriptor In a shard, set to its socket to the coordinator, for a ShardLink.
+ * @return bool True in the coordinator once every shard is started, and in every shard.
+ *
+ * @pre Called before the data files are read, so each shard reads only what it keeps.
+ *
+ * @post On failure an error message is printed to the standard error stream (cerr) and the shards already
+ *       started are stopped.
+ */
+    bool forkShards(int, int &, int &);
+
+    /**
+ * @brief Count the seats of the shards until all of them stopped.
+ *
+ * @param report Receives a line when every shard reported its seats and when a shard stops.
+ *
+ * @pre forkShards returned true with shard -1.
+ *
+ * @post SIGINT and SIGTERM are passed on to the shards, which finish their registrations in flight, and every
+ *       shard was waited for. SIGINT and SIGTERM are blocked in the calling thread.
+ */
+    void run(ostream &);
+
+    /**
+ * @brief Get the counters of the coordinator.
+ *
+ * @return const CoordinatorStats & The counters since the shards started.
+ */
+    const CoordinatorStats &getStats() const;
+
+private:
+    // the seats of a section counted for all the shards
+    struct SectionSeats {
+        int number;
+        int capacity;
+        int enrolled;
+    };
+
+    // Answer a message of a shard into reply, left empty when the message has no answer
+    void answer(int, const string &, string &);
+
+    // Stop every shard still running
+    void stopShards(int);
+
+    vector<int> descriptors;            // socket of every shard, -1 once it stopped
+    vector<pid_t> processes;            // process of every shard
+    vector<bool> ready;                 // the shard reported its seats
+    map<string, vector<SectionSeats>> seats;    // term name + ' ' + course code -> seats of its sections
+    CoordinatorStats stats;
+
+};
+
+class ShardLink {
+public:
+
+    /**
+ * @brief Constructor for the ShardLink class.
+ *
+ * @param descriptor The socket to the coordinator given by forkShards.
+ *
+ * @pre None.
+ *
+ * @post The link owns the socket.
+ */
+    ShardLink(int);
+
+    /**
+ * @brief Destructor for the ShardLink class.
+ *
+ * @pre None.
+ *
+ * @post The socket is closed, the coordinator sees the shard stop.
+ */
+    ~ShardLink();
+
+    ShardLink(const ShardLink &) = delete;
+    ShardLink &operator=(const ShardLink &) = delete;
+
+    /**
+ * @brief Report the capacity and the enrollments of the courses of every term, and wait for the other shards.
+ *
+ * @param terms The terms of the shard, recovered.
+ * @return bool True once the coordinator counted the seats of every shard, false if it stopped.
+ *
+ * @pre No registration was made yet.
+ *
+ * @post On failure an error message is printed to the standard error stream (cerr).
+ */
+    bool reportSeats(TermDirectory &);
+
+    /**
+ * @brief Send a message to the coordinator and wait for its answer.
+ *
+ * @param message A line of words, eg: TAKE CURRENT CSIS200.
+ * @param reply Set to the answer of the coordinator.
+ * @return bool False if the coordinator can't be reached.
+ */
+    bool request(const string &, string &);
+
+    /**
+ * @brief Send a message to the coordinator which has no answer.
+ *
+ * @param message A line of words, eg: RELEASE CURRENT CSIS200 1.
+ */
+    void send(const string &);
+
+private:
+    int descriptor;
+    mutex linkMutex;    // the terms of a shard share the socket, a request and its answer are never split
+
+};
+
+class ShardSeats : public SeatCoordinator {
+public:
+
+    /**
+ * @brief Constructor for the ShardSeats class.
+ *
+ * @param link The link of the shard to the coordinator.
+ * @param termName The term whose seats are asked, eg: CURRENT.
+ *
+ * @pre The link outlives the object.
+ *
+ * @post The object can be given to Registry::setSeatCoordinator of the term.
+ */
+    ShardSeats(ShardLink &, const string &);
+
+    /**
+ * @brief Take one seat in every course from the coordinator, all or none.
+ *
+ * @param courseCodes The courses.
+ * @param sectionNumbers Set to the section of every seat, chosen by the coordinator.
+ * @param fullCourse Set to a course without a seat left when the seats are refused.
+ * @return bool True if the seats were taken.
+ *
+ * @details The request and its answer are a blocking round trip on the socket, made by the registry under its
+ * lock; in a shard it is the thread of the event loop of the RegistrationServer which waits, so every
+ * registration costs the loop one exchange with the coordinator.
+ */
+    bool takeSeats(const vector<string> &, vector<int> &, string &) override;
+
+    /**
+ * @brief Give back one seat in every course to the coordinator, without waiting for it.
+ *
+ * @param courseCodes The courses.
+ * @param sectionNumbers The section of every seat.
+ */
+    void releaseSeats(const vector<string> &, const vector<int> &) override;
+
+private:
+    ShardLink &link;
+    string termName;
+
+};
+
+/**
+ * @brief Get the shard of a student.
+ *
+ * @param studentId The ID of the student, in upper case.
+ * @param numberOfShards The number of shards.
+ * @return int The shard, from 0 to numberOfShards - 1, the same in every process and at every start.
+ */
+int shardOf(const string &, int);
+
+/**
+ * @brief Get the address a shard serves on.
+ *
+ * @param address The address given to --shards: a socket path or a TCP port.
+ * @param shard The shard.
+ * @return string The socket path followed by '.' and the shard, or the port plus the shard.
+ */
+string shardAddress(const string &, int);
+
+#endif //DSPROJ_SHARDING_H
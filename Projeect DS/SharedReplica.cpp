@@ -0,0 +1,337 @@
+#include "SharedReplica.h"
+#include <algorithm>
+#include <atomic>
+#include <cctype>
+#include <cstring>
+#include <iostream>
+#include <sstream>
+
+using namespace std;
+
+static_assert(sizeof(ReplicaStudent) % 8 == 0 && sizeof(ReplicaCourse) % 8 == 0,
+              "the records of a slot keep the alignment of the next ones");
+
+// slots start on a cache line, so a slot moved to the end of the segment never shares one with the other slot
+static const size_t REPLICA_ALIGNMENT = 64;
+
+
+// Atomic view of a field of the header, the header is shared with the other processes
+static atomic_ref<unsigned long long> field(const unsigned long long &value) {
+    return atomic_ref<unsigned long long>(const_cast<unsigned long long &>(value));
+}
+
+
+// Split a command in words and put them in upper case, as CommandProcessor does
+static vector<string> splitCommand(const string &line) {
+    vector<string> words;
+    string word;
+    istringstream stream(line);
+    while (stream >> word) {
+        for (char &character: word)
+            character = toupper((unsigned char) character);
+        words.push_back(word);
+    }
+    return words;
+}
+
+
+// Copy a key zero padded, a key too long is cut
+static void copyKey(char *destination, const string &key) {
+    memset(destination, 0, REPLICA_KEY_LENGTH);
+    memcpy(destination, key.data(), min(key.length(), REPLICA_KEY_LENGTH - 1));
+}
+
+
+// Read a key of a slot, it may be torn while the slot is written so it is never trusted to end with a zero
+static string readKey(const char *key) {
+    return string(key, strnlen(key, REPLICA_KEY_LENGTH));
+}
+
+
+ReplicaPublisher::ReplicaPublisher() {
+    publishedSequence = 0;
+    published = false;
+}
+
+
+bool ReplicaPublisher::open(const string &path) {
+    if (!segment.open(path, sizeof(ReplicaHeader)))
+        return false;
+
+    // a segment left by a previous writer keeps its version, so its readers see the next publication as newer
+    ReplicaHeader *header = (ReplicaHeader *) segment.getBase();
+    if (memcmp(header->magic, REPLICA_MAGIC, sizeof(header->magic)) != 0) {
+        memset(header, 0, sizeof(ReplicaHeader));
+        memcpy(header->magic, REPLICA_MAGIC, sizeof(header->magic));
+    }
+    if (field(header->version).load() % 2 != 0)
+        field(header->version).fetch_add(1);   // the previous writer stopped during a switch
+    return true;
+}
+
+
+bool ReplicaPublisher::publish(const Term &term) {
+    vector<char> bytes;
+    encodeTerm(term, bytes);
+
+    ReplicaHeader *header = (ReplicaHeader *) segment.getBase();
+    int slot = 1 - (int) field(header->active).load();
+
+    // a slot too small is moved to the end of the segment with room to grow, the readers may still read its old place
+    if (bytes.size() > field(header->slotCapacity[slot]).load()) {
+        size_t offset = (segment.getLength() + REPLICA_ALIGNMENT - 1) / REPLICA_ALIGNMENT * REPLICA_ALIGNMENT;
+        size_t capacity = bytes.size() * 2;
+        if (!segment.resize(offset + capacity)) {
+            cerr << "The replica can't be grown, the readers keep the previous version." << endl;
+            return false;
+        }
+        header = (ReplicaHeader *) segment.getBase();
+        field(header->slotOffset[slot]).store(offset);
+        field(header->slotCapacity[slot]).store(capacity);
+    }
+
+    // the readers don't read this slot, at worst a reader of the previous publication still does and will retry
+    memcpy(segment.getBase() + field(header->slotOffset[slot]).load(), bytes.data(), bytes.size());
+    field(header->slotLength[slot]).store(bytes.size());
+
+    unsigned long long version = field(header->version).load();
+    field(header->version).store(version + 1);
+    field(header->active).store(slot);
+    field(header->version).store(version + 2);
+
+    publishedSequence = term.registry->getJournal().getLastSequence();
+    published = true;
+    return true;
+}
+
+
+bool ReplicaPublisher::publishIfChanged(const Term &term) {
+    if (published && publishedSequence == term.registry->getJournal().getLastSequence())
+        return false;
+    return publish(term);
+}
+
+
+unsigned long long ReplicaPublisher::getVersion() const {
+    if (!segment.isOpen())
+        return 0;
+    return field(((const ReplicaHeader *) segment.getBase())->version).load();
+}
+
+
+void ReplicaPublisher::encodeTerm(const Term &term, vector<char> &bytes) {
+    vector<ReplicaStudent> students;
+    vector<ReplicaCourse> courses;
+    vector<string> keys;
+
+    // the course codes of every student first, then the student IDs of every roster
+    auto addStudent = [&students, &keys](Student &student) {
+        ReplicaStudent record;
+        memset(&record, 0, sizeof(record));
+        copyKey(record.studentId, student.getStudentId());
+        record.gpa = student.getGpa();
+        record.numberOfCredits = student.getNumberOfcredits();
+        record.firstCourse = keys.size();
+        record.numberOfCourses = student.getRegisteredCourse().size();
+        keys.insert(keys.end(), student.getRegisteredCourse().begin(), student.getRegisteredCourse().end());
+        students.push_back(record);
+    };
+    term.registered.forEach(addStudent);
+    term.unregistered.forEach(addStudent);
+
+    term.courses.forEach([&courses, &keys](Course &course) {
+        ReplicaCourse record;
+        memset(&record, 0, sizeof(record));
+        copyKey(record.courseCode, course.getCourseCode());
+        record.numberOfEnrolled = course.getNumberOfEnrolled();
+        record.capacity = course.getCapacity();
+        record.numberOfCredits = course.getNumberOfCredits();
+        record.firstStudent = keys.size();
+        record.numberOfStudents = course.getRegisteredStudents().size();
+        for (auto itr = course.getRegisteredStudents().begin(); itr != course.getRegisteredStudents().end(); ++itr)
+            keys.push_back(itr->first);
+        courses.push_back(record);
+    });
+
+    sort(students.begin(), students.end(), [](const ReplicaStudent &first, const ReplicaStudent &second) {
+        return strncmp(first.studentId, second.studentId, REPLICA_KEY_LENGTH) < 0;
+    });
+    sort(courses.begin(), courses.end(), [](const ReplicaCourse &first, const ReplicaCourse &second) {
+        return strncmp(first.courseCode, second.courseCode, REPLICA_KEY_LENGTH) < 0;
+    });
+
+    ReplicaSlotHeader slotHeader;
+    memset(&slotHeader, 0, sizeof(slotHeader));
+    slotHeader.numberOfStudents = students.size();
+    slotHeader.numberOfCourses = courses.size();
+    slotHeader.numberOfKeys = keys.size();
+
+    bytes.resize(sizeof(slotHeader) + students.size() * sizeof(ReplicaStudent) +
+                 courses.size() * sizeof(ReplicaCourse) + keys.size() * REPLICA_KEY_LENGTH);
+    char *position = bytes.data();
+    memcpy(position, &slotHeader, sizeof(slotHeader));
+    position += sizeof(slotHeader);
+    memcpy(position, students.data(), students.size() * sizeof(ReplicaStudent));
+    position += students.size() * sizeof(ReplicaStudent);
+    memcpy(position, courses.data(), courses.size() * sizeof(ReplicaCourse));
+    position += courses.size() * sizeof(ReplicaCourse);
+    for (const string &key: keys) {
+        copyKey(position, key);
+        position += REPLICA_KEY_LENGTH;
+    }
+}
+
+
+ReplicaReader::ReplicaReader() {
+    version = 0;
+    retries = 0;
+}
+
+
+bool ReplicaReader::open(const string &path) {
+    if (!segment.openReadOnly(path))
+        return false;
+
+    const ReplicaHeader *header = (const ReplicaHeader *) segment.getBase();
+    if (segment.getLength() < sizeof(ReplicaHeader) ||
+        memcmp(header->magic, REPLICA_MAGIC, sizeof(header->magic)) != 0 || field(header->version).load() == 0) {
+        cerr << "The replica " << path << " was never published." << endl;
+        return false;
+    }
+    return true;
+}
+
+
+bool ReplicaReader::answer(const string &line, string &response) {
+    response.clear();
+    vector<string> args = splitCommand(line);
+    if (args.empty() || args[0][0] == '#')
+        return false;
+
+    const string &command = args[0];
+    if (command == "PING")
+        response = "OK";
+    else if (command != "STUDENT" && command != "COURSE" && command != "ROSTER")
+        response = "ERR READ_ONLY " + command;
+    else if (args.size() != 2)
+        response = "ERR BAD_ARGUMENTS " + command + (command == "STUDENT" ? " <student>" : " <course>");
+    else
+        lookUp(command, args[1], response);
+    return true;
+}
+
+
+unsigned long long ReplicaReader::getVersion() const {
+    return version;
+}
+
+
+unsigned long long ReplicaReader::getRetries() const {
+    return retries;
+}
+
+
+void ReplicaReader::lookUp(const string &command, const string &key, string &response) {
+    while (true) {
+        const ReplicaHeader *header = (const ReplicaHeader *) segment.getBase();
+        unsigned long long before = field(header->version).load();
+        if (before % 2 != 0) {
+            retries++;   // the writer is switching the slots, it takes a few stores
+            continue;
+        }
+
+        int slot = field(header->active).load() != 0;
+        unsigned long long offset = field(header->slotOffset[slot]).load();
+        unsigned long long length = field(header->slotLength[slot]).load();
+
+        // the active slot was moved past the end of the mapping, the file was grown since
+        if (offset + length > segment.getLength()) {
+            if (!segment.remap()) {
+                response = "ERR REPLICA_UNAVAILABLE";
+                return;
+            }
+            continue;
+        }
+
+        bool consistent = answerFromSlot(segment.getBase() + offset, length, command, key, response);
+        atomic_thread_fence(memory_order_acquire);
+        if (field(header->version).load() == before && consistent) {
+            version = before;
+            return;
+        }
+        retries++;
+    }
+}
+
+
+bool ReplicaReader::answerFromSlot(const char *slot, unsigned long long length, const string &command,
+                                   const string &key, string &response) const {
+    ReplicaSlotHeader slotHeader;
+    if (length < sizeof(slotHeader))
+        return false;
+    memcpy(&slotHeader, slot, sizeof(slotHeader));
+
+    // every count is checked against the length, a slot being written may hold anything
+    unsigned long long studentsLength = (unsigned long long) slotHeader.numberOfStudents * sizeof(ReplicaStudent);
+    unsigned long long coursesLength = (unsigned long long) slotHeader.numberOfCourses * sizeof(ReplicaCourse);
+    unsigned long long keysLength = (unsigned long long) slotHeader.numberOfKeys * REPLICA_KEY_LENGTH;
+    if (sizeof(slotHeader) + studentsLength + coursesLength + keysLength != length)
+        return false;
+    const ReplicaStudent *students = (const ReplicaStudent *) (slot + sizeof(slotHeader));
+    const ReplicaCourse *courses = (const ReplicaCourse *) (slot + sizeof(slotHeader) + studentsLength);
+    const char *keys = slot + sizeof(slotHeader) + studentsLength + coursesLength;
+
+    char searched[REPLICA_KEY_LENGTH];
+    copyKey(searched, key);
+
+    if (command == "STUDENT") {
+        const ReplicaStudent *end = students + slotHeader.numberOfStudents;
+        const ReplicaStudent *student = lower_bound(students, end, searched,
+                                                    [](const ReplicaStudent &record, const char *value) {
+                                                        return strncmp(record.studentId, value,
+                                                                       REPLICA_KEY_LENGTH) < 0;
+                                                    });
+        if (student == end || strncmp(student->studentId, searched, REPLICA_KEY_LENGTH) != 0) {
+            response = "ERR " + resultName(STUDENT_NOT_FOUND);
+            return true;
+        }
+        if ((unsigned long long) student->firstCourse + student->numberOfCourses > slotHeader.numberOfKeys)
+            return false;
+
+        ostringstream answer;
+        answer << "OK " << readKey(student->studentId) << ' ' << student->gpa << ' ' << student->numberOfCredits;
+        for (unsigned int i = 0; i < student->numberOfCourses; i++)
+            answer << ' ' << readKey(keys + (student->firstCourse + i) * REPLICA_KEY_LENGTH);
+        response = answer.str();
+        return true;
+    }
+
+    const ReplicaCourse *end = courses + slotHeader.numberOfCourses;
+    const ReplicaCourse *course = lower_bound(courses, end, searched,
+                                              [](const ReplicaCourse &record, const char *value) {
+                                                  return strncmp(record.courseCode, value, REPLICA_KEY_LENGTH) < 0;
+                                              });
+    if (course == end || strncmp(course->courseCode, searched, REPLICA_KEY_LENGTH) != 0) {
+        response = "ERR " + resultName(COURSE_NOT_FOUND);
+        return true;
+    }
+
+    string code = readKey(course->courseCode);
+    if (command == "COURSE") {
+        response = "OK " + code + " " + to_string(course->numberOfEnrolled) + " " + to_string(course->capacity) +
+                   " " + to_string(course->numberOfCredits);
+        return true;
+    }
+
+    if ((unsigned long long) course->firstStudent + course->numberOfStudents > slotHeader.numberOfKeys)
+        return false;
+    response = "OK " + code + " " + to_string(course->numberOfStudents);
+    for (unsigned int i = 0; i < course->numberOfStudents; i++)
+        response += " " + readKey(keys + (course->firstStudent + i) * REPLICA_KEY_LENGTH);
+    return true;
+}
+
+
+string replicaPath(const string &fileSuffix) {
+    return REPLICA_PATH_PREFIX + fileSuffix;
+}
@@ -0,0 +1,242 @@
+/**
+
+    @file SharedReplica.h
+    @brief Declaration of the ReplicaPublisher and ReplicaReader classes and their member functions.
+
+    This file contains the declaration of the ReplicaPublisher class, which copies the students and the courses of a
+    term into a shared memory segment, and of the ReplicaReader class, which answers the lookups of the STUDENT,
+    COURSE and ROSTER commands from that segment in another process, without asking the writer anything.
+
+    date 18 Oct 2026
+
+    Most of the requests only read: the courses of a student (option 5) and the students of a course (option 6). A
+    reader process maps the segment of the term, a file of /dev/shm which lives in memory only, and finds the
+    answer with a binary search in it, so a lookup costs no system call and no round trip through the server.
+
+    The segment holds a ReplicaHeader and two slots. The publisher writes the whole term, sorted, into the slot the
+    readers don't use, then makes it the active one. The switch is guarded by a sequence lock: the version of the
+    header is odd while the active slot changes and grows by 2 at each publication. A reader notes the version,
+    reads the active slot and checks that the version didn't change meanwhile; if it did, the writer may have
+    started to write over the slot being read, and the lookup is read again. The writer never waits for the
+    readers, and a reader only reads again when two publications happened during its lookup.
+
+    A slot which outgrows its place is moved to the end of the segment, which is grown: the file never shrinks, so
+    the mapping of a reader stays valid and is only mapped again when the active slot is past its end.
+
+    The replica follows the registry: ReplicaPublisher::publishIfChanged copies the term again only when its
+    journal moved, eg: at most every REPLICA_PUBLISH_INTERVAL_MS in the loop of the server.
+
+    Public Member Functions:
+        ReplicaPublisher:
+        1. ReplicaPublisher()
+        2. open(const string &): bool
+        3. publish(const Term &): bool
+        4. publishIfChanged(const Term &): bool
+        5. getVersion() const: unsigned long long
+
+        ReplicaReader:
+        1. ReplicaReader()
+        2. open(const string &): bool
+        3. answer(const string &, string &): bool
+        4. getVersion() const: unsigned long long
+        5. getRetries() const: unsigned long long
+
+    Free Functions:
+        1. replicaPath(const string &): string
+*/
+
+#ifndef DSPROJ_SHAREDREPLICA_H
+#define DSPROJ_SHAREDREPLICA_H
+
+#include "TermDirectory.h"
+#include "MappedFile.h"
+
+#include <string>
+#include <vector>
+
+using namespace std;
+
+// the segment of a term is this path followed by the file suffix of the term, eg: DsProject-replica-SUMMER
+const string REPLICA_PATH_PREFIX = "/dev/shm/DsProject-replica";
+
+const char REPLICA_MAGIC[8] = {'D', 'S', 'R', 'E', 'P', '0', '0', '1'};
+
+// a student ID or a course code is kept in this many bytes, zero padded
+const size_t REPLICA_KEY_LENGTH = 16;
+
+// the loop of the server publishes a changed term at most this often
+const int REPLICA_PUBLISH_INTERVAL_MS = 10;
+
+// at the start of the segment, every field is read and written as an atomic
+struct ReplicaHeader {
+    char magic[8];                          // REPLICA_MAGIC
+    unsigned long long version;             // odd while the active slot changes
+    unsigned long long active;              // 0 or 1
+    unsigned long long slotOffset[2];       // from the start of the segment
+    unsigned long long slotLength[2];       // bytes written in the slot
+    unsigned long long slotCapacity[2];     // bytes reserved for the slot
+};
+
+// a student of a slot, the students are sorted by ID
+struct ReplicaStudent {
+    char studentId[REPLICA_KEY_LENGTH];
+    double gpa;
+    int numberOfCredits;
+    unsigned int firstCourse;       // index of its first course code in the keys of the slot
+    unsigned int numberOfCourses;
+};
+
+// a course of a slot, the courses are sorted by code
+struct ReplicaCourse {
+    char courseCode[REPLICA_KEY_LENGTH];
+    int numberOfEnrolled;
+    int capacity;
+    int numberOfCredits;
+    unsigned int firstStudent;      // index of its first student ID in the keys of the slot
+    unsigned int numberOfStudents;
+    unsigned int reserved;          // keeps the records a multiple of 8 bytes
+};
+
+// at the start of a slot, followed by the students, the courses and the keys
+struct ReplicaSlotHeader {
+    unsigned int numberOfStudents;
+    unsigned int numberOfCourses;
+    unsigned int numberOfKeys;
+    unsigned int reserved;
+};
+
+class ReplicaPublisher {
+public:
+
+    /**
+ * @brief Constructor for the ReplicaPublisher class.
+ *
+ * @pre None.
+ *
+ * @post No segment is open.
+ */
+    ReplicaPublisher();
+
+    /**
+ * @brief Create the segment, or take over the one of a previous writer.
+ *
+ * @param path The file of the segment, eg: replicaPath(term.fileSuffix).
+ * @return bool True if the segment is mapped.
+ *
+ * @pre Only one publisher writes a segment.
+ *
+ * @post The readers already mapping the segment keep their mapping, they see the next publication.
+ *       On failure an error message is printed to the standard error stream (cerr).
+ */
+    bool open(const string &);
+
+    /**
+ * @brief Copy the students and the courses of a term into the segment.
+ *
+ * @param term The term, only read.
+ * @return bool True if the readers now see the term as it is.
+ *
+ * @pre The segment is open. Called by the thread which makes the registrations of the term.
+ *
+ * @post The version grew by 2. On failure an error message is printed to the standard error stream (cerr)
+ *       and the readers keep the previous publication.
+ */
+    bool publish(const Term &);
+
+    /**
+ * @brief Publish a term only if it changed since the last publication.
+ *
+ * @param term The term, only read.
+ * @return bool True if the term was published.
+ *
+ * @details The last sequence of the journal of the term tells if a registration was made since.
+ */
+    bool publishIfChanged(const Term &);
+
+    /**
+ * @brief Get the version of the last publication.
+ *
+ * @return unsigned long long The version of the header, 0 before the first publication of this segment.
+ */
+    unsigned long long getVersion() const;
+
+private:
+    // Write the sorted students, courses and keys of a term into bytes
+    static void encodeTerm(const Term &, vector<char> &);
+
+    MappedFile segment;
+    unsigned long long publishedSequence;    // last journal sequence published
+    bool published;                          // something was published since open()
+
+};
+
+class ReplicaReader {
+public:
+
+    /**
+ * @brief Constructor for the ReplicaReader class.
+ *
+ * @pre None.
+ *
+ * @post No segment is mapped.
+ */
+    ReplicaReader();
+
+    /**
+ * @brief Map the segment of a term for reading.
+ *
+ * @param path The file of the segment, eg: replicaPath("-SUMMER").
+ * @return bool True if the segment is mapped and was published at least once.
+ *
+ * @post On failure an error message is printed to the standard error stream (cerr).
+ */
+    bool open(const string &);
+
+    /**
+ * @brief Answer a command as CommandProcessor::execute would, from the segment.
+ *
+ * @param line The command, eg: STUDENT A2210191, COURSE CSIS200, ROSTER CSIS200 or PING.
+ * @param response Set to the answer, without line break; the commands which change the registry are answered
+ *                 ERR READ_ONLY.
+ * @return bool False if the line was empty or a comment and has no answer.
+ *
+ * @post The answer comes from a single publication, never from a mix of two.
+ */
+    bool answer(const string &, string &);
+
+    /**
+ * @brief Get the version of the publication read last.
+ *
+ * @return unsigned long long The version of the header at the last answer.
+ */
+    unsigned long long getVersion() const;
+
+    /**
+ * @brief Get the number of lookups read again because the writer published during them.
+ *
+ * @return unsigned long long The retries since the construction.
+ */
+    unsigned long long getRetries() const;
+
+private:
+    // Find a key in the active slot and write its answer, retried until no publication overlapped it
+    void lookUp(const string &, const string &, string &);
+
+    // Write the answer of a command from a slot; false if the slot is inconsistent, ie: being written
+    bool answerFromSlot(const char *, unsigned long long, const string &, const string &, string &) const;
+
+    MappedFile segment;
+    unsigned long long version;
+    unsigned long long retries;
+
+};
+
+/**
+ * @brief Get the file of the segment of a term.
+ *
+ * @param fileSuffix The file suffix of the term, eg: "" for the first term or "-SUMMER".
+ * @return string REPLICA_PATH_PREFIX followed by the suffix.
+ */
+string replicaPath(const string &);
+
+#endif //DSPROJ_SHAREDREPLICA_H
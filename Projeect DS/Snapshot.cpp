@@ -0,0 +1,115 @@
+#include "Snapshot.h"
+#include <cstdio>
+#include <cstring>
+#include <iostream>
+#include <algorithm>
+#include <fcntl.h>
+#include <unistd.h>
+
+using namespace std;
+
+static_assert(sizeof(SnapshotHeader) == 32, "snapshot headers are written as 32 bytes");
+
+
+// Write the entries in blocks asked to the limiter, or all at once without one
+static bool writeEntries(const JournalRecord *entries, size_t count, FILE *file, RateLimiter *limiter) {
+    size_t block = limiter == nullptr ? count : SNAPSHOT_BLOCK_ENTRIES;
+    for (size_t done = 0; done < count; done += block) {
+        size_t length = min(block, count - done);
+        if (limiter != nullptr)
+            limiter->acquire(length * sizeof(JournalRecord));
+        if (fwrite(entries + done, sizeof(JournalRecord), length, file) != length)
+            return false;
+    }
+    return true;
+}
+
+
+// Read the entries in blocks asked to the limiter, or all at once without one
+static bool readEntries(JournalRecord *entries, size_t count, FILE *file, RateLimiter *limiter) {
+    size_t block = limiter == nullptr ? count : SNAPSHOT_BLOCK_ENTRIES;
+    for (size_t done = 0; done < count; done += block) {
+        size_t length = min(block, count - done);
+        if (limiter != nullptr)
+            limiter->acquire(length * sizeof(JournalRecord));
+        if (fread(entries + done, sizeof(JournalRecord), length, file) != length)
+            return false;
+    }
+    return true;
+}
+
+
+bool writeSnapshot(const string &path, unsigned long long sequence, const vector<JournalRecord> &entries,
+                   RateLimiter *limiter) {
+    SnapshotHeader header;
+    memset(&header, 0, sizeof(header));
+    memcpy(header.magic, SNAPSHOT_MAGIC, sizeof(header.magic));
+    header.sequence = sequence;
+    header.entries = entries.size();
+    header.checksum = journalChecksum(entries.data(), entries.size() * sizeof(JournalRecord));
+    header.headerChecksum = journalChecksum(&header, sizeof(header));
+
+    // the new snapshot replaces the previous one only once it is complete on the disk
+    string temporaryPath = path + ".tmp";
+    FILE *file = fopen(temporaryPath.c_str(), "wb");
+    if (file == nullptr) {
+        cerr << "The snapshot " << temporaryPath << " can't be created." << endl;
+        return false;
+    }
+
+    bool written = fwrite(&header, sizeof(header), 1, file) == 1 &&
+                   writeEntries(entries.data(), entries.size(), file, limiter) &&
+                   fflush(file) == 0 && fsync(fileno(file)) == 0;
+    fclose(file);
+
+    if (!written || rename(temporaryPath.c_str(), path.c_str()) != 0) {
+        cerr << "Writing the snapshot " << path << " failed, the previous snapshot is kept." << endl;
+        remove(temporaryPath.c_str());
+        return false;
+    }
+
+    // the rename is only durable once the directory is synced, the caller may then remove what the snapshot replaces
+    if (!syncDirectoryOf(path)) {
+        cerr << "The directory of the snapshot " << path << " can't be synced, the snapshot may be lost in a crash."
+             << endl;
+        return false;
+    }
+    return true;
+}
+
+
+bool readSnapshot(const string &path, unsigned long long &sequence, vector<JournalRecord> &entries,
+                  RateLimiter *limiter) {
+    sequence = 0;
+
+    FILE *file = fopen(path.c_str(), "rb");
+    if (file == nullptr)
+        return true; // no snapshot yet, the whole journal is replayed
+
+    SnapshotHeader header;
+    bool valid = fread(&header, sizeof(header), 1, file) == 1 &&
+                 memcmp(header.magic, SNAPSHOT_MAGIC, sizeof(header.magic)) == 0;
+    if (valid) {
+        unsigned int headerChecksum = header.headerChecksum;
+        header.headerChecksum = 0;
+        valid = headerChecksum == journalChecksum(&header, sizeof(header));
+    }
+
+    // the whole snapshot is read with a single call, unless a limiter paces the reads
+    size_t first = entries.size();
+    if (valid) {
+        entries.resize(first + header.entries);
+        valid = readEntries(entries.data() + first, header.entries, file, limiter) &&
+                header.checksum == journalChecksum(entries.data() + first, header.entries * sizeof(JournalRecord));
+    }
+    fclose(file);
+
+    if (!valid) {
+        cerr << "The snapshot " << path << " is damaged and was ignored." << endl;
+        entries.resize(first);
+        return false;
+    }
+
+    sequence = header.sequence;
+    return true;
+}
@@ -0,0 +1,83 @@
+/**
+
+    @file Snapshot.h
+    @brief Declaration of the functions writing and reading a snapshot of the enrollments.
+
+    This file contains the declaration of the snapshot functions. A snapshot is a binary file holding every
+    enrollment of the registry (student, course and section) at a point of the journal, so a recovery loads
+    the snapshot and only replays the records of the journal written after it.
+
+    date 18 Oct 2026
+
+    The file is a SnapshotHeader followed by one JournalRecord of type JOURNAL_REGISTER per enrollment. It is
+    written to a temporary file which is synced and then renamed over the previous snapshot, so a crash while
+    writing leaves the previous snapshot untouched. The directory is synced after the rename, so once the function
+    returns the new snapshot survives a crash and what it replaces may be removed.
+
+    Both functions can be given a RateLimiter: the file is then read or written in blocks of SNAPSHOT_BLOCK_ENTRIES
+    enrollments and the limiter is asked before each block, eg: by the compaction running in the background.
+
+    Free Functions:
+        1. writeSnapshot(const string &, unsigned long long, const vector<JournalRecord> &, RateLimiter *): bool
+        2. readSnapshot(const string &, unsigned long long &, vector<JournalRecord> &, RateLimiter *): bool
+*/
+
+#ifndef DSPROJ_SNAPSHOT_H
+#define DSPROJ_SNAPSHOT_H
+
+#include "Journal.h"
+#include "RateLimiter.h"
+#include <string>
+#include <vector>
+
+using namespace std;
+
+// first bytes of a snapshot file
+const char SNAPSHOT_MAGIC[8] = {'D', 'S', 'S', 'N', 'A', 'P', '0', '1'};
+
+// number of enrollments read or written at once when the snapshot goes through a RateLimiter
+const size_t SNAPSHOT_BLOCK_ENTRIES = 4096;
+
+// header of a snapshot file, 32 bytes
+struct SnapshotHeader {
+    char magic[8];                  // SNAPSHOT_MAGIC
+    unsigned long long sequence;    // the snapshot includes every journal record up to this one
+    unsigned long long entries;     // number of enrollments following the header
+    unsigned int checksum;          // journalChecksum of the enrollments
+    unsigned int headerChecksum;    // journalChecksum of the header with this field at 0
+};
+
+/**
+ * @brief Write a snapshot of the enrollments.
+ *
+ * @param path The path of the snapshot file.
+ * @param sequence The sequence number of the last journal record included in the enrollments.
+ * @param entries One record per enrollment, with the student ID, the course code and the section.
+ * @param limiter Paces the writes when not null, the whole file is written at once otherwise.
+ * @return bool True if the snapshot was written and synced.
+ *
+ * @pre None.
+ *
+ * @post On success the file at path is the new snapshot, on failure an error message is printed to the
+ *       standard error stream (cerr) and the previous snapshot is kept.
+ */
+bool writeSnapshot(const string &path, unsigned long long sequence, const vector<JournalRecord> &entries,
+                   RateLimiter *limiter = nullptr);
+
+/**
+ * @brief Read a snapshot of the enrollments.
+ *
+ * @param path The path of the snapshot file.
+ * @param sequence Set to the sequence number of the last journal record included, 0 if there is no snapshot.
+ * @param entries Receives one record per enrollment.
+ * @param limiter Paces the reads when not null, the whole file is read at once otherwise.
+ * @return bool True if the snapshot was read or doesn't exist, false if it is damaged.
+ *
+ * @pre None.
+ *
+ * @post A damaged snapshot is reported on the standard error stream (cerr) and nothing is read from it.
+ */
+bool readSnapshot(const string &path, unsigned long long &sequence, vector<JournalRecord> &entries,
+                  RateLimiter *limiter = nullptr);
+
+#endif //DSPROJ_SNAPSHOT_H
@@ -4,16 +4,26 @@
 #include <iostream>
 #include <vector>
 #include <iomanip>
+#include <cstring>
 
 using namespace std;
 
 
+// Copy a value into a field of the profile, cut to the size of the field
+static void setField(char *field, size_t size, const string &value) {
+    strncpy(field, value.c_str(), size - 1);
+    field[size - 1] = '\0';
+}
+
+
 Student::Student(double gpa, string studentID, string firstName, string lastName) {
+    profile = make_shared<StudentProfile>();
     setSudentId(studentID);
     setFirstName(firstName);
     setLastName(lastName);
     numberOfcredits = 0;
     courseRegistred = vector<string>();
+    bookedSlots = 0;
     setGpa(gpa);
 }
 
@@ -21,25 +31,36 @@ Student::Student(double gpa, string studentID, string firstName, string lastName
 Student::Student(string s) {
     // Split the input string into a vector of values
     vector<string> valuesList = split(s);
+    profile = make_shared<StudentProfile>();
+    bookedSlots = 0;
+
+    // an ID or a name longer than its field of the profile would be cut and differ from the data file
+    bool fits = valuesList.size() == 4 && valuesList[0].length() < sizeof(profile->studentID) &&
+                valuesList[1].length() < sizeof(profile->firstName) &&
+                valuesList[2].length() < sizeof(profile->lastName);
 
     // Check if the correct number of values is present in the input
-    if (valuesList.size() != 4) {
+    if (!fits) {
         // If not, set default values and print a warning
-        firstName = "NULL";
-        lastName = "NULL";
-        studentID = "NULL";
+        setField(profile->firstName, sizeof(profile->firstName), "NULL");
+        setField(profile->lastName, sizeof(profile->lastName), "NULL");
+        setField(profile->studentID, sizeof(profile->studentID), "NULL");
         courseRegistred = vector<string>();
-        gpa = 0;
-        cerr << "A student object was created with default values please check if any info is missing \n"
-                "or if the first or last name is composed of multiple words make sure to connect them with \n"
-                "a '_' or '-'." << endl;
+        profile->gpa = 0;
+        if (valuesList.size() != 4)
+            cerr << "A student object was created with default values please check if any info is missing \n"
+                    "or if the first or last name is composed of multiple words make sure to connect them with \n"
+                    "a '_' or '-'." << endl;
+        else
+            cerr << "A student object was created with default values, the ID or a name of \"" << s
+                 << "\" is too long." << endl;
         numberOfcredits = 0;
     } else {
         // If the correct number of values is present, initialize the student object
-        studentID = valuesList[0];
-        firstName = valuesList[1];
-        lastName = valuesList[2];
-        gpa = stod(valuesList[3]);
+        setField(profile->studentID, sizeof(profile->studentID), valuesList[0]);
+        setField(profile->firstName, sizeof(profile->firstName), valuesList[1]);
+        setField(profile->lastName, sizeof(profile->lastName), valuesList[2]);
+        profile->gpa = stod(valuesList[3]);
         numberOfcredits = 0;
         courseRegistred = vector<string>();
     }
@@ -68,14 +89,14 @@ void Student::setSudentId(string id) {
                 if (!isdigit(id[i])) {
                     // If any character is not a digit, set the ID to "NULL" and exit the loop
                     isValid = false;
-                    studentID = "NULL";
+                    setField(profile->studentID, sizeof(profile->studentID), "NULL");
                     break;
                 }
             }
 
             // If all characters are digits, set the student ID
             if (isValid) {
-                studentID = id;
+                setField(profile->studentID, sizeof(profile->studentID), id);
             }
         }
     }
@@ -84,12 +105,12 @@ void Student::setSudentId(string id) {
 
 
 void Student::setFirstName(string name) {
-    firstName = name;
+    setField(profile->firstName, sizeof(profile->firstName), name);
 }
 
 
 void Student::setLastName(string name) {
-    lastName = name;
+    setField(profile->lastName, sizeof(profile->lastName), name);
 }
 
 
@@ -97,10 +118,10 @@ void Student::setGpa(double gpa) {
     // Check if the provided GPA is outside the valid range (0 to 4)
     if (gpa > 4 || gpa < 0) {
         // If outside the range, set the GPA to a default value (e.g., 2)
-        this->gpa = 2;
+        profile->gpa = 2;
     } else {
         // If within the valid range, set the GPA to the provided value
-        this->gpa = gpa;
+        profile->gpa = gpa;
     }
 }
 
@@ -110,6 +131,38 @@ void Student::setNumberOfCredits(int number){
 }
 
 
+void Student::setBookedSlots(unsigned long long slots) {
+    bookedSlots = slots;
+}
+
+
+void Student::setCompletedCourses(const vector<unsigned long long> &completed) {
+    completedCourses = completed;
+}
+
+
+Student::Student(const shared_ptr<StudentProfile> &profile) : profile(profile) {
+    numberOfcredits = 0;
+    courseRegistred = vector<string>();
+    bookedSlots = 0;
+}
+
+
+bool Student::toRecord(StudentRecord &record) const {
+    // the profile already is a record, the lines refused by Student(string) have the ID NULL
+    record = *profile;
+    return record.studentID[0] != '\0' && strcmp(record.studentID, "NULL") != 0;
+}
+
+
+Student Student::termCopy() const {
+    // a new student of the term, then only the profile is taken from this one
+    Student copy;
+    copy.profile = profile;
+    return copy;
+}
+
+
 bool Student::addCourse(const string  courseID) {
 
     courseRegistred.push_back(courseID);
@@ -141,9 +194,18 @@ bool Student::dropCourse(const string courseCode) {
 }
 
 
+bool Student::hasCourse(const string &courseCode) const {
+    for (const string &code: courseRegistred) {
+        if (code == courseCode)
+            return true;
+    }
+    return false;
+}
+
+
 
 string Student::getStudentId() const {
-    return studentID;
+    return profile->studentID;
 }
 
 
@@ -153,29 +215,40 @@ int Student::getNumberOfcredits() const{
 
 
 string Student::getFirstName() const {
-    return firstName;
+    return profile->firstName;
 }
 
 
 string Student::getLastName() const {
-    return lastName;
+    return profile->lastName;
 }
 
 
 string Student::getAcademicStatus() const {
-    return (gpa>=2 ? "Regular" : "Probation");
+    return (profile->gpa>=2 ? "Regular" : "Probation");
 }
 
 
 string Student::getFullName() const {
-    return firstName + ", " + lastName;
+    return string(profile->firstName) + ", " + profile->lastName;
 }
 
 
 double Student::getGpa() const {
-    return gpa;
+    return profile->gpa;
+}
+
+
+unsigned long long Student::getBookedSlots() const {
+    return bookedSlots;
 }
 
+
+const vector<unsigned long long> &Student::getCompletedCourses() const {
+    return completedCourses;
+}
+
+
 vector<string> & Student::getRegisteredCourse() {
     return courseRegistred;
 }
@@ -184,10 +257,10 @@ vector<string> & Student::getRegisteredCourse() {
 void Student::displayInfo() const {
     // Output student information, including ID, name, major, and GPA
     cout << "Student: " << endl <<
-         "\tID: " << studentID << endl <<
-         "\tName: " << firstName << " " << lastName << endl <<
+         "\tID: " << profile->studentID << endl <<
+         "\tName: " << profile->firstName << " " << profile->lastName << endl <<
          "\tMajor: " << "COMPUTER SCIENCE" << endl << // Assuming a fixed major for simplicity
-         "\tGPA: " << gpa << endl;
+         "\tGPA: " << profile->gpa << endl;
 }
 
 
@@ -195,9 +268,9 @@ void Student::displayInfo() const {
 ostream & Student::displayTabular(ostream & out) const {
 
     out << left <<
-        setw(17) << studentID <<
+        setw(17) << profile->studentID <<
         setw(23) << getFullName() <<
-        setw(6) << fixed << setprecision(1) << gpa <<
+        setw(6) << fixed << setprecision(1) << profile->gpa <<
         setw(20) << getAcademicStatus() << endl;
 
     return out;
@@ -206,7 +279,7 @@ ostream & Student::displayTabular(ostream & out) const {
 
 void Student::displayRegisteredCourse() const {
     // Output student information, including ID and name
-    cout << "Student " << studentID << " - " << firstName << " " << lastName << "\nCourses:\n\n";
+    cout << "Student " << profile->studentID << " - " << profile->firstName << " " << profile->lastName << "\nCourses:\n\n";
 
     // Iterate through the registered courses and display each course code
     for (int i = 0; i < courseRegistred.size(); i++) {
@@ -217,7 +290,7 @@ void Student::displayRegisteredCourse() const {
 
 
 bool Student::operator==(const Student &student) const {
-    return studentID == student.getStudentId();
+    return strcmp(profile->studentID, student.profile->studentID) == 0;
 }
 
 
@@ -225,13 +298,12 @@ Student &Student::operator=(const Student &student) {
     // Check for self-assignment
     if (this != &student) {
         // Copy values from the right-hand side student to the left-hand side object (*this)
-        studentID = student.studentID;
-        firstName = student.firstName;
-        lastName = student.lastName;
-        gpa = student.gpa;
+        profile = student.profile; // the same student: the master data is shared, not copied
 
         numberOfcredits = student.numberOfcredits; // Corrected member name
         courseRegistred = student.courseRegistred;
+        bookedSlots = student.bookedSlots;
+        completedCourses = student.completedCourses;
     }
     // Return a reference to the modified object
     return *this;
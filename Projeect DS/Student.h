@@ -11,6 +11,15 @@
     The purpose of this class is to encapsulate the properties and behaviors of a student. It allows users to manage
     student information, register and drop courses, and display student details.
 
+    The identity of the student (ID, names and GPA) is kept in a StudentProfile shared by every copy of the student,
+    while the courses, credits and booked hours belong to one term. A term copy (termCopy) is a Student of another
+    term sharing the same profile, so several terms can be open without copying the master data, and a change of
+    the GPA is seen by every term.
+
+    The profile is a fixed size record, the one of Student.map: the students of the terms point to the records of
+    the mapped list (see TermDirectory), so the master data is mapped at the start and never copied. An ID or a name
+    longer than its field is cut by the setters, and a line of Student.txt holding one is refused by Student(string).
+
     Public Member Functions:
         1. Student(double, string, string, string): Student
         2. Student(string): Student
@@ -39,6 +48,14 @@
         25. operator=(const Student &): Student &
         26. operator>>(istream &, Student &): friend istream &
         27. split(const string &): static vector<string>
+        28. hasCourse(const string &) const: bool
+        29. getBookedSlots() const: unsigned long long
+        30. setBookedSlots(unsigned long long): void
+        31. getCompletedCourses() const: const vector<unsigned long long> &
+        32. setCompletedCourses(const vector<unsigned long long> &): void
+        33. termCopy() const: Student
+        34. Student(const shared_ptr<StudentProfile> &): Student
+        35. toRecord(StudentRecord &) const: bool
 */
 
 #ifndef DSPROJ_STUDENT_H
@@ -48,6 +65,7 @@
 #include <string>
 #include <iostream>
 #include <vector>
+#include <memory>
 
 using namespace std;
 
@@ -56,6 +74,17 @@ using namespace std;
 
 
 
+// the master data of a student as a fixed size record, the form kept in Student.map (see MappedNodes.h)
+struct StudentRecord {
+    char studentID[12];    // null terminated, as are the names, a longer value doesn't fit
+    char firstName[28];
+    char lastName[28];
+    double gpa;
+};
+
+// the master data of a student, shared by the Student objects of every term, in the mapping of Student.map or not
+typedef StudentRecord StudentProfile;
+
 class Course; // So we can solve the forward declaration error
 class Student {
 public:
@@ -92,10 +121,23 @@ public:
  * @pre The input string follows the format "studentID_firstName_lastName_GPA".
  *
  * @post The Student object is initialized with the specified attributes from the input string.
- *       If the input string is invalid, default values are set.
+ *       If the input string is invalid, or its ID or a name is longer than the field of the profile, default
+ *       values are set and an error message is printed to the standard error stream (cerr).
  */
     Student(string);
 
+    /**
+ * @brief Constructor for the Student class on an existing profile, eg: a record of Student.map.
+ *
+ * @param profile The ID, names and GPA of the student, not copied.
+ *
+ * @pre The strings of the profile are null terminated. A profile in a mapping stays at its address as long as the
+ *      student exists.
+ *
+ * @post The Student object shares the profile and has no course, credit, booked hour or completed course.
+ */
+    Student(const shared_ptr<StudentProfile> &);
+
     /**
  * @brief Copy constructor for the Student class.
  *
@@ -236,6 +278,34 @@ public:
  */
     double getGpa() const;
 
+    /**
+ * @brief Get the weekly hours booked by the courses of the student.
+ *
+ * This method returns the union of the meeting times of every course the student is registered in.
+ *
+ * @return unsigned long long The booked hours as a bitmask, see Course::getMeetingSlots().
+ *
+ * @pre The Student object is properly initialized.
+ *
+ * @post None.
+ *
+ * @details A course conflicts with the schedule of the student if the AND of its meeting times and
+ * the booked hours is not 0.
+ */
+    unsigned long long getBookedSlots() const;
+
+    /**
+ * @brief Get the courses completed by the student in the previous semesters.
+ *
+ * @return const vector<unsigned long long> & The completed courses as a bitset numbered by the
+ * prerequisite graph of the registry, see PrerequisiteGraph.
+ *
+ * @pre The Student object is properly initialized.
+ *
+ * @post None.
+ */
+    const vector<unsigned long long> &getCompletedCourses() const;
+
     /**
  * @brief Get a reference to the vector of registered courses.
  *
@@ -278,7 +348,7 @@ public:
  *
  * @pre None.
  *
- * @post The first name of the student is set to the provided value.
+ * @post The first name of the student is set to the provided value, cut to the field of the profile.
  *
  * @details This function sets the first name of the Student object to the provided value.
  */
@@ -291,7 +361,7 @@ public:
   *
   * @pre None.
   *
-  * @post The last name of the student is set to the provided value.
+  * @post The last name of the student is set to the provided value, cut to the field of the profile.
   *
   * @details This function sets the last name of the Student object to the provided value.
   */
@@ -325,6 +395,57 @@ public:
  */
     void setNumberOfCredits(int);
 
+    /**
+ * @brief Setter for the weekly hours booked by the courses of the student.
+ *
+ * @param slots The booked hours as a bitmask, see Course::getMeetingSlots().
+ *
+ * @pre None.
+ *
+ * @post The booked hours of the student are set to the provided value.
+ */
+    void setBookedSlots(unsigned long long);
+
+    /**
+ * @brief Setter for the courses completed by the student in the previous semesters.
+ *
+ * @param completed The completed courses as a bitset numbered by the prerequisite graph of the registry.
+ *
+ * @pre None.
+ *
+ * @post The completed courses of the student are set to the provided value.
+ */
+    void setCompletedCourses(const vector<unsigned long long> &);
+
+    // Term methods
+
+    /**
+ * @brief Make the Student object of the same student in another term.
+ *
+ * @return Student A student sharing the profile of this one (ID, names and GPA), without any course, credit,
+ * booked hour or completed course.
+ *
+ * @pre None.
+ *
+ * @post None, this student is not modified.
+ *
+ * @details Only the shared pointer to the profile is copied, see TermDirectory::openTerm.
+ */
+    Student termCopy() const;
+
+    /**
+ * @brief Get the master data of the student as a fixed size record.
+ *
+ * @param record Set to the ID, names and GPA, a copy of the profile.
+ * @return bool False if the student has no valid ID, eg: it was built from an invalid line or one whose ID or a
+ * name is longer than its field of the record.
+ *
+ * @pre None.
+ *
+ * @post None, this student is not modified.
+ */
+    bool toRecord(StudentRecord &) const;
+
     // Course-related methods
 
 
@@ -357,6 +478,19 @@ public:
   */
     bool dropCourse(const string);  // course code
 
+    /**
+  * @brief Check if the Student is registered in a course.
+  *
+  * @param courseCode The code of the course to look for.
+  *
+  * @pre None.
+  *
+  * @post None.
+  *
+  * @return True if the course code is in the list of registered courses, false otherwise.
+  */
+    bool hasCourse(const string &) const;
+
     /**
  * @brief Display the list of courses registered by the student.
  *
@@ -438,17 +572,17 @@ public:
  *
  * @details The function checks if the current object is not the same as the provided object,
  * and if not, it assigns the values of the provided object's attributes to the current object.
+ * The profile is shared, not copied: both objects are the same student.
  * It then returns a reference to the current object.
  */
     Student &operator=(const Student &student);
 
 private:
-    string studentID;
-    string firstName;
-    string lastName;
+    shared_ptr<StudentProfile> profile; // ID, names and GPA, shared by the copies of the student in every term
     int numberOfcredits;
-    double gpa;
     vector<string> courseRegistred;
+    unsigned long long bookedSlots; // union of the meeting times of the registered courses
+    vector<unsigned long long> completedCourses; // bitset of the courses passed in previous semesters
 
 };
 
@@ -0,0 +1,345 @@
+#include "TermArchive.h"
+#include "Journal.h"
+#include <cstdio>
+#include <cstring>
+#include <iostream>
+#include <algorithm>
+#include <unordered_map>
+#include <unistd.h>
+
+using namespace std;
+
+static_assert(sizeof(ArchiveHeader) == 48, "archive headers are written as 48 bytes");
+static_assert(sizeof(ArchiveStudent) == 12, "archive students are written as 12 bytes");
+static_assert(sizeof(ArchiveCourse) == 16, "archive courses are written as 16 bytes");
+static_assert(sizeof(ArchiveBlock) == 24, "archive blocks are written as 24 bytes");
+
+
+// Number of bits holding every value up to largest, 0 when every value is 0
+static unsigned char bitsFor(unsigned long long largest) {
+    unsigned char bits = 0;
+    while (bits < 64 && (largest >> bits) != 0)
+        bits++;
+    return bits;
+}
+
+
+// Number of words of a column of count values of bits bits
+static unsigned long long columnWords(unsigned int count, unsigned char bits) {
+    return ((unsigned long long) count * bits + 63) / 64;
+}
+
+
+// Append a column to the words, starting at a new word
+static void packColumn(const unsigned int *values, unsigned int count, unsigned char bits,
+                       vector<unsigned long long> &words) {
+    size_t first = words.size();
+    words.resize(first + columnWords(count, bits), 0);
+
+    unsigned long long bit = 0;
+    for (unsigned int i = 0; i < count; i++, bit += bits) {
+        if (bits == 0)
+            continue;
+        size_t word = first + bit / 64;
+        unsigned int shift = bit % 64;
+        words[word] |= (unsigned long long) values[i] << shift;
+        // the value goes over the end of the word: its high bits start the next one
+        if (shift + bits > 64)
+            words[word + 1] |= (unsigned long long) values[i] >> (64 - shift);
+    }
+}
+
+
+// Decode a column packed by packColumn
+static void unpackColumn(const unsigned long long *words, unsigned int count, unsigned char bits,
+                         unsigned int *values) {
+    if (bits == 0) {
+        fill(values, values + count, 0);
+        return;
+    }
+
+    unsigned long long mask = bits == 64 ? ~0ULL : (1ULL << bits) - 1;
+    unsigned long long bit = 0;
+    for (unsigned int i = 0; i < count; i++, bit += bits) {
+        const unsigned long long *word = words + bit / 64;
+        unsigned int shift = bit % 64;
+        unsigned long long value = *word >> shift;
+        if (shift + bits > 64)
+            value |= word[1] << (64 - shift);
+        values[i] = value & mask;
+    }
+}
+
+
+// Checksum of the parts of the file following the header
+static unsigned int archiveChecksum(const vector<ArchiveStudent> &students, const vector<ArchiveCourse> &courses,
+                                    const vector<ArchiveBlock> &blocks, const vector<unsigned long long> &words) {
+    unsigned int parts[4] = {
+            journalChecksum(students.data(), students.size() * sizeof(ArchiveStudent)),
+            journalChecksum(courses.data(), courses.size() * sizeof(ArchiveCourse)),
+            journalChecksum(blocks.data(), blocks.size() * sizeof(ArchiveBlock)),
+            journalChecksum(words.data(), words.size() * sizeof(unsigned long long))
+    };
+    return journalChecksum(parts, sizeof(parts));
+}
+
+
+TermArchive::TermArchive() {
+    rows = 0;
+}
+
+
+void TermArchive::build(const RegistryView &view) {
+    rows = 0;
+    students.clear();
+    courses.clear();
+    blocks.clear();
+    words.clear();
+
+    // the dictionaries: every course of the term and every student with an enrollment, sorted
+    const vector<CourseVersion> &versions = view.getCourses();
+    vector<const CourseVersion *> sortedCourses;
+    vector<string> studentIds;
+    for (const CourseVersion &version: versions) {
+        sortedCourses.push_back(&version);
+        const map<string, string> &registeredStudents = version.roster->registeredStudents;
+        for (auto itr = registeredStudents.begin(); itr != registeredStudents.end(); ++itr)
+            studentIds.push_back(itr->first);
+    }
+    sort(sortedCourses.begin(), sortedCourses.end(), [](const CourseVersion *first, const CourseVersion *second) {
+        return first->courseCode < second->courseCode;
+    });
+    sort(studentIds.begin(), studentIds.end());
+    studentIds.erase(unique(studentIds.begin(), studentIds.end()), studentIds.end());
+
+    unordered_map<string, unsigned int> studentHandles;
+    students.resize(studentIds.size());
+    for (size_t i = 0; i < studentIds.size(); i++) {
+        memset(&students[i], 0, sizeof(ArchiveStudent));
+        strncpy(students[i].studentId, studentIds[i].c_str(), sizeof(students[i].studentId) - 1);
+        studentHandles[studentIds[i]] = i;
+    }
+
+    // one row per enrollment, sorted by student then course so the student deltas are small
+    vector<unsigned long long> keys;
+    courses.resize(sortedCourses.size());
+    for (size_t i = 0; i < sortedCourses.size(); i++) {
+        memset(&courses[i], 0, sizeof(ArchiveCourse));
+        strncpy(courses[i].courseCode, sortedCourses[i]->courseCode.c_str(), sizeof(courses[i].courseCode) - 1);
+        courses[i].numberOfCredits = sortedCourses[i]->numberOfCredits;
+
+        const map<string, string> &registeredStudents = sortedCourses[i]->roster->registeredStudents;
+        for (auto itr = registeredStudents.begin(); itr != registeredStudents.end(); ++itr)
+            keys.push_back((unsigned long long) studentHandles[itr->first] << 32 | i);
+    }
+    sort(keys.begin(), keys.end());
+    rows = keys.size();
+
+    vector<unsigned int> deltas(ARCHIVE_BLOCK_ROWS), courseHandles(ARCHIVE_BLOCK_ROWS), credits(ARCHIVE_BLOCK_ROWS);
+    for (size_t first = 0; first < keys.size(); first += ARCHIVE_BLOCK_ROWS) {
+        ArchiveBlock block;
+        memset(&block, 0, sizeof(block));
+        block.offset = words.size();
+        block.rows = min((size_t) ARCHIVE_BLOCK_ROWS, keys.size() - first);
+        block.firstStudent = keys[first] >> 32;
+
+        unsigned int previous = block.firstStudent, largestDelta = 0, largestCourse = 0, largestCredits = 0;
+        for (unsigned int i = 0; i < block.rows; i++) {
+            unsigned int student = keys[first + i] >> 32;
+            deltas[i] = student - previous;
+            courseHandles[i] = (unsigned int) keys[first + i];
+            credits[i] = max(courses[courseHandles[i]].numberOfCredits, 0);
+            previous = student;
+
+            largestDelta = max(largestDelta, deltas[i]);
+            largestCourse = max(largestCourse, courseHandles[i]);
+            largestCredits = max(largestCredits, credits[i]);
+        }
+
+        block.studentBits = bitsFor(largestDelta);
+        block.courseBits = bitsFor(largestCourse);
+        block.creditBits = bitsFor(largestCredits);
+        packColumn(deltas.data(), block.rows, block.studentBits, words);
+        packColumn(courseHandles.data(), block.rows, block.courseBits, words);
+        packColumn(credits.data(), block.rows, block.creditBits, words);
+        blocks.push_back(block);
+    }
+}
+
+
+bool TermArchive::save(const string &path) const {
+    ArchiveHeader header;
+    memset(&header, 0, sizeof(header));
+    memcpy(header.magic, ARCHIVE_MAGIC, sizeof(header.magic));
+    header.rows = rows;
+    header.words = words.size();
+    header.students = students.size();
+    header.courses = courses.size();
+    header.blocks = blocks.size();
+    header.checksum = archiveChecksum(students, courses, blocks, words);
+    header.headerChecksum = journalChecksum(&header, sizeof(header));
+
+    // the new archive replaces the previous one only once it is complete on the disk
+    string temporaryPath = path + ".tmp";
+    FILE *file = fopen(temporaryPath.c_str(), "wb");
+    if (file == nullptr) {
+        cerr << "The archive " << temporaryPath << " can't be created." << endl;
+        return false;
+    }
+
+    bool written = fwrite(&header, sizeof(header), 1, file) == 1 &&
+                   fwrite(students.data(), sizeof(ArchiveStudent), students.size(), file) == students.size() &&
+                   fwrite(courses.data(), sizeof(ArchiveCourse), courses.size(), file) == courses.size() &&
+                   fwrite(blocks.data(), sizeof(ArchiveBlock), blocks.size(), file) == blocks.size() &&
+                   fwrite(words.data(), sizeof(unsigned long long), words.size(), file) == words.size() &&
+                   fflush(file) == 0 && fsync(fileno(file)) == 0;
+    fclose(file);
+
+    if (!written || rename(temporaryPath.c_str(), path.c_str()) != 0) {
+        cerr << "Writing the archive " << path << " failed, the previous archive is kept." << endl;
+        remove(temporaryPath.c_str());
+        return false;
+    }
+    return true;
+}
+
+
+bool TermArchive::load(const string &path) {
+    rows = 0;
+    students.clear();
+    courses.clear();
+    blocks.clear();
+    words.clear();
+
+    FILE *file = fopen(path.c_str(), "rb");
+    if (file == nullptr) {
+        cerr << "The archive " << path << " can't be opened." << endl;
+        return false;
+    }
+
+    ArchiveHeader header;
+    bool valid = fread(&header, sizeof(header), 1, file) == 1 &&
+                 memcmp(header.magic, ARCHIVE_MAGIC, sizeof(header.magic)) == 0;
+    if (valid) {
+        unsigned int headerChecksum = header.headerChecksum;
+        header.headerChecksum = 0;
+        valid = headerChecksum == journalChecksum(&header, sizeof(header)) &&
+                header.rows <= (unsigned long long) header.blocks * ARCHIVE_BLOCK_ROWS;
+    }
+
+    if (valid) {
+        students.resize(header.students);
+        courses.resize(header.courses);
+        blocks.resize(header.blocks);
+        words.resize(header.words);
+        valid = fread(students.data(), sizeof(ArchiveStudent), students.size(), file) == students.size() &&
+                fread(courses.data(), sizeof(ArchiveCourse), courses.size(), file) == courses.size() &&
+                fread(blocks.data(), sizeof(ArchiveBlock), blocks.size(), file) == blocks.size() &&
+                fread(words.data(), sizeof(unsigned long long), words.size(), file) == words.size() &&
+                header.checksum == archiveChecksum(students, courses, blocks, words);
+    }
+    fclose(file);
+
+    // the blocks are decoded without bound checks: each one must lie inside the words
+    for (size_t i = 0; valid && i < blocks.size(); i++) {
+        const ArchiveBlock &block = blocks[i];
+        valid = block.rows <= ARCHIVE_BLOCK_ROWS && block.studentBits <= 32 && block.courseBits <= 32 &&
+                block.creditBits <= 32 && block.offset <= words.size() &&
+                columnWords(block.rows, block.studentBits) + columnWords(block.rows, block.courseBits) +
+                columnWords(block.rows, block.creditBits) <= words.size() - block.offset;
+    }
+
+    if (!valid) {
+        cerr << "The archive " << path << " is damaged and was ignored." << endl;
+        students.clear();
+        courses.clear();
+        blocks.clear();
+        words.clear();
+        return false;
+    }
+
+    rows = header.rows;
+    return true;
+}
+
+
+unsigned long long TermArchive::getNumberOfRows() const {
+    return rows;
+}
+
+
+int TermArchive::getNumberOfStudents() const {
+    return students.size();
+}
+
+
+int TermArchive::getNumberOfCourses() const {
+    return courses.size();
+}
+
+
+string TermArchive::getStudentId(unsigned int handle) const {
+    return students[handle].studentId;
+}
+
+
+string TermArchive::getCourseCode(unsigned int handle) const {
+    return courses[handle].courseCode;
+}
+
+
+int TermArchive::getCourseCredits(unsigned int handle) const {
+    return courses[handle].numberOfCredits;
+}
+
+
+unsigned long long TermArchive::getCompressedBytes() const {
+    return sizeof(ArchiveHeader) + students.size() * sizeof(ArchiveStudent) + courses.size() * sizeof(ArchiveCourse) +
+           blocks.size() * sizeof(ArchiveBlock) + words.size() * sizeof(unsigned long long);
+}
+
+
+vector<unsigned long long> TermArchive::countEnrollmentsPerCourse() const {
+    vector<unsigned long long> enrollments(courses.size(), 0);
+    scan([&enrollments](const ArchiveRows &block) {
+        for (unsigned int i = 0; i < block.rows; i++)
+            enrollments[block.courses[i]]++;
+    });
+    return enrollments;
+}
+
+
+vector<unsigned long long> TermArchive::sumCreditsPerStudent() const {
+    vector<unsigned long long> credits(students.size(), 0);
+    scan([&credits](const ArchiveRows &block) {
+        for (unsigned int i = 0; i < block.rows; i++)
+            credits[block.students[i]] += block.credits[i];
+    });
+    return credits;
+}
+
+
+void TermArchive::decodeBlock(const ArchiveBlock &block, unsigned int *columns, ArchiveRows &decoded) const {
+    unsigned int *studentHandles = columns;
+    unsigned int *courseHandles = columns + ARCHIVE_BLOCK_ROWS;
+    unsigned int *credits = columns + 2 * ARCHIVE_BLOCK_ROWS;
+
+    const unsigned long long *column = words.data() + block.offset;
+    unpackColumn(column, block.rows, block.studentBits, studentHandles);
+    column += columnWords(block.rows, block.studentBits);
+    unpackColumn(column, block.rows, block.courseBits, courseHandles);
+    column += columnWords(block.rows, block.courseBits);
+    unpackColumn(column, block.rows, block.creditBits, credits);
+
+    // the student column holds the differences with the previous row
+    unsigned int student = block.firstStudent;
+    for (unsigned int i = 0; i < block.rows; i++) {
+        student += studentHandles[i];
+        studentHandles[i] = student;
+    }
+
+    decoded.rows = block.rows;
+    decoded.students = studentHandles;
+    decoded.courses = courseHandles;
+    decoded.credits = credits;
+}
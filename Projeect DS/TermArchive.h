@@ -0,0 +1,249 @@
+/**
+
+    @file TermArchive.h
+    @brief Declaration of the TermArchive class and its member functions.
+
+    This file contains the declaration of the TermArchive class, which keeps the enrollments of a closed term as
+    compressed columns, so years of history fit in memory and can be aggregated in one pass.
+
+    date 18 Oct 2026
+
+    A term is archived from a RegistryView of its registry. The student IDs and the course codes are stored once,
+    sorted, in two dictionaries, and each enrollment becomes a row of three small integers: the student handle
+    (the position of the ID in the dictionary), the course handle and the number of credits of the course. The rows
+    are sorted by student and course and cut in blocks of ARCHIVE_BLOCK_ROWS rows. In a block each column is
+    bit-packed with the fewest bits holding its largest value; the student column holds the difference with the
+    previous row, which is 0 or 1 most of the time because the rows are sorted by student.
+
+    The archive file is an ArchiveHeader followed by the two dictionaries, the block headers and the packed words.
+    It is written to a temporary file which is synced and renamed, like a snapshot, and is read back at once.
+
+    scan() decodes the blocks one after the other into three arrays small enough to stay in the cache and gives
+    them to a visitor, which is how the aggregations below are written.
+
+    Public Member Functions:
+        1. TermArchive()
+        2. build(const RegistryView &): void
+        3. save(const string &) const: bool
+        4. load(const string &): bool
+        5. getNumberOfRows() const: unsigned long long
+        6. getNumberOfStudents() const: int
+        7. getNumberOfCourses() const: int
+        8. getStudentId(unsigned int) const: string
+        9. getCourseCode(unsigned int) const: string
+        10. getCourseCredits(unsigned int) const: int
+        11. getCompressedBytes() const: unsigned long long
+        12. scan(Visitor) const: void
+        13. countEnrollmentsPerCourse() const: vector<unsigned long long>
+        14. sumCreditsPerStudent() const: vector<unsigned long long>
+*/
+
+#ifndef DSPROJ_TERMARCHIVE_H
+#define DSPROJ_TERMARCHIVE_H
+
+#include "RegistryView.h"
+
+#include <string>
+#include <vector>
+
+using namespace std;
+
+// first bytes of an archive file
+const char ARCHIVE_MAGIC[8] = {'D', 'S', 'A', 'R', 'C', 'H', '0', '1'};
+
+// number of enrollments in a block of the archive, the unit decoded by scan()
+const unsigned int ARCHIVE_BLOCK_ROWS = 4096;
+
+// header of an archive file, 48 bytes
+struct ArchiveHeader {
+    char magic[8];                  // ARCHIVE_MAGIC
+    unsigned long long rows;        // number of enrollments
+    unsigned long long words;       // number of packed words following the block headers
+    unsigned int students;          // entries of the student dictionary
+    unsigned int courses;           // entries of the course dictionary
+    unsigned int blocks;            // number of block headers
+    unsigned int checksum;          // journalChecksum of everything following the header
+    unsigned int reserved;          // 0
+    unsigned int headerChecksum;    // journalChecksum of the header with this field at 0
+};
+
+// entry of the student dictionary, 12 bytes
+struct ArchiveStudent {
+    char studentId[12];             // null terminated
+};
+
+// entry of the course dictionary, 16 bytes
+struct ArchiveCourse {
+    char courseCode[12];            // null terminated
+    int numberOfCredits;
+};
+
+// header of a block of rows, 24 bytes
+struct ArchiveBlock {
+    unsigned long long offset;      // first packed word of the block
+    unsigned int rows;              // at most ARCHIVE_BLOCK_ROWS
+    unsigned int firstStudent;      // student handle of the first row, the deltas start from it
+    unsigned char studentBits;      // bits of a student delta
+    unsigned char courseBits;       // bits of a course handle
+    unsigned char creditBits;       // bits of a number of credits
+    unsigned char reserved[5];      // 0
+};
+
+// the decoded columns of a block, valid during a call of the scan() visitor
+struct ArchiveRows {
+    unsigned int rows;
+    const unsigned int *students;   // student handles, non decreasing
+    const unsigned int *courses;    // course handles
+    const unsigned int *credits;    // number of credits of the course
+};
+
+class TermArchive {
+public:
+
+    /**
+ * @brief Constructor for the TermArchive class.
+ *
+ * @pre None.
+ *
+ * @post The archive is empty.
+ */
+    TermArchive();
+
+    /**
+ * @brief Archive the enrollments of a term.
+ *
+ * @param view A view of the registry of the term, eg: Registry::pinView().
+ *
+ * @pre None.
+ *
+ * @post The archive holds one row per enrollment of the view and nothing else.
+ */
+    void build(const RegistryView &);
+
+    /**
+ * @brief Write the archive to a file.
+ *
+ * @param path The path of the archive file, eg: Archive-SUMMER.dsa.
+ * @return bool True if the file was written and synced.
+ *
+ * @pre None.
+ *
+ * @post On failure an error message is printed to the standard error stream (cerr) and the previous file is kept.
+ */
+    bool save(const string &) const;
+
+    /**
+ * @brief Read an archive file.
+ *
+ * @param path The path of the archive file.
+ * @return bool True if the archive was read, false if the file is missing or damaged.
+ *
+ * @pre None.
+ *
+ * @post On failure an error message is printed to the standard error stream (cerr) and the archive is empty.
+ */
+    bool load(const string &);
+
+    /**
+ * @brief Get the number of rows of the archive.
+ *
+ * @return unsigned long long The number of enrollments archived.
+ */
+    unsigned long long getNumberOfRows() const;
+
+    /**
+ * @brief Get the number of students of the dictionary.
+ *
+ * @return int The number of students with at least one enrollment.
+ */
+    int getNumberOfStudents() const;
+
+    /**
+ * @brief Get the number of courses of the dictionary.
+ *
+ * @return int The number of courses of the term, with or without enrollments.
+ */
+    int getNumberOfCourses() const;
+
+    /**
+ * @brief Get the ID of a student handle.
+ *
+ * @param handle A student handle of a row.
+ * @return string The ID of the student.
+ *
+ * @pre handle < getNumberOfStudents().
+ */
+    string getStudentId(unsigned int) const;
+
+    /**
+ * @brief Get the code of a course handle.
+ *
+ * @param handle A course handle of a row.
+ * @return string The code of the course.
+ *
+ * @pre handle < getNumberOfCourses().
+ */
+    string getCourseCode(unsigned int) const;
+
+    /**
+ * @brief Get the number of credits of a course handle.
+ *
+ * @param handle A course handle of a row.
+ * @return int The number of credits the course had in the term.
+ *
+ * @pre handle < getNumberOfCourses().
+ */
+    int getCourseCredits(unsigned int) const;
+
+    /**
+ * @brief Get the size of the archive file.
+ *
+ * @return unsigned long long The bytes of the header, the dictionaries, the block headers and the packed words.
+ */
+    unsigned long long getCompressedBytes() const;
+
+    /**
+ * @brief Call a function on every block of rows, in the order of the rows.
+ *
+ * @param visit Called as visit(rows) with a const ArchiveRows &.
+ *
+ * @details The columns of a block are decoded into the same three arrays of ARCHIVE_BLOCK_ROWS integers,
+ * overwritten by the next block: the visitor must copy what it keeps.
+ */
+    template<typename Visitor>
+    void scan(Visitor visit) const {
+        vector<unsigned int> columns(3 * ARCHIVE_BLOCK_ROWS);
+        ArchiveRows rows;
+        for (size_t i = 0; i < blocks.size(); i++) {
+            decodeBlock(blocks[i], columns.data(), rows);
+            visit((const ArchiveRows &) rows);
+        }
+    }
+
+    /**
+ * @brief Count the enrollments of every course.
+ *
+ * @return vector<unsigned long long> The number of rows of each course handle.
+ */
+    vector<unsigned long long> countEnrollmentsPerCourse() const;
+
+    /**
+ * @brief Add up the credits of every student.
+ *
+ * @return vector<unsigned long long> The credits of the rows of each student handle.
+ */
+    vector<unsigned long long> sumCreditsPerStudent() const;
+
+private:
+    // Decode the three columns of a block into columns, which holds 3 * ARCHIVE_BLOCK_ROWS integers
+    void decodeBlock(const ArchiveBlock &, unsigned int *, ArchiveRows &) const;
+
+    unsigned long long rows;
+    vector<ArchiveStudent> students;            // sorted by ID
+    vector<ArchiveCourse> courses;              // sorted by code
+    vector<ArchiveBlock> blocks;
+    vector<unsigned long long> words;           // packed columns of every block
+
+};
+
+#endif //DSPROJ_TERMARCHIVE_H
@@ -0,0 +1,131 @@
+#include "TermDirectory.h"
+#include "Sharding.h"
+
+using namespace std;
+
+
+TermDirectory::TermDirectory(const vector<string> &studentLines) : pool(thread::hardware_concurrency()) {
+    currentTerm = nullptr;
+    shard = 0;
+    numberOfShards = 1;
+
+    for (const string &line: studentLines) {
+        profiles.push_back(make_shared<StudentProfile>());
+        Student(line).toRecord(*profiles.back());
+    }
+}
+
+
+TermDirectory::TermDirectory(LListWithDummyNode<Mapped<StudentRecord>> &studentRecords, int shard,
+                             int numberOfShards)
+        : pool(thread::hardware_concurrency()), shard(shard), numberOfShards(numberOfShards) {
+    currentTerm = nullptr;
+
+    // the records are in the order of the lines of Student.txt, the other shards only map theirs. The profile
+    // doesn't own its record (empty aliasing shared_ptr), the mapping holds it
+    studentRecords.forEach([this](StudentRecord &record) {
+        if (this->numberOfShards <= 1 || shardOf(record.studentID, this->numberOfShards) == this->shard)
+            profiles.push_back(shared_ptr<StudentProfile>(shared_ptr<StudentProfile>(), &record));
+    });
+}
+
+
+Term &TermDirectory::openTerm(const string &name, const string &fileSuffix, const vector<string> &courseLines) {
+    unique_ptr<Term> term = newTerm(name, fileSuffix);
+    for (const string &line: courseLines)
+        term->courses.insertAtBegin(Course(line));
+    return addTerm(move(term));
+}
+
+
+Term &TermDirectory::openTerm(const string &name, const string &fileSuffix,
+                              const DoublyLinkedList<Mapped<CourseRecord>> &courseRecords) {
+    unique_ptr<Term> term = newTerm(name, fileSuffix);
+    courseRecords.forEach([&term](const CourseRecord &record) { term->courses.insertAtBegin(Course(record)); });
+    return addTerm(move(term));
+}
+
+
+unique_ptr<Term> TermDirectory::newTerm(const string &name, const string &fileSuffix) const {
+    unique_ptr<Term> term(new Term());
+    term->name = name;
+    term->fileSuffix = fileSuffix;
+
+    // same order as the lists built by main(): each student is inserted at the beginning
+    for (const shared_ptr<StudentProfile> &profile: profiles)
+        term->unregistered.insertAtBegin(Student(profile));
+    return term;
+}
+
+
+Term &TermDirectory::addTerm(unique_ptr<Term> term) {
+    term->registry.reset(new Registry(term->unregistered, term->registered, term->courses));
+
+    Term &opened = *term;
+    termIndex[opened.name] = &opened;
+    terms.push_back(move(term));
+    if (currentTerm == nullptr)
+        currentTerm = &opened;
+    return opened;
+}
+
+
+Term *TermDirectory::findTerm(const string &name) const {
+    auto itr = termIndex.find(name);
+    return itr == termIndex.end() ? nullptr : itr->second;
+}
+
+
+bool TermDirectory::switchTerm(const string &name) {
+    Term *term = findTerm(name);
+    if (term == nullptr)
+        return false;
+
+    currentTerm = term;
+    return true;
+}
+
+
+bool TermDirectory::closeTerm(const string &name) {
+    Term *term = findTerm(name);
+    if (term == nullptr || term == currentTerm)
+        return false;
+
+    termIndex.erase(name);
+    for (auto itr = terms.begin(); itr != terms.end(); ++itr)
+        if (itr->get() == term) {
+            terms.erase(itr);
+            break;
+        }
+    return true;
+}
+
+
+Term &TermDirectory::getCurrentTerm() const {
+    return *currentTerm;
+}
+
+
+int TermDirectory::getNumberOfTerms() const {
+    return terms.size();
+}
+
+
+int TermDirectory::getNumberOfStudents() const {
+    return profiles.size();
+}
+
+
+WorkStealingPool &TermDirectory::getPool() {
+    return pool;
+}
+
+
+int TermDirectory::getShard() const {
+    return shard;
+}
+
+
+int TermDirectory::getNumberOfShards() const {
+    return numberOfShards;
+}
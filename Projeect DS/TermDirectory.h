@@ -0,0 +1,237 @@
+/**
+
+    @file TermDirectory.h
+    @brief Declaration of the TermDirectory class and its member functions.
+
+    This file contains the declaration of the TermDirectory class, which keeps several terms open at once (eg: the
+    current term, the next one and the summer) on top of a single set of students.
+
+    date 18 Oct 2026
+
+    Each Term owns its course list, its two student lists and the Registry working on them, so the enrollments,
+    the sections, the journal and the snapshots of a term never mix with those of another. The directory keeps one
+    StudentProfile per student; the lists of every term hold students sharing it: the ID, the names and the GPA
+    exist once, only the courses, credits and booked hours are per term.
+
+    The current term is a pointer to one of the terms, switching terms only changes it.
+
+    The students and the courses of a term can also come from mapped lists (Student.map and Course.map, see
+    MappedNodes.h), which skips parsing the text files at every start. The profiles then are the records of
+    Student.map themselves, the students of the terms point into the mapping and nothing is copied. The courses
+    are still built in every term from the records of Course.map, their seats and students being per term.
+
+    The directory also owns the WorkStealingPool which spreads the read only work of every term over the cores: the
+    rosters displayed by the menu and the runs of lookups of the server and of the scripts.
+
+    A directory may hold a single shard of the students (see Sharding.h): only the students whose ID falls in
+    its shard are kept, every term offers all its courses to them.
+
+    Public Member Functions:
+        1. TermDirectory(const vector<string> &)
+        2. openTerm(const string &, const string &, const vector<string> &): Term &
+        3. findTerm(const string &) const: Term *
+        4. switchTerm(const string &): bool
+        5. getCurrentTerm() const: Term &
+        6. getNumberOfTerms() const: int
+        7. getNumberOfStudents() const: int
+        8. forEach(Function) const: void
+        9. closeTerm(const string &): bool
+        10. TermDirectory(LListWithDummyNode<Mapped<StudentRecord>> &, int, int)
+        11. openTerm(const string &, const string &, const DoublyLinkedList<Mapped<CourseRecord>> &): Term &
+        12. getPool(): WorkStealingPool &
+        13. getShard() const: int
+        14. getNumberOfShards() const: int
+*/
+
+#ifndef DSPROJ_TERMDIRECTORY_H
+#define DSPROJ_TERMDIRECTORY_H
+
+#include "Registry.h"
+#include "Student.h"
+#include "Course.h"
+#include "LListWithDummyNode.h"
+#include "DoublyLinkedList.h"
+#include "WorkStealingPool.h"
+
+#include <string>
+#include <vector>
+#include <memory>
+#include <unordered_map>
+
+using namespace std;
+
+// one term open for registration, with its own courses and enrollments
+struct Term {
+    string name;                               // eg: SUMMER
+    string fileSuffix;                         // added to the names of the data files of the term, eg: "-SUMMER"
+    LListWithDummyNode<Student> unregistered;  // students of the term without a course in the term
+    LListWithDummyNode<Student> registered;    // students of the term with at least one course in the term
+    DoublyLinkedList<Course> courses;          // courses offered in the term
+    unique_ptr<Registry> registry;             // registrations of the term, built on the three lists above
+};
+
+class TermDirectory {
+public:
+
+    /**
+ * @brief Constructor for the TermDirectory class.
+ *
+ * @param studentLines One line per student in the format of Student.txt.
+ *
+ * @pre None.
+ *
+ * @post The directory holds one profile per line and no term is open yet. The pool has one thread per core.
+ */
+    TermDirectory(const vector<string> &);
+
+    /**
+ * @brief Constructor for the TermDirectory class from the mapped student records.
+ *
+ * @param studentRecords One record per student, in the order of Student.txt.
+ * @param shard The shard of the students kept, from 0.
+ * @param numberOfShards The number of shards the students are split in, 1 keeps every student.
+ *
+ * @pre The list is open, outlives the directory and gets no insertion while the directory exists.
+ *       0 <= shard < numberOfShards.
+ *
+ * @post The directory holds one profile per record of the shard (shardOf), the record itself, and no term is
+ *       open yet. The pool has one thread per core.
+ */
+    TermDirectory(LListWithDummyNode<Mapped<StudentRecord>> &, int shard = 0, int numberOfShards = 1);
+
+    /**
+ * @brief Open a new term with its own courses.
+ *
+ * @param name The name of the term, eg: SUMMER.
+ * @param fileSuffix Added to the names of the data files of the term, eg: "" for the first term and "-SUMMER".
+ * @param courseLines One line per course of the term in the format of Course.txt.
+ * @return Term & The term, whose registry is ready for loadPrerequisites, loadSections and recover.
+ *
+ * @pre No term has this name.
+ *
+ * @post Every student of the directory is unregistered in the term. The first term opened is the current term.
+ *
+ * @details The students of the term share the profiles of the directory, so the cost of a term is one pointer
+ * per student and no string is copied.
+ */
+    Term &openTerm(const string &, const string &, const vector<string> &);
+
+    /**
+ * @brief Open a new term with its own courses, read from mapped course records.
+ *
+ * @param name The name of the term, eg: CURRENT.
+ * @param fileSuffix Added to the names of the data files of the term.
+ * @param courseRecords One record per course of the term, in the order of the course file.
+ * @return Term & The term, as the other openTerm.
+ *
+ * @pre No term has this name and the list is open.
+ *
+ * @post As the other openTerm.
+ */
+    Term &openTerm(const string &, const string &, const DoublyLinkedList<Mapped<CourseRecord>> &);
+
+    /**
+ * @brief Find a term by name.
+ *
+ * @param name The name of the term.
+ * @return Term * The term, or nullptr if no term has this name.
+ */
+    Term *findTerm(const string &) const;
+
+    /**
+ * @brief Make another term the current term.
+ *
+ * @param name The name of the term.
+ * @return bool True if the term exists and is now current, false otherwise.
+ *
+ * @pre None.
+ *
+ * @post The menu works on the new current term. Nothing is copied or reloaded.
+ */
+    bool switchTerm(const string &);
+
+    /**
+ * @brief Get the current term.
+ *
+ * @return Term & The term the menu works on.
+ *
+ * @pre At least one term is open.
+ */
+    Term &getCurrentTerm() const;
+
+    /**
+ * @brief Get the number of open terms.
+ *
+ * @return int The number of terms.
+ */
+    int getNumberOfTerms() const;
+
+    /**
+ * @brief Get the number of students of the directory.
+ *
+ * @return int The number of students, the same in every term.
+ */
+    int getNumberOfStudents() const;
+
+    /**
+ * @brief Call a function on every term, in the order they were opened.
+ *
+ * @param visit Called as visit(term) with a Term &.
+ */
+    template<typename Function>
+    void forEach(Function visit) const {
+        for (const unique_ptr<Term> &term: terms)
+            visit(*term);
+    }
+
+    /**
+ * @brief Close a term, eg: once it was archived.
+ *
+ * @param name The name of the term.
+ * @return bool True if the term was closed, false if there is no such term or it is the current term.
+ *
+ * @pre No view or reference of the term is used afterwards.
+ *
+ * @post The term, its lists and its registry are destroyed. The profiles and the other terms are untouched.
+ */
+    bool closeTerm(const string &);
+
+    /**
+ * @brief Get the pool running the read only work of the terms.
+ *
+ * @return WorkStealingPool & The pool, with one thread per core counting the caller.
+ */
+    WorkStealingPool &getPool();
+
+    /**
+ * @brief Get the shard of the students of the directory.
+ *
+ * @return int The shard, 0 when the students aren't sharded.
+ */
+    int getShard() const;
+
+    /**
+ * @brief Get the number of shards the students are split in.
+ *
+ * @return int The number of shards, 1 when the directory holds every student.
+ */
+    int getNumberOfShards() const;
+
+private:
+    // A new term with a student per profile and no course
+    unique_ptr<Term> newTerm(const string &, const string &) const;
+
+    // Build the registry of a term filled with its courses and add it to the directory
+    Term &addTerm(unique_ptr<Term>);
+
+    vector<shared_ptr<StudentProfile>> profiles;    // in the order of Student.txt, in Student.map when mapped
+    vector<unique_ptr<Term>> terms;             // in the order they were opened
+    unordered_map<string, Term *> termIndex;    // name -> term
+    Term *currentTerm;
+    WorkStealingPool pool;                      // shared by the terms, only for work reading the registries
+    int shard;
+    int numberOfShards;
+
+};
+
+#endif //DSPROJ_TERMDIRECTORY_H
@@ -0,0 +1,193 @@
+#include "WorkStealingPool.h"
+#include <algorithm>
+#include <chrono>
+#include <csignal>
+#include <iomanip>
+
+using namespace std;
+
+// pool of the calling thread when it is a worker, and its index in the pool
+static thread_local const WorkStealingPool *currentPool = nullptr;
+static thread_local int currentWorker = -1;
+
+
+WorkStealingPool::WorkStealingPool(int threads) : nextQueue(0), pending(0), executed(0), stolen(0) {
+    stopping = false;
+
+    for (int i = 1; i < threads; i++)
+        queues.emplace_back(new WorkerQueue());
+
+    // the workers start with every signal blocked, so SIGINT and SIGTERM reach the thread which waits for them,
+    // eg: the signalfd of the server, and never kill the process from a worker
+    sigset_t signals, previous;
+    sigfillset(&signals);
+    pthread_sigmask(SIG_BLOCK, &signals, &previous);
+    for (int i = 0; i + 1 < threads; i++)
+        workers.emplace_back(&WorkStealingPool::work, this, i);
+    pthread_sigmask(SIG_SETMASK, &previous, nullptr);
+}
+
+
+WorkStealingPool::~WorkStealingPool() {
+    {
+        lock_guard<mutex> lock(sleepMutex);
+        stopping = true;
+    }
+    wakeUp.notify_all();
+    for (thread &worker: workers)
+        worker.join();
+}
+
+
+void WorkStealingPool::parallelFor(size_t count, size_t minimumChunk, const function<void(size_t, size_t)> &body) {
+    size_t threads = workers.size() + 1;
+    size_t chunk = max(max(minimumChunk, (size_t) 1), (count + threads * POOL_CHUNKS_PER_THREAD - 1) /
+                                                      (threads * POOL_CHUNKS_PER_THREAD));
+    if (workers.empty() || count <= chunk) {
+        if (count > 0)
+            body(0, count);
+        return;
+    }
+
+    size_t remaining = (count + chunk - 1) / chunk;   // chunks not finished, counted down under doneMutex
+    for (size_t begin = 0; begin < count; begin += chunk) {
+        size_t end = min(count, begin + chunk);
+        push([this, &body, &remaining, begin, end]() {
+            body(begin, end);
+            lock_guard<mutex> lock(doneMutex);
+            if (--remaining == 0)
+                chunkDone.notify_all();
+        });
+    }
+
+    // the caller runs chunks as well, of this range or of any other, and only sleeps once none is left to take
+    int self = currentPool == this ? currentWorker : -1;
+    while (true) {
+        if (runOne(self))
+            continue;
+        unique_lock<mutex> lock(doneMutex);
+        chunkDone.wait(lock, [&remaining]() { return remaining == 0; });
+        break;
+    }
+}
+
+
+int WorkStealingPool::getNumberOfThreads() const {
+    return workers.size() + 1;
+}
+
+
+PoolStats WorkStealingPool::getStats() const {
+    PoolStats stats;
+    stats.executed = executed;
+    stats.stolen = stolen;
+    return stats;
+}
+
+
+void WorkStealingPool::work(int index) {
+    currentPool = this;
+    currentWorker = index;
+
+    while (true) {
+        if (runOne(index))
+            continue;
+
+        unique_lock<mutex> lock(sleepMutex);
+        wakeUp.wait(lock, [this]() { return stopping || pending > 0; });
+        if (stopping)
+            return;
+    }
+}
+
+
+void WorkStealingPool::push(function<void()> task) {
+    size_t index = currentPool == this ? currentWorker : nextQueue++ % queues.size();
+    {
+        WorkerQueue &queue = *queues[index];
+        lock_guard<mutex> lock(queue.queueMutex);
+        queue.tasks.push_back(move(task));
+    }
+
+    // the count changes under sleepMutex, so a worker about to sleep either sees it or gets the notification
+    {
+        lock_guard<mutex> lock(sleepMutex);
+        pending++;
+    }
+    wakeUp.notify_one();
+}
+
+
+bool WorkStealingPool::runOne(int self) {
+    function<void()> task;
+
+    if (self >= 0) {
+        WorkerQueue &queue = *queues[self];
+        lock_guard<mutex> lock(queue.queueMutex);
+        if (!queue.tasks.empty()) {
+            task = move(queue.tasks.back());
+            queue.tasks.pop_back();
+        }
+    }
+
+    // the victims are visited from the next deque, so the thieves don't all start on the same one
+    size_t first = self >= 0 ? self + 1 : 0;
+    for (size_t i = 0; !task && i < queues.size(); i++) {
+        size_t victim = (first + i) % queues.size();
+        if ((int) victim == self)
+            continue;
+        WorkerQueue &queue = *queues[victim];
+        lock_guard<mutex> lock(queue.queueMutex);
+        if (!queue.tasks.empty()) {
+            task = move(queue.tasks.front());
+            queue.tasks.pop_front();
+            if (self >= 0)
+                stolen++;
+        }
+    }
+
+    if (!task)
+        return false;
+    pending--;
+    task();
+    executed++;
+    return true;
+}
+
+
+void benchmarkPool(size_t items, const function<size_t(size_t)> &read, ostream &out) {
+    int cores = max(1u, thread::hardware_concurrency());
+    vector<int> threadCounts;
+    for (int threads = 1; threads < cores; threads *= 2)
+        threadCounts.push_back(threads);
+    threadCounts.push_back(cores);
+
+    out << left << setw(10) << "Threads" << setw(16) << "Reads/s" << setw(10) << "Speedup" << setw(10) << "Stolen"
+        << endl;
+
+    double singleThread = 0;
+    for (int threads: threadCounts) {
+        WorkStealingPool pool(threads);
+        atomic<size_t> sink(0);
+        unsigned long long reads = 0;
+
+        auto start = chrono::steady_clock::now();
+        double seconds = 0;
+        while (seconds < 1) {
+            pool.parallelFor(items, PARALLEL_CHUNK_REQUESTS, [&read, &sink](size_t begin, size_t end) {
+                size_t value = 0;
+                for (size_t i = begin; i < end; i++)
+                    value += read(i);
+                sink += value;
+            });
+            reads += items;
+            seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+        }
+
+        double perSecond = reads / seconds;
+        if (threads == 1)
+            singleThread = perSecond;
+        out << left << setw(10) << threads << setw(16) << fixed << setprecision(0) << perSecond << setw(10)
+            << setprecision(2) << perSecond / singleThread << setw(10) << pool.getStats().stolen << endl;
+    }
+}
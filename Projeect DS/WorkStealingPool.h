@@ -0,0 +1,168 @@
+/**
+
+    @file WorkStealingPool.h
+    @brief Declaration of the WorkStealingPool class and its member functions.
+
+    This file contains the declaration of the WorkStealingPool class, a set of threads which run the read only work
+    of the registry (lookups of students and courses, rosters) on every core.
+
+    date 18 Oct 2026
+
+    Each worker has its own deque of tasks. A worker takes the task it added last from the back of its own deque,
+    which is still warm in its cache, and when its deque is empty it steals the oldest task from the front of the
+    deque of another worker. A worker never waits while another one has tasks left, and the deques are only shared
+    when a worker runs out, so the workers rarely touch the same lock.
+
+    The work is given with parallelFor: the range is cut in chunks of at least a minimum size, about
+    POOL_CHUNKS_PER_THREAD chunks per thread, which are spread over the deques, and the calling thread runs chunks
+    too until the whole range is done. A chunk may call parallelFor itself: the new chunks go to the back of the
+    deque of its worker and the idle workers steal them.
+
+    The pool never locks the registry: a parallelFor must only read it and is called by the thread which makes the
+    registrations (the menu, CommandProcessor::run or the loop of RegistrationServer), which waits for the range,
+    so nothing changes while the chunks run.
+
+    Public Member Functions:
+        1. WorkStealingPool(int)
+        2. ~WorkStealingPool()
+        3. parallelFor(size_t, size_t, const function<void(size_t, size_t)> &): void
+        4. getNumberOfThreads() const: int
+        5. getStats() const: PoolStats
+
+    Free Functions:
+        1. benchmarkPool(size_t, const function<size_t(size_t)> &, ostream &): void
+*/
+
+#ifndef DSPROJ_WORKSTEALINGPOOL_H
+#define DSPROJ_WORKSTEALINGPOOL_H
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+using namespace std;
+
+// a range is cut in about this many chunks per thread, so a thread that finishes early steals the rest
+const size_t POOL_CHUNKS_PER_THREAD = 4;
+
+// a run of fewer read only requests in a row is answered on the calling thread, handing it over costs more
+const size_t PARALLEL_RUN_LENGTH = 64;
+
+// smallest number of read only requests given to one thread of the pool at once
+const size_t PARALLEL_CHUNK_REQUESTS = 32;
+
+// what the pool did since it started
+struct PoolStats {
+    unsigned long long executed = 0;    // chunks run by the workers and the callers
+    unsigned long long stolen = 0;      // chunks a worker took from the deque of another worker
+};
+
+class WorkStealingPool {
+public:
+
+    /**
+ * @brief Constructor for the WorkStealingPool class.
+ *
+ * @param threads The number of threads running a range, counting the caller of parallelFor, eg:
+ *                thread::hardware_concurrency(). With 1 or less the caller runs every range alone.
+ *
+ * @pre None.
+ *
+ * @post threads - 1 workers are started, each one waiting for tasks in its own deque.
+ */
+    WorkStealingPool(int);
+
+    /**
+ * @brief Destructor for the WorkStealingPool class.
+ *
+ * @pre No parallelFor is running.
+ *
+ * @post The workers are stopped and joined.
+ */
+    ~WorkStealingPool();
+
+    WorkStealingPool(const WorkStealingPool &) = delete;
+    WorkStealingPool &operator=(const WorkStealingPool &) = delete;
+
+    /**
+ * @brief Run a function over a range of indexes on the threads of the pool.
+ *
+ * @param count The number of indexes, the range is [0, count).
+ * @param minimumChunk The smallest number of indexes given to a thread at once, eg: PARALLEL_CHUNK_REQUESTS.
+ * @param body Called with [begin, end) for every chunk, from any thread of the pool and the caller.
+ *
+ * @pre The body may be called by several threads at once, it must only read what is shared.
+ *
+ * @post body was called exactly once for every chunk, the chunks cover the range without overlapping.
+ *
+ * @details A range of a single chunk, or a pool without workers, runs on the caller without any handover.
+ */
+    void parallelFor(size_t, size_t, const function<void(size_t, size_t)> &);
+
+    /**
+ * @brief Get the number of threads running a range.
+ *
+ * @return int The number of workers plus the caller.
+ */
+    int getNumberOfThreads() const;
+
+    /**
+ * @brief Get the number of chunks run and stolen.
+ *
+ * @return PoolStats The counters since the construction.
+ */
+    PoolStats getStats() const;
+
+private:
+    // the tasks of one worker, the worker takes from the back and the thieves from the front
+    struct WorkerQueue {
+        mutex queueMutex;
+        deque<function<void()>> tasks;
+    };
+
+    // Loop of a worker: run its own tasks, steal when it has none, sleep when no deque has any
+    void work(int);
+
+    // Add a task to the deque of the calling worker, or to the next deque for a thread outside the pool
+    void push(function<void()>);
+
+    // Take a task, from the back of the deque of the caller first and from the front of the others then, and run it
+    bool runOne(int);
+
+    vector<unique_ptr<WorkerQueue>> queues;     // one per worker
+    vector<thread> workers;
+    atomic<size_t> nextQueue;                   // deque of the next task pushed from outside the pool
+    atomic<long long> pending;                  // tasks waiting in the deques
+
+    mutex sleepMutex;                           // protects stopping, the workers sleep on wakeUp with it
+    condition_variable wakeUp;
+    bool stopping;
+
+    mutex doneMutex;                            // the chunks of a range are counted down with it
+    condition_variable chunkDone;
+
+    atomic<unsigned long long> executed;
+    atomic<unsigned long long> stolen;
+
+};
+
+/**
+ * @brief Measure the reads per second of a read only function on 1 thread up to every core.
+ *
+ * @param items The number of indexes of one round, eg: the number of students.
+ * @param read Called with an index of the round, returns any value so the work can't be optimized away.
+ * @param out The table of the results: threads, reads per second, speedup over 1 thread and chunks stolen.
+ *
+ * @pre read only reads what is shared.
+ *
+ * @post Each number of threads ran rounds for one second on its own pool.
+ */
+void benchmarkPool(size_t, const function<size_t(size_t)> &, ostream &);
+
+#endif //DSPROJ_WORKSTEALINGPOOL_H
@@ -2,35 +2,54 @@
 #include <limits>
 #include <fstream>
 #include <vector>
+#include <map>
+#include <thread>
+#include <chrono>
+#include <algorithm>
+#include <cmath>
 #include "Course.h"
 #include "Student.h"
 #include "DoublyLinkedList.h"
 #include "LListWithDummyNode.h"
+#include "Registry.h"
+#include "RegistrationScheduler.h"
+#include "Journal.h"
+#include "TermDirectory.h"
+#include "TermArchive.h"
+#include "CommandProcessor.h"
+#include "RegistrationServer.h"
+#include "SharedReplica.h"
+#include "Sharding.h"
+#include <sstream>
+#include <sys/stat.h>
 
 
 using namespace std;
 
+// number of options in the main menu
+const int NUMBER_OF_OPTIONS = 18;
+
 
 //----- user interaction functions ------
 /**
  * @brief Display the menu of options and prompt the user to choose an option.
  *
  * This function displays a menu of registration system options, prompts the user to enter a choice,
- * and validates the input. It ensures that the entered choice is a valid integer between 1 and 10.
+ * and validates the input. It ensures that the entered choice is a valid integer between 1 and NUMBER_OF_OPTIONS.
  *
  * @param out The output stream to display the menu.
  * @param in The input stream to take the user's choice.
  *
- * @return An integer representing the user's choice (between 1 and 10).
+ * @return An integer representing the user's choice (between 1 and NUMBER_OF_OPTIONS).
  *
  * @pre The output stream (out) and input stream (in) must be open and valid.
  *
  * @post The user's choice is validated, and the selected option is returned.
  *       The input stream is cleared, and any invalid input is ignored.
  *
- * @details The function prints a menu with 10 options related to the registration system.
+ * @details The function prints a menu with NUMBER_OF_OPTIONS options related to the registration system.
  *          It then prompts the user to enter a choice and validates the input. If the input is not a valid integer
- *          or falls outside the range of 1 to 10, the user is informed of the error, and they are prompted again
+ *          or falls outside the range of 1 to NUMBER_OF_OPTIONS, the user is informed of the error, and they are prompted again
  *          until a valid choice is entered. The chosen option is then returned.
  */
 int displayMenuAndTakeOption(ostream &out, istream &in);
@@ -48,12 +67,47 @@ int displayMenuAndTakeOption(ostream &out, istream &in);
  * an error message is shown as well. Any other exceptions are caught and reported as general errors.
  *
  * @param filename The name of the file to be read.
+ * @param optional True if the file may be missing, eg: Prerequisite.txt: a missing file is then read as empty.
  * @return An array of strings containing the parsed content from the file, or nullptr on failure.
  *
  * @note The returned array is dynamically allocated, and it is the caller's responsibility to free the memory
  *       when it is no longer needed to prevent memory leaks.
  */
-vector<string> readFileAndParseContent(string, const string &);
+vector<string> readFileAndParseContent(string, const string &, bool optional = false);
+
+/**
+ * @brief Open the mapped list of the records of a data file, importing the data file when the list is out of date.
+ *
+ * @tparam Element Student or Course, built from a line of the data file and turned into a record.
+ * @tparam List LListWithDummyNode or DoublyLinkedList, with the mapped storage of MappedNodes.h.
+ * @param records The list, not open yet.
+ * @param title The name of a line of the data file, eg: Student.
+ * @param textPath The path of the data file, eg: Student.txt.
+ * @param mapPath The path of the file of the list, eg: Student.map.
+ *
+ * @pre None.
+ *
+ * @post The list holds one record per line of the data file, in the same order, except the invalid lines and the
+ *       lines with an ID, a name or a title longer than the field of the record, which are skipped with a message on the standard error
+ *       stream (cerr). The data file is only read when the list is empty or the data file was changed after the
+ *       list was written, eg: by option 13. The program ends if the list can't be mapped.
+ */
+template<typename Element, typename Record, template<typename> class List>
+void openMappedRecords(List<Mapped<Record>> &, const string &, const string &, const string &);
+
+/**
+ * @brief Write the list of the open terms back to Term.txt.
+ *
+ * @param terms The open terms, CURRENT is left out: it is opened from the original data files at every start.
+ * @param path The path of Term.txt.
+ * @return bool True if the file was written, false if it still holds the previous list.
+ *
+ * @pre None.
+ *
+ * @post The file starts with the number of terms, followed by one name per line, so a term closed since the start
+ *       is not opened again at the next one.
+ */
+bool writeTermFile(const TermDirectory &, const string &);
 
 //----------------------------------------------------------------------------------------------------------------------
 
@@ -94,7 +148,8 @@ void option1(const LListWithDummyNode<Student> &);
  *       The console pauses, waiting for the user to press enter before proceeding.
  *
  * @details The function uses the overloaded '<<' operator to display the contents of the doubly linked list.
- *          The formatting includes columns for course code, title, number of credits, number of enrolled students, and capacity.
+ *          The formatting includes columns for course code, title, number of credits, number of enrolled students, capacity
+ *          and meeting times.
  *          The function utilizes the '_getch()' function to wait for user input before returning.
  */
 void option2(const DoublyLinkedList<Course> &);
@@ -102,43 +157,45 @@ void option2(const DoublyLinkedList<Course> &);
 /**
  * @brief Display the list of registered students with their registered courses.
  *
- * This function takes a constant reference to a linked list of registered students and displays
- * their information along with the courses they are registered for. If there are no registered students,
- * an appropriate message is displayed.
+ * This function pins a version of the enrollments and displays every registered student of it along with
+ * the courses they are registered for. If there are no registered students, an appropriate message is displayed.
  *
- * @param registeredList A constant reference to the linked list of registered students.
+ * @param registry A constant reference to the registry holding the students and the courses.
  *
- * @pre The 'registeredList' parameter is a valid linked list containing instances of the 'Student' class.
+ * @pre None.
  *
  * @post The information about registered students and their courses is displayed on the console.
  *       If no students are registered, an appropriate message is displayed.
  *       The console pauses, waiting for the user to press enter before proceeding.
  *
- * @details The function iterates through the registered students in the linked list and displays their registered courses.
+ * @details The function reads a RegistryView pinned by Registry::pinView, so the registrations continue during the
+ *          display and every student is shown at the same point of the registrations, ordered by student ID.
  *          If there are no registered students, an appropriate error message is displayed.
  *          The function utilizes the '_getch()' function to wait for user input before returning.
  */
-void option3(const LListWithDummyNode<Student> &);
+void option3(const Registry &);
 
 
 /**
  * @brief Display the list of offered courses with the registered students.
  *
- * This function takes a constant reference to a doubly linked list of courses and displays
- * information about each course, including the students registered for that course.
+ * This function pins a version of the enrollments and displays information about each course of it,
+ * including the students registered for that course.
  *
- * @param List A constant reference to the doubly linked list of courses.
+ * @param registry A constant reference to the registry holding the students and the courses.
+ * @param pool The pool writing the rosters of the courses on every core.
  *
- * @pre The 'List' parameter is a valid doubly linked list containing instances of the 'Course' class.
+ * @pre None.
  *
  * @post The information about each offered course and the students registered for those courses is displayed on the console.
  *       The console pauses, waiting for the user to press enter before proceeding.
  *
- * @details The function iterates through the courses in the doubly linked list and calls the 'displayRegisteredStudents'
- *          function for each course to show the list of students registered for that course.
+ * @details The function reads a RegistryView pinned by Registry::pinView and shows every course the way
+ *          'displayRegisteredStudents' does, so the registrations continue during the display and every roster
+ *          is shown at the same point of the registrations. The rosters are written on the threads of the pool.
  *          The function utilizes the '_getch()' function to wait for user input before returning.
  */
-void option4(const DoublyLinkedList<Course> &);
+void option4(const Registry &, WorkStealingPool &);
 
 /**
  * @brief Display the registered courses for a student.
@@ -216,33 +273,29 @@ void option7(const LListWithDummyNode<Student> &);
  * @brief Register courses for an unregistered student and move them to the registered list.
  *
  * This function guides the user through the process of registering courses for a specified unregistered student.
- * The user is prompted to enter the student ID and the course codes they want to register. The function validates
- * the input and checks various conditions, such as course availability, student credit limits, and probation status,
- * before registering the student for the selected courses. If successful, the student is moved from the unregistered
- * list to the registered list, and their course registration details are updated.
+ * The user is prompted to enter the student ID and the course codes they want to register. Once the user is done,
+ * the courses are registered together as one bundle through the registry: either every course is registered, or,
+ * if one of them is not offered, full, already taken or over the student credit limit, none of them is.
+ * If successful, the student is moved from the unregistered list to the registered list.
  *
- * @param unregistered A reference to the list of unregistered students.
- * @param registered A reference to the list of registered students.
- * @param courseList A reference to the list of available courses.
+ * @param registry A reference to the registry holding the students and the courses.
  *
- * @pre The 'unregistered', 'registered', and 'courseList' parameters are valid linked lists.
+ * @pre The registry was built from the lists of students and courses.
  *
- * @post The selected unregistered student is registered for the specified courses.
+ * @post The selected unregistered student is registered for all the specified courses, or for none of them.
  *       The student is moved from the unregistered list to the registered list.
  *       The course enrollment information is updated.
  *       The console displays success messages or appropriate error messages.
  *       The console pauses, waiting for the user to press enter before proceeding.
  *
  * @details The function uses a do-while loop to prompt the user for a valid student ID format.
- *          It then converts the entered student ID to uppercase and searches for the student in the 'unregistered'
- *          list using the 'searchAndRetreivePtr' function. If the student is found, the function proceeds to
- *          prompt the user for course codes to register. Various conditions are checked, including course availability,
- *          student credit limits, and probation status, before registering the student for the selected courses.
- *          The function also handles user input to register additional courses and updates the student and course lists accordingly.
- *          Upon successful registration, the student is moved to the 'registered' list, and their information is updated.
+ *          It then converts the entered student ID to uppercase and looks the student up in the registry.
+ *          If the student is found and unregistered, the function collects the course codes to register until
+ *          the user chooses to stop, then calls 'registerBundle'. On failure, the course that made the bundle fail
+ *          and the reason are displayed.
  *          The function utilizes the '_getch()' function to wait for user input before returning.
  */
-void option8(LListWithDummyNode<Student> &, LListWithDummyNode<Student> &, DoublyLinkedList<Course> &);
+void option8(Registry &);
 
 /**
  * @brief Add or drop courses for a registered student.
@@ -254,11 +307,9 @@ void option8(LListWithDummyNode<Student> &, LListWithDummyNode<Student> &, Doubl
  * the course and updates the student's course list. The function continues to prompt the user for additional courses
  * until the user chooses to stop. If the student has no remaining courses, they are moved back to the unregistered list.
  *
- * @param registeredList A reference to the list of registered students.
- * @param unregistered A reference to the list of unregistered students.
- * @param courseList A reference to the list of available courses.
+ * @param registry A reference to the registry holding the students and the courses.
  *
- * @pre The 'registeredList', 'unregistered', and 'courseList' parameters are valid linked lists.
+ * @pre The registry was built from the lists of students and courses.
  *
  * @post The selected registered student's course list is updated based on user choices.
  *       The student may be moved from the registered list to the unregistered list if they drop all their courses.
@@ -266,15 +317,15 @@ void option8(LListWithDummyNode<Student> &, LListWithDummyNode<Student> &, Doubl
  *       The console pauses, waiting for the user to press enter before proceeding.
  *
  * @details The function uses a do-while loop to prompt the user for a valid student ID format.
- *          It then converts the entered student ID to uppercase and searches for the student in the 'registeredList'
- *          using the 'searchAndRetreivePtr' function. If the student is found, the function proceeds to display the
- *          student's registered courses and prompts the user to add or drop courses. Depending on the user's choice,
- *          the function validates input, checks various conditions, and either registers or drops the selected course.
+ *          It then converts the entered student ID to uppercase and looks the student up in the registry.
+ *          If the student is registered, the function proceeds to display the student's registered courses and
+ *          prompts the user to add or drop courses. Depending on the user's choice, the function calls 'addCourse'
+ *          or 'dropCourse' of the registry, which checks the conditions and updates the student and the course.
  *          The function continues to prompt the user for additional courses until the user chooses to stop.
  *          If the student has no remaining courses, they are moved back to the 'unregistered' list.
  *          The function utilizes the '_getch()' function to wait for user input before returning.
  */
-void option9(LListWithDummyNode<Student> &, LListWithDummyNode<Student> &, DoublyLinkedList<Course> &);
+void option9(Registry &);
 
 /**
  * @brief Exit the registration system and display contact information.
@@ -283,44 +334,356 @@ void option9(LListWithDummyNode<Student> &, LListWithDummyNode<Student> &, Doubl
  * for assistance. The contact details include a phone number and email address. Upon execution, the function prints
  * the message and terminates the program using the 'exit' function.
  *
+ * @param terms A reference to the open terms.
+ *
  * @pre None.
  *
  * @post The registration system is terminated, and the thank-you message with contact information is displayed.
- *       The program exits successfully.
+ *       A snapshot of the enrollments of every term is written so the next start only replays the journal written
+ *       after it. The program exits successfully.
  *
  * @details The function prints a thank-you message for using the registration service and provides contact information
  *          for users who may need assistance. The phone number and email address are included in the message.
  *          The 'exit' function is then called to terminate the program.
  */
-void option10();
+void option10(const TermDirectory &);
 
-int main() {
+/**
+ * @brief Open a registration window from a file of queued registration requests.
+ *
+ * This function prompts the user for the path of a requests file, queues every request it contains in a
+ * RegistrationScheduler and applies them in priority order: oldest cohort first, then highest GPA, then
+ * the order of the requests in the file. Each request registers its courses all or nothing.
+ *
+ * @param registry A reference to the registry holding the students and the courses.
+ *
+ * @pre The requests file follows the format of the other files: the number of requests on the first line,
+ *      then one request per line made of a student ID followed by the course codes, separated by spaces.
+ *
+ * @post Every request of the file was applied. The console displays the number of registered and refused
+ *       requests for each reason and the time taken.
+ *       The console pauses, waiting for the user to press enter before proceeding.
+ *
+ * @details If the file can't be opened an error message is displayed and nothing is registered.
+ *          The requests are applied in batches of REGISTRATION_BATCH_SIZE.
+ */
+void option11(Registry &);
 
-    // stores the raw lines in the vector from the Student.txt file
-    vector<string> studentFileContent = readFileAndParseContent("Student",
-                                                                "C:\\Users\\johnn\\CLionProjects\\DsProject\\Student.txt");
-    // stores the raw lines in the vector from the Couurse.txt file
-    vector<string> courseFileContent = readFileAndParseContent("Course",
-                                                               "C:\\Users\\johnn\\CLionProjects\\DsProject\\Course.txt");
+/**
+ * @brief Write a checkpoint of the enrollments in the background.
+ *
+ * This function starts a checkpoint of every enrollment to the snapshot file and returns right away, the
+ * checkpoint is written by another thread while the menu and the registrations continue.
+ *
+ * @param registry A reference to the registry holding the students and the courses.
+ *
+ * @pre None.
+ *
+ * @post A checkpoint is being written, unless one was already running. The console displays the figures of the
+ *       last completed checkpoint: how long the registrations were paused to capture it and how long it took.
+ *       The console pauses, waiting for the user to press enter before proceeding.
+ */
+void option12(Registry &);
 
-// creates a LInkedList to store unregistered students.
-    LListWithDummyNode<Student> *unregisteredStudents = new LListWithDummyNode<Student>();
+/**
+ * @brief Save the students, the courses and the enrollments back to the data files.
+ *
+ * This function writes Student.txt, Course.txt, Section.txt and Enrollment.txt in the directory of the data files,
+ * see Registry::exportText. The files of a term other than the first one end with its name, eg: Course-SUMMER.txt.
+ *
+ * @param term A reference to the current term.
+ *
+ * @pre None.
+ *
+ * @post The data files of the term hold the current state of its registry. The console displays the time taken.
+ *       The console pauses, waiting for the user to press enter before proceeding.
+ */
+void option13(Term &);
 
-// creates a LinkedList to store registered students.
-    LListWithDummyNode<Student> *registeredStudents = new LListWithDummyNode<Student>();
+/**
+ * @brief Compact the journal into a fresh snapshot in the background.
+ *
+ * This function starts folding the journal into the snapshot file and returns right away, the compaction runs on
+ * another thread at a bounded disk bandwidth while the menu and the registrations continue.
+ *
+ * @param registry A reference to the registry holding the students and the courses.
+ *
+ * @pre None.
+ *
+ * @post A compaction is running, unless a checkpoint or a compaction was already running. The console displays the
+ *       figures of the last completed compaction: the records folded, the live enrollments kept and how long it took.
+ *       The console pauses, waiting for the user to press enter before proceeding.
+ */
+void option14(Registry &);
 
-// creates a doublyLinkedList to store the courses
-    DoublyLinkedList<Course> *courseList = new DoublyLinkedList<Course>();
+/**
+ * @brief Reload the course catalog from Course.txt without restarting.
+ *
+ * This function reads the course file of the current term again (Course.txt for the first term) and applies the new
+ * courses and the changed titles, credits, capacities and meeting times to its registry, see Registry::reloadCourses.
+ *
+ * @param term A reference to the current term.
+ *
+ * @pre None.
+ *
+ * @post The courses match the course file and keep their registered students. The console displays the number of
+ *       courses added and changed.
+ *       The console pauses, waiting for the user to press enter before proceeding.
+ */
+void option15(Term &);
 
-// takes the raw strings and uses the constructor with string argument to assign the Student attributes then stores
-// them in 'unregistered'
-    for (int i = 0; i < studentFileContent.size(); i++)
-        unregisteredStudents->insertAtBegin(*new Student(studentFileContent[i]));
+/**
+ * @brief Switch to another open term.
+ *
+ * This function lists the open terms, prompts the user for the name of a term and makes it the current term.
+ *
+ * @param terms A reference to the open terms.
+ *
+ * @pre None.
+ *
+ * @post The options of the menu work on the chosen term, or on the same term if the name is unknown.
+ *       The console pauses, waiting for the user to press enter before proceeding.
+ *
+ * @details Switching only changes the current term of the TermDirectory, nothing is copied or reloaded.
+ */
+void option16(TermDirectory &);
 
-// takes the raw strings and uses the constructor with string argument to assign the Course attributes then stores
-// them in 'courseList'
-    for (int i = 0; i < courseFileContent.size(); i++)
-        courseList->insertAtBegin(*new Course(courseFileContent[i]));
+/**
+ * @brief Archive a closed term, or summarize the archive of a term.
+ *
+ * This function prompts the user for the name of a term. An open term other than the current one is written to
+ * Archive-<name>.dsa as compressed columns and closed; a term which is not open is read back from its archive.
+ *
+ * @param terms A reference to the open terms.
+ *
+ * @pre None.
+ *
+ * @post The console displays the size of the archive, the time of a scan of it and its most followed courses.
+ *       The console pauses, waiting for the user to press enter before proceeding.
+ *
+ * @details The current term can't be archived, switch to another term first (option 16).
+ */
+void option17(TermDirectory &);
+
+/**
+ * @brief Find the students or the courses of the current term by their fields.
+ *
+ * This function prompts the user for a query, eg: "STUDENTS STATUS=PROBATION CREDITS=-8" or
+ * "COURSES PREFIX=CSIS SEATS=1-", with the same filters as the FIND command (see CommandProcessor.h).
+ *
+ * @param registry A reference to the registry of the current term.
+ *
+ * @pre None.
+ *
+ * @post The console displays the matching students or courses, their number, the index or scan used and the rows
+ *       it read. The console pauses, waiting for the user to press enter before proceeding.
+ *
+ * @details The query reads the QueryIndex of the registry, not the linked lists of options 1 and 2.
+ */
+void option18(Registry &);
+
+/**
+ * @brief Set up a term just opened and restore its enrollments.
+ *
+ * @param term The term, its file suffix is added to the names of its snapshot and journal, eg: Journal-SUMMER.bin.
+ * @param prerequisiteLines The prerequisites of the catalog, the same for every term.
+ * @param sectionLines The sections of the courses of the term.
+ * @param transcriptLines The courses completed by the students, the same for every term.
+ * @param shardSuffix Added after the file suffix of the term by a shard, eg: "-shard2", so each shard has its own
+ *                    snapshot and journal.
+ *
+ * @pre The term has no enrollment yet.
+ *
+ * @post The registry of the term checks the prerequisites, has its sections and its enrollments recovered from
+ *       its snapshot and journal. The console displays the figures of the recovery. The program ends if the
+ *       enrollments can't be restored, rather than run and journal on top of a partial state.
+ */
+void setUpTerm(Term &, const vector<string> &, const vector<string> &, const vector<string> &,
+               const string &shardSuffix = "");
+
+/**
+ * @brief Serve the open terms to other processes until SIGINT or SIGTERM.
+ *
+ * @param terms The open terms.
+ * @param address A socket path or a TCP port.
+ * @param replicas True to publish the terms in shared memory for the --replica readers.
+ * @return int The exit status of the program, 1 if the server couldn't start.
+ *
+ * @pre Every term is set up.
+ *
+ * @post The figures of the server are displayed and a snapshot of every term is saved.
+ */
+int serveTerms(TermDirectory &, const string &, bool);
+
+int main(int argc, char *argv[]) {
+
+    // measure the commits per second of the journal instead of running the menu: --bench-journal [scratch file]
+    if (argc > 1 && string(argv[1]) == "--bench-journal") {
+        benchmarkJournal(argc > 2 ? argv[2] : "journal-benchmark.bin", cout);
+        return 0;
+    }
+
+    // check that the enrollments survive a crash in the middle of a group commit instead of running the menu:
+    // --check-recovery [start of the scratch file paths]
+    if (argc > 1 && string(argv[1]) == "--check-recovery")
+        return checkCrashRecovery(argc > 2 ? argv[2] : "recovery-check", cout) ? 0 : 1;
+
+    // answer the lookups from the shared memory segment of a served term instead of running the menu:
+    // --replica [term], the commands are read from stdin and the data files are never read
+    if (argc > 1 && string(argv[1]) == "--replica") {
+        ios::sync_with_stdio(false);
+        // the first term, CURRENT, has no file suffix
+        string termName = argc > 2 ? toUpperCase(argv[2]) : "CURRENT";
+        ReplicaReader replica;
+        if (!replica.open(replicaPath(termName == "CURRENT" ? "" : "-" + termName)))
+            return 1;
+
+        string line, response;
+        while (getline(cin, line))
+            if (replica.answer(line, response))
+                cout << response << '\n';
+        cout.flush();
+        cerr << "Answered from version " << replica.getVersion() << " of the replica, " << replica.getRetries()
+             << " lookups read again." << endl;
+        return 0;
+    }
+
+    // run commands, one per line, instead of the menu: --script [file], the commands are read from stdin without file
+    bool scriptMode = argc > 1 && string(argv[1]) == "--script";
+    if (scriptMode)
+        ios::sync_with_stdio(false);
+    // in script mode the standard output only carries the answers, the messages of the start go to the error stream
+    streambuf *standardOutput = cout.rdbuf();
+    if (scriptMode)
+        cout.rdbuf(cerr.rdbuf());
+
+    // the students and the courses are mapped from Student.map and Course.map, Student.txt and Course.txt are only
+    // parsed when they are newer
+    LListWithDummyNode<Mapped<StudentRecord>> studentRecords;
+    openMappedRecords<Student>(studentRecords, "Student", "C:\\Users\\johnn\\CLionProjects\\DsProject\\Student.txt",
+                               "C:\\Users\\johnn\\CLionProjects\\DsProject\\Student.map");
+    DoublyLinkedList<Mapped<CourseRecord>> courseRecords;
+    openMappedRecords<Course>(courseRecords, "Course", "C:\\Users\\johnn\\CLionProjects\\DsProject\\Course.txt",
+                              "C:\\Users\\johnn\\CLionProjects\\DsProject\\Course.map");
+
+    // split the students over several processes counting the seats together: --shards <count> <socket path or
+    // TCP port>, shard i serves its students on shardAddress(address, i). The records are mapped before the fork,
+    // so the shards share their pages and Student.map is never rebuilt by several of them at once; the coordinator
+    // never builds a student
+    int shard = 0, numberOfShards = 1;
+    unique_ptr<ShardLink> shardLink;
+    if (argc > 3 && string(argv[1]) == "--shards") {
+        numberOfShards = atoi(argv[2]);
+        CapacityCoordinator coordinator;
+        int descriptor;
+        if (!coordinator.forkShards(numberOfShards, shard, descriptor))
+            return 1;
+
+        if (shard < 0) {
+            cout << "Coordinating " << numberOfShards << " shards on " << argv[3] << ", stop with Ctrl+C." << endl;
+            coordinator.run(cout);
+            const CoordinatorStats &stats = coordinator.getStats();
+            cout << stats.taken << " seats taken, " << stats.refused << " registrations refused as full and "
+                 << stats.released << " seats given back by " << stats.shards << " shards." << endl;
+            return 0;
+        }
+        shardLink.reset(new ShardLink(descriptor));
+    }
+    string shardSuffix = shardLink ? "-shard" + to_string(shard) : "";
+
+    // stores the raw lines in the vector from the Prerequisite.txt file, one course and its direct prerequisites per line
+    vector<string> prerequisiteFileContent = readFileAndParseContent("Prerequisite",
+                                                                     "C:\\Users\\johnn\\CLionProjects\\DsProject\\Prerequisite.txt",
+                                                                     true);
+    // stores the raw lines in the vector from the Section.txt file, one section of a course per line
+    vector<string> sectionFileContent = readFileAndParseContent("Section",
+                                                                "C:\\Users\\johnn\\CLionProjects\\DsProject\\Section.txt",
+                                                                true);
+    // stores the raw lines in the vector from the Transcript.txt file, one student and their completed courses per line
+    vector<string> transcriptFileContent = readFileAndParseContent("Transcript",
+                                                                   "C:\\Users\\johnn\\CLionProjects\\DsProject\\Transcript.txt",
+                                                                   true);
+
+// every term shares the students of Student.txt, each one has its own courses and registry
+    TermDirectory terms(studentRecords, shard, numberOfShards);
+
+// the first term uses the original data files, its registrations go to Journal.bin
+    setUpTerm(terms.openTerm("CURRENT", "", courseRecords), prerequisiteFileContent, sectionFileContent,
+              transcriptFileContent, shardSuffix);
+
+// the other terms are listed in Term.txt, a term X reads Course-X.txt and Section-X.txt and journals to Journal-X.bin
+    vector<string> termFileContent = readFileAndParseContent("Term",
+                                                             "C:\\Users\\johnn\\CLionProjects\\DsProject\\Term.txt", true);
+    for (const string &name: termFileContent) {
+        vector<string> termCourses = readFileAndParseContent(
+                "Course", "C:\\Users\\johnn\\CLionProjects\\DsProject\\Course-" + name + ".txt");
+        vector<string> termSections = readFileAndParseContent(
+                "Section", "C:\\Users\\johnn\\CLionProjects\\DsProject\\Section-" + name + ".txt", true);
+        setUpTerm(terms.openTerm(name, "-" + name, termCourses), prerequisiteFileContent, termSections,
+                  transcriptFileContent, shardSuffix);
+    }
+
+    // a shard takes the seats of its registrations from the coordinator, once every shard reported its own
+    if (shardLink) {
+        vector<unique_ptr<ShardSeats>> seats;
+        terms.forEach([&seats, &shardLink](Term &term) {
+            seats.emplace_back(new ShardSeats(*shardLink, term.name));
+            term.registry->setSeatCoordinator(seats.back().get());
+        });
+        if (!shardLink->reportSeats(terms))
+            return 1;
+        return serveTerms(terms, shardAddress(argv[3], shard), false);
+    }
+
+    // measure the lookups per second from 1 thread to every core instead of running the menu: --bench-reads
+    if (argc > 1 && string(argv[1]) == "--bench-reads") {
+        vector<string> studentIds, courseCodes;
+        studentRecords.forEach([&studentIds](const StudentRecord &record) { studentIds.push_back(record.studentID); });
+        courseRecords.forEach([&courseCodes](const CourseRecord &record) { courseCodes.push_back(record.courseCode); });
+        if (studentIds.empty() || courseCodes.empty())
+            return 1;
+
+        // one read in eight walks the roster of a course, the others look a student up as the STUDENT command
+        const Registry &registry = *terms.getCurrentTerm().registry;
+        benchmarkPool(studentIds.size(), [&](size_t i) -> size_t {
+            if (i % 8 == 0) {
+                Course *course = registry.findCourse(courseCodes[i / 8 % courseCodes.size()]);
+                size_t length = 0;
+                if (course != nullptr)
+                    for (auto itr = course->getRegisteredStudents().begin();
+                         itr != course->getRegisteredStudents().end(); ++itr)
+                        length += itr->first.length();
+                return length;
+            }
+            Student *student = registry.findStudent(studentIds[i]);
+            return student == nullptr ? 0 : student->getRegisteredCourse().size() + student->getNumberOfcredits();
+        }, cout);
+        return 0;
+    }
+
+    if (scriptMode) {
+        cout.rdbuf(standardOutput);
+        CommandProcessor processor(terms);
+        if (argc > 2) {
+            ifstream script(argv[2]);
+            if (!script.is_open()) {
+                cerr << "The script " << argv[2] << " can't be opened." << endl;
+                return 1;
+            }
+            processor.run(script, cout);
+        } else {
+            processor.run(cin, cout);
+        }
+
+        // as option 10, the snapshots only make the next start faster
+        terms.forEach([](Term &term) { term.registry->saveSnapshot(term.registry->getSnapshotPath()); });
+        return 0;
+    }
+
+    // serve the commands to other processes instead of running the menu: --serve <socket path or TCP port>,
+    // followed by --replicas to publish the terms in shared memory for the --replica readers
+    if (argc > 2 && string(argv[1]) == "--serve")
+        return serveTerms(terms, argv[2], argc > 3 && string(argv[3]) == "--replicas");
 
     cout << "Program Ready to run!!!" << endl << endl << endl;
     cout << "---------------------------------------------Welcome Back Dr Hamid!--------------------------------"
@@ -329,47 +692,77 @@ int main() {
     // Main menu loop
     // Preconditions:
     // - The 'displayMenuAndTakeOption' function must be properly implemented to display the menu and take a valid option.
-    // - 'unregisteredStudents', 'registeredStudents', and 'courseList' are assumed to be valid pointers to instances of their respective classes.
+    // - 'terms' holds at least one open term, the options work on the lists and the registry of the current term.
     // - 'option1' to 'option10' functions must be properly implemented to perform the corresponding actions based on the user's choice.
     //
     // Postconditions:
     // - The user is repeatedly presented with a menu until choosing option 10 to exit.
     // - Each option calls the corresponding function to perform the specified action.
-    // - The state of 'unregisteredStudents', 'registeredStudents', and 'courseList' may be modified based on user interactions.
+    // - The state of the lists of the current term may be modified based on user interactions.
     int option;
     do {
+        // option 16 changes the current term, the next options work on the new one
+        Term &term = terms.getCurrentTerm();
+        Registry &registry = *term.registry;
+        if (terms.getNumberOfTerms() > 1)
+            cout << "Current term: " << term.name << endl << endl;
+
         option = displayMenuAndTakeOption(cout, cin);
 
         switch (option) {
             case 1:
-                option1(*unregisteredStudents);
+                option1(term.unregistered);
                 break;
             case 2:
-                option2(*courseList);
+                option2(term.courses);
                 break;
             case 3:
-                option3(*registeredStudents);
+                option3(registry);
                 break;
             case 4:
-                option4(*courseList);
+                option4(registry, terms.getPool());
                 break;
             case 5:
-                option5(*registeredStudents, *unregisteredStudents);
+                option5(term.registered, term.unregistered);
                 break;
             case 6:
-                option6(*courseList);
+                option6(term.courses);
                 break;
             case 7:
-                option7(*registeredStudents);
+                option7(term.registered);
                 break;
             case 8:
-                option8(*unregisteredStudents, *registeredStudents, *courseList);
+                option8(registry);
                 break;
             case 9:
-                option9(*registeredStudents, *unregisteredStudents, *courseList);
+                option9(registry);
                 break;
             case 10:
-                option10();
+                option10(terms);
+                break;
+            case 11:
+                option11(registry);
+                break;
+            case 12:
+                option12(registry);
+                break;
+            case 13:
+                option13(term);
+                break;
+            case 14:
+                option14(registry);
+                break;
+            case 15:
+                option15(term);
+                break;
+            case 16:
+                option16(terms);
+                break;
+            case 17:
+                option17(terms);
+                break;
+            case 18:
+                option18(registry);
                 break;
         }
 
@@ -395,7 +788,7 @@ void option1(const LListWithDummyNode<Student> &List) {
 
 void option2(const DoublyLinkedList<Course> &List) {
     // prints a formated table column title for courses
-    printf("%-15s%-35s%-15s%-15s%-15s\n\n", "Code", "Title", "# Credit", "Enrolled", "Capacity");
+    printf("%-15s%-35s%-15s%-15s%-15s%-20s\n\n", "Code", "Title", "# Credit", "Enrolled", "Capacity", "Schedule");
     cout << List << endl;
     cout << "Press enter to proceed  <*__]" << endl;
     cin.ignore();
@@ -403,27 +796,22 @@ void option2(const DoublyLinkedList<Course> &List) {
 }
 
 
-void option3(const LListWithDummyNode<Student> &registeredList) {
-    if (registeredList.getSize() == 0) {
+void option3(const Registry &registry) {
+    RegistryView view = registry.pinView();
+    if (view.displayStudentCourses(cout) == 0) {
         cerr << "No student registered" << endl;
         cout << "Press enter to proceed  <*__]" << endl;
         cin.ignore();
         cin.get();
         return;
     }
-    for (int i = 0; i < registeredList.getSize(); i++) {
-        registeredList.retrieveAtIndex(i).displayRegisteredCourse();
-        cout << endl << endl;
-    }
     cout << endl << "Press enter to proceed  <*__]" << endl;
     cin.ignore();
     cin.get();
 }
 
-void option4(const DoublyLinkedList<Course> &List) {
-    for (int i = 0; i < List.getSize(); i++) {
-        List.retrieveAtIndex(i).displayRegisteredStudents();
-    }
+void option4(const Registry &registry, WorkStealingPool &pool) {
+    registry.pinView().displayCourseRosters(cout, &pool);
 
     cout << "Press enter to proceed  <*__]" << endl;
     cin.ignore();
@@ -519,14 +907,12 @@ void option7(const LListWithDummyNode<Student> &registeredList) {
 }
 
 
-void option8(LListWithDummyNode<Student> &unregistered,
-             LListWithDummyNode<Student> &registered,
-             DoublyLinkedList<Course> &courseList) {
+void option8(Registry &registry) {
 
     string courseId, studentId; // to store the courseid and studentid
     bool validS; // checks if the student id is valid
-    bool alreadytaken; // checks if the course has already been registered
     char choice; // takes Y or y and N or n to be able to register multiple courses
+    vector<string> bundle; // the course codes registered together once the user is done
 
 // making the user input the studentId and making sure it is in the valid format
     do {
@@ -543,18 +929,11 @@ void option8(LListWithDummyNode<Student> &unregistered,
     // making studentId capital so it can successfully search for other course with this id
     studentId = toUpperCase(studentId);
 
-    // creating a pointer to object student such as the id is equals to studentId
-    Student *resultStudent = unregistered.searchAndRetreivePtr(Student(NULL, studentId));
-
-
-    // checking to make sure we result student is pointing at  the object student we looking for
-    if (resultStudent == nullptr) {
-
-        // in case we don't find him in the unregistered list we check if the student is already registered
-        resultStudent = registered.searchAndRetreivePtr(Student(NULL, studentId));
+    // checking to make sure the student exists and is still in the unregistered list
+    if (registry.findStudent(studentId) == nullptr || registry.isRegistered(studentId)) {
 
         // we check if we got what we looking for if we don't we terminate the session in option 8
-        if (resultStudent == nullptr)
+        if (registry.findStudent(studentId) == nullptr)
             cerr << "The student you are looking for doesn't exists!" << endl;
         else
             cerr << "The student you are looking for exists but is already registered." << endl;
@@ -565,61 +944,11 @@ void option8(LListWithDummyNode<Student> &unregistered,
 
     }
 
-    // we are taking the input of the course we wanna register
+    // we are taking the input of the courses we wanna register
     do {
         cout << "Enter the course code: ";
         cin >> courseId;
-        courseId = toUpperCase(courseId);
-
-        // storing in a pointer the address of the object we looking for
-        Course *resultCourse = courseList.searchAndRetreivePtr(Course(NULL, courseId));
-
-        alreadytaken = false;
-
-        // we check if the course we wanna add is already registered by the student
-        for (int i = 0; i < resultStudent->getRegisteredCourse().size() && !alreadytaken; i++)
-            if (resultStudent->getRegisteredCourse()[i] == resultCourse->getCourseCode())
-                alreadytaken = true;
-
-        // making sure the value is valid
-        if (resultCourse != nullptr) {
-            if(alreadytaken)
-                cerr << "Course already registered!!!" << endl;
-            // making sure that the course capacity isn't full
-            else if (resultCourse->getCapacity() <= resultCourse->getNumberOfEnrolled()) {
-                cerr << "The course has already reached its maximum capacity!!" << endl;
-            }
-                // making sure that the regular student doesn't exceed 18 credits
-            else if (resultStudent->getNumberOfcredits() + resultCourse->getNumberOfCredits() > 12
-                     && resultStudent->getGpa() < 2) {
-                cerr << resultStudent->getFullName()
-                     << " has reached their maximum allowed credits this semester as "
-                        "they are in probation."
-                     << endl;
-            }
-                // making sure the student on probation hasn't exceeded 12 credits
-            else if (resultStudent->getNumberOfcredits() + resultCourse->getNumberOfCredits() > 18
-                     && resultStudent->getGpa() >= 2) {
-                cerr << resultStudent->getFullName() << " has reached their maximum allowed credits this semester."
-                     << endl;
-            }
-                // in case all conditions are met we can jump into the registration process
-            else {
-
-                // we register the course to the student and the student to the course
-                resultStudent->addCourse(resultCourse->getCourseCode());
-                resultCourse->registerStudent(resultStudent->getStudentId(), resultStudent->getFullName());
-
-
-                // we increment the amount of credit registered into the original amount
-
-                resultStudent->setNumberOfCredits(
-                        resultStudent->getNumberOfcredits() + resultCourse->getNumberOfCredits());
-                cout << "Successfully register the student" << endl;
-            }
-
-        } else
-            cerr << "The course is not offered." << endl;
+        bundle.push_back(toUpperCase(courseId));
 
         // we check if the user want to register more courses to the same student
         do {
@@ -630,11 +959,17 @@ void option8(LListWithDummyNode<Student> &unregistered,
     } while (choice != 'N' && choice != 'n');
 
 
-    // we remove the student from the unregistered list if we successfully added at least one course
-    if (resultStudent->getNumberOfcredits() != 0) {
-        registered.insertAtBegin(*resultStudent);
-        unregistered.deleteAtElement(*resultStudent);
-    }
+    // all the courses are registered together, if one of them is refused none of them is registered
+    string failedCourse;
+    RegistrationResult result = registry.registerBundle(studentId, bundle, failedCourse);
+
+    if (result == REGISTRATION_OK)
+        cout << "Successfully register the student" << endl;
+    else if (result == JOURNAL_FAILED)
+        cerr << resultMessage(result) << endl;
+    else
+        cerr << failedCourse << ": " << resultMessage(result) << endl
+             << "None of the courses have been registered." << endl;
 
     cout << endl << "Press enter to proceed  <*__]" << endl;
     cin.ignore();
@@ -643,9 +978,7 @@ void option8(LListWithDummyNode<Student> &unregistered,
 }
 
 
-void option9(LListWithDummyNode<Student> &registeredList,
-             LListWithDummyNode<Student> &unregistered,
-             DoublyLinkedList<Course> &courseList) {
+void option9(Registry &registry) {
     string courseId, studentId; // to store the courseid and studentid
     bool validS; // checks if the student id is valid
 
@@ -667,18 +1000,12 @@ void option9(LListWithDummyNode<Student> &registeredList,
     // making studentId capital so it can successfully search for other course with this id
     studentId = toUpperCase(studentId);
 
-    // creating a pointer to object student such as the id is equals to studentId
-    Student *resultStudent = registeredList.searchAndRetreivePtr(Student(NULL, studentId));
-
-
-    // checking to make sure we result student is pointing at  the object student we looking for
-    if (resultStudent == nullptr) {
 
-        // in case we don't find him in the unregistered list we check if the student is already registered
-        resultStudent = unregistered.searchAndRetreivePtr(Student(NULL, studentId));
+    // checking to make sure the student exists and is in the registered list
+    if (!registry.isRegistered(studentId)) {
 
-        // we check if we got what we looking for if we don't we terminate the session in option 8
-        if (resultStudent == nullptr)
+        // we check if we got what we looking for if we don't we terminate the session in option 9
+        if (registry.findStudent(studentId) == nullptr)
             cerr << "The student you are looking for doesn't exists!" << endl;
         else
             cerr << "The student you are looking for exists but isn't registered yet." << endl;
@@ -691,7 +1018,7 @@ void option9(LListWithDummyNode<Student> &registeredList,
     }
 
 
-    resultStudent->displayRegisteredCourse();
+    registry.findStudent(studentId)->displayRegisteredCourse();
     cout << endl << endl;
 
     do {
@@ -705,110 +1032,336 @@ void option9(LListWithDummyNode<Student> &registeredList,
         cin >> courseId;
         courseId = toUpperCase(courseId);
 
-        // storing in a pointer the address of the object we looking for
-        Course *resultCourse = courseList.searchAndRetreivePtr(Course(NULL, courseId));
+        // the registry checks the course, the capacity and the credits and moves the student between the
+        // registered and unregistered lists when needed
+        RegistrationResult result;
+        if (daChoice == 'a' || daChoice == 'A') {
+            result = registry.addCourse(studentId, courseId);
+            if (result == REGISTRATION_OK)
+                cout << "Successfully registered the course." << endl;
+        } else {
+            result = registry.dropCourse(studentId, courseId);
+            if (result == REGISTRATION_OK)
+                cout << "Successfully dropped the student." << endl;
+        }
 
-        bool alreadytaken; // stores if the value that indicates that the course is already taken by the student
+        if (result != REGISTRATION_OK)
+            cerr << resultMessage(result) << endl;
 
-        // making sure the value is valid
-        if (resultCourse == nullptr) {
-            cerr << "The course is not offered." << endl;
-        } else if (daChoice == 'a' || daChoice == 'A') {
-            alreadytaken = false;
+        // we check if the user want to register or drop more courses to the same student
+        do {
+            cout << "Do you need to add more courses [Y] yes or [N] no: ";
+            cin >> nyChoice;
+        } while (nyChoice != 'N' && nyChoice != 'Y' && nyChoice != 'n' && nyChoice != 'y');
 
-            // we check if the course we wanna add is already registered by the student
-            for (int i = 0; i < resultStudent->getRegisteredCourse().size() && !alreadytaken; i++)
-                if (resultStudent->getRegisteredCourse()[i] == resultCourse->getCourseCode())
-                    alreadytaken = true;
+    } while (nyChoice != 'N' && nyChoice != 'n');
 
+    cout << endl << endl;
+    cout << "Press enter to proceed  <*__]" << endl;
+    cin.ignore();
+    cin.get();
 
-            // validating already taken if it returns true the registration process is stopped
-            if (alreadytaken)
-                cerr << "The course is already registered by this student." << endl;
-                // making sure that the course capacity isn't full
-            else if (resultCourse->getCapacity() <= resultCourse->getNumberOfEnrolled()) {
-                cerr << "The course has already reached its maximum capacity!!" << endl;
-            }
-                // making sure that the regular student doesn't exceed 18 credits
-            else if (resultStudent->getNumberOfcredits() + resultCourse->getNumberOfCredits() > 12
-                     && resultStudent->getGpa() < 2) {
-                cerr << resultStudent->getFullName()
-                     << " has reached their maximum allowed credits this semester as "
-                        "they are in probation."
-                     << endl;
-            }
-                // making sure the student on probation hasn't exceeded 12 credits
-            else if (resultStudent->getNumberOfcredits() + resultCourse->getNumberOfCredits() > 18
-                     && resultStudent->getGpa() >= 2) {
-                cerr << resultStudent->getFullName() << " has reached their maximum allowed credits this semester."
-                     << endl;
-            }
-                // in case all conditions are met we can jump into the registration process
-            else {
+}
 
-                // we register the course to the student and the student to the course
-                resultStudent->addCourse(resultCourse->getCourseCode());
-                resultCourse->registerStudent(resultStudent->getStudentId(), resultStudent->getFullName());
 
+void option10(const TermDirectory &terms) {
+    // every enrollment is already in the journal, the snapshots only make the next start faster
+    terms.forEach([](Term &term) { term.registry->saveSnapshot(term.registry->getSnapshotPath()); });
 
-                // we increment the amount of credit registered into the original amount
+    cout << "Thanks for using using our registration service for any sort of assistance make sure"
+            " to contact us\non +961 81-445-042 or via email on team4@freelabor.com.lb";
 
-                resultStudent->setNumberOfCredits(
-                        resultStudent->getNumberOfcredits() + resultCourse->getNumberOfCredits());
+    exit(0);
+}
 
-                cout << "Successfully registered the course." << endl;
 
-            }
+void option11(Registry &registry) {
+    string filename;
 
-        } else if (daChoice == 'd' || daChoice == 'D') {
-            alreadytaken = false;
+    cout << "Enter the path of the requests file: ";
+    cin >> filename;
+    cout << endl;
 
-            // we check if the course we wanna add is already registered by the student
-            for (int i = 0; i < resultStudent->getRegisteredCourse().size() && !alreadytaken; i++)
-                if (resultStudent->getRegisteredCourse()[i] == resultCourse->getCourseCode())
-                    alreadytaken = true;
+    // readFileAndParseContent ends the program if the file is missing, so we check it first
+    if (!ifstream(filename).is_open()) {
+        cerr << "Failed to open the file " << filename << endl;
+        cout << "Press enter to proceed  <*__]" << endl;
+        cin.ignore();
+        cin.get();
+        return;
+    }
 
-            if (alreadytaken) {
+    // each line is a student ID followed by the course codes of the request
+    vector<string> requestFileContent = readFileAndParseContent("Request", filename);
+    RegistrationScheduler scheduler(registry);
+    for (size_t i = 0; i < requestFileContent.size(); i++) {
+        vector<string> values = split(requestFileContent[i]);
+        if (values.empty())
+            continue;
+
+        vector<string> courseCodes;
+        for (size_t j = 1; j < values.size(); j++)
+            courseCodes.push_back(toUpperCase(values[j]));
+        scheduler.submit(toUpperCase(values[0]), courseCodes);
+    }
 
-                //removing the student from the registered students list and removing the student from the registered course list
-                resultStudent->dropCourse(resultCourse->getCourseCode());
-                resultCourse->dropStudent(resultStudent->getStudentId());
+    int accepted = scheduler.run(REGISTRATION_BATCH_SIZE);
 
-                // remove the number of credits from the total credit taken by the student
-                resultStudent->setNumberOfCredits(
-                        resultStudent->getNumberOfcredits() - resultCourse->getNumberOfCredits());
+    // count the refused requests by reason
+    map<string, int> refused;
+    for (const RegistrationRequest &request: scheduler.getRequests()) {
+        if (request.bundle.result != REGISTRATION_OK)
+            refused[resultMessage(request.bundle.result)]++;
+    }
 
-                cout << "Successfully dropped the student." << endl;
+    cout << endl << scheduler.getRequests().size() << " requests applied in "
+         << scheduler.getElapsedMilliseconds() << " ms." << endl
+         << accepted << " students registered." << endl;
+    for (auto itr = refused.begin(); itr != refused.end(); ++itr)
+        cerr << itr->second << " refused: " << itr->first << endl;
 
-            }
+    cout << endl << "Press enter to proceed  <*__]" << endl;
+    cin.ignore();
+    cin.get();
+}
 
-        }
-        // we check if the user want to register or drop more courses to the same student
-        do {
-            cout << "Do you need to add more courses [Y] yes or [N] no: ";
-            cin >> nyChoice;
-        } while (nyChoice != 'N' && nyChoice != 'Y' && nyChoice != 'n' && nyChoice != 'y');
 
-    } while (nyChoice != 'N' && nyChoice != 'n');
+void option12(Registry &registry) {
+    if (registry.startCheckpoint(registry.getSnapshotPath()))
+        cout << "Checkpoint started, the registrations continue while it is written." << endl;
+    else
+        cerr << "A checkpoint is already being written." << endl;
 
-    if (resultStudent->getRegisteredCourse().size() == 0) {
-        unregistered.insertAtBegin(*resultStudent);
-        unregistered.deleteAtElement(*resultStudent);
-    }
+    CheckpointStats stats = registry.getCheckpointStats();
+    if (stats.checkpoints > 0)
+        cout << "Last checkpoint: " << stats.enrollments << " enrollments up to journal record " << stats.sequence
+             << ", registrations paused " << stats.pauseMicroseconds << " us, written in "
+             << stats.durationMilliseconds << " ms." << endl;
 
-    cout << endl << endl;
-    cout << "Press enter to proceed  <*__]" << endl;
+    cout << endl << "Press enter to proceed  <*__]" << endl;
     cin.ignore();
     cin.get();
+}
+
 
+void option13(Term &term) {
+    auto start = chrono::steady_clock::now();
+    bool saved = term.registry->exportText("C:\\Users\\johnn\\CLionProjects\\DsProject\\", term.fileSuffix);
+    double milliseconds = chrono::duration<double, milli>(chrono::steady_clock::now() - start).count();
+
+    if (saved)
+        cout << "The data files were saved in " << milliseconds << " ms." << endl;
+    else
+        cerr << "Some data files couldn't be saved, they keep their previous content." << endl;
+
+    cout << endl << "Press enter to proceed  <*__]" << endl;
+    cin.ignore();
+    cin.get();
 }
 
 
-void option10() {
-    cout << "Thanks for using using our registration service for any sort of assistance make sure"
-            " to contact us\non +961 81-445-042 or via email on team4@freelabor.com.lb";
+void option14(Registry &registry) {
+    if (registry.startCompaction())
+        cout << "Compaction started, the registrations continue while the journal is folded into the snapshot." << endl;
+    else
+        cerr << "A checkpoint or a compaction is already running." << endl;
 
-    exit(0);
+    CompactionStats stats = registry.getCompactionStats();
+    if (stats.compactions > 0)
+        cout << "Last compaction: " << stats.foldedRecords << " journal records folded into " << stats.liveEnrollments
+             << " enrollments up to journal record " << stats.sequence << ", " << stats.deadRecords
+             << " dead records dropped, " << stats.bytes << " bytes in " << stats.durationMilliseconds << " ms." << endl;
+
+    cout << endl << "Press enter to proceed  <*__]" << endl;
+    cin.ignore();
+    cin.get();
+}
+
+
+void option15(Term &term) {
+    vector<string> courseFileContent = readFileAndParseContent("Course", "C:\\Users\\johnn\\CLionProjects\\DsProject\\Course" +
+                                                                         term.fileSuffix + ".txt");
+    CatalogReload reload = term.registry->reloadCourses(courseFileContent);
+
+    cout << reload.added << " courses added, " << reload.capacityChanges << " capacities, " << reload.creditChanges
+         << " credits, " << reload.scheduleChanges << " meeting times and " << reload.titleChanges
+         << " titles changed." << endl;
+    if (reload.overfull > 0)
+        cout << reload.overfull << " courses now have more students than seats, they keep them and are closed." << endl;
+    if (reload.sectionedCourses > 0)
+        cout << reload.sectionedCourses << " courses are split in sections, their capacity comes from Section.txt." << endl;
+    if (reload.coordinatedSeats > 0)
+        cout << reload.coordinatedSeats << " new courses or capacities were refused, the shards count the seats of the start." << endl;
+    if (reload.missing > 0)
+        cout << reload.missing << " courses are not in Course.txt anymore, they are kept with their students." << endl;
+
+    cout << endl << "Press enter to proceed  <*__]" << endl;
+    cin.ignore();
+    cin.get();
+}
+
+
+void option16(TermDirectory &terms) {
+    cout << "Open terms:" << endl;
+    terms.forEach([&terms](Term &term) {
+        cout << (&term == &terms.getCurrentTerm() ? "* " : "  ") << term.name << endl;
+    });
+
+    string name;
+    cout << endl << "Enter the name of the term: ";
+    cin >> name;
+    name = toUpperCase(name);
+
+    if (terms.switchTerm(name))
+        cout << "The menu now works on the term " << name << "." << endl;
+    else
+        cerr << "There is no term " << name << ", the current term is unchanged." << endl;
+
+    cout << endl << "Press enter to proceed  <*__]" << endl;
+    cin.ignore();
+    cin.get();
+}
+
+
+void option17(TermDirectory &terms) {
+    string name;
+    cout << "Enter the name of the term: ";
+    cin >> name;
+    name = toUpperCase(name);
+    string path = "C:\\Users\\johnn\\CLionProjects\\DsProject\\Archive-" + name + ".dsa";
+
+    TermArchive archive;
+    bool ready = false;
+    Term *term = terms.findTerm(name);
+    if (term == &terms.getCurrentTerm()) {
+        cerr << "The term " << name << " is the current term, switch to another term before archiving it." << endl;
+    } else if (term != nullptr) {
+        archive.build(term->registry->pinView());
+        ready = archive.save(path);
+        if (ready) {
+            terms.closeTerm(name);
+            cout << "The term " << name << " was archived to " << path << " and closed." << endl;
+            if (!writeTermFile(terms, "C:\\Users\\johnn\\CLionProjects\\DsProject\\Term.txt"))
+                cerr << "Term.txt can't be written, the term " << name << " will be opened again at the next start."
+                     << endl;
+        }
+    } else {
+        ready = archive.load(path);
+    }
+
+    if (ready && archive.getNumberOfRows() > 0) {
+        // the size of the same enrollments as records of a snapshot, for comparison
+        unsigned long long rawBytes = archive.getNumberOfRows() * sizeof(JournalRecord);
+        cout << archive.getNumberOfRows() << " enrollments of " << archive.getNumberOfStudents() << " students in "
+             << archive.getCompressedBytes() << " bytes (" << rawBytes << " bytes as snapshot records, "
+             << (double) rawBytes / archive.getCompressedBytes() << " times smaller)." << endl;
+
+        auto start = chrono::steady_clock::now();
+        vector<unsigned long long> enrollments = archive.countEnrollmentsPerCourse();
+        vector<unsigned long long> credits = archive.sumCreditsPerStudent();
+        double milliseconds = chrono::duration<double, milli>(chrono::steady_clock::now() - start).count();
+        cout << "Two scans of the archive took " << milliseconds << " ms." << endl << endl;
+
+        unsigned long long totalCredits = 0;
+        for (unsigned long long studentCredits: credits)
+            totalCredits += studentCredits;
+        cout << "Credits taken in the term: " << totalCredits << endl;
+
+        vector<int> handles;
+        for (int i = 0; i < archive.getNumberOfCourses(); i++)
+            handles.push_back(i);
+        sort(handles.begin(), handles.end(), [&enrollments](int first, int second) {
+            return enrollments[first] > enrollments[second];
+        });
+        cout << "Most followed courses:" << endl;
+        for (int i = 0; i < (int) handles.size() && i < 5; i++)
+            cout << archive.getCourseCode(handles[i]) << ": " << enrollments[handles[i]] << " students" << endl;
+    } else if (ready) {
+        cout << "The archive of the term " << name << " holds no enrollment." << endl;
+    }
+
+    cout << endl << "Press enter to proceed  <*__]" << endl;
+    cin.ignore();
+    cin.get();
+}
+
+
+void option18(Registry &registry) {
+    string line;
+    cout << "Enter the query, eg: STUDENTS STATUS=PROBATION CREDITS=-8 or COURSES PREFIX=CSIS SEATS=1-" << endl;
+    cin.ignore();
+    getline(cin, line);
+
+    vector<string> words;
+    string word;
+    istringstream stream(toUpperCase(line));
+    while (stream >> word)
+        words.push_back(word);
+
+    StudentFilter studentFilter;
+    CourseFilter courseFilter;
+    QueryResult result;
+    if (!words.empty() && words[0] == "STUDENTS" && parseStudentFilter(words, 1, studentFilter)) {
+        result = registry.findStudents(studentFilter);
+        printf("%-17s%-23s%-6s%-20s\n\n", "ID", "Name", "Gpa", "Academic Status");
+        for (const string &studentId: result.keys) {
+            const Student *student = registry.findStudent(studentId);
+            if (student != nullptr)
+                student->displayTabular(cout);
+        }
+    } else if (!words.empty() && words[0] == "COURSES" && parseCourseFilter(words, 1, courseFilter)) {
+        result = registry.findCourses(courseFilter);
+        printf("%-15s%-35s%-15s%-15s%-15s%-20s\n\n", "Code", "Title", "# Credit", "Enrolled", "Capacity", "Schedule");
+        for (const string &courseCode: result.keys) {
+            const Course *course = registry.findCourse(courseCode);
+            if (course != nullptr)
+                course->displayTabular(cout);
+        }
+    } else {
+        cerr << "The query must start with STUDENTS followed by STATUS=REGULAR|PROBATION, GPA=<min>-<max>, "
+                "CREDITS=<min>-<max> or REGISTERED=YES|NO, or with COURSES followed by PREFIX=<code>, "
+                "CREDITS=<min>-<max> or SEATS=<min>-<max>." << endl;
+        cout << "Press enter to proceed  <*__]" << endl;
+        cin.get();
+        return;
+    }
+
+    cout << endl << result.keys.size() << " found from the " << result.plan << ", " << result.examined
+         << " rows read." << endl;
+    cout << endl << "Press enter to proceed  <*__]" << endl;
+    cin.get();
+}
+
+
+void setUpTerm(Term &term, const vector<string> &prerequisiteLines, const vector<string> &sectionLines,
+               const vector<string> &transcriptLines, const string &shardSuffix) {
+    Registry &registry = *term.registry;
+
+// the closure of the prerequisites is computed once here, registrations then only compare bitsets
+    registry.loadPrerequisites(prerequisiteLines, transcriptLines);
+// the courses listed in the section file are split in sections, registrations fill the least loaded one first
+    registry.loadSections(sectionLines);
+
+// the enrollments of the previous runs are restored from the snapshot and the journal written after it,
+// the new ones are appended to the journal
+    string suffix = term.fileSuffix + shardSuffix;
+    string snapshotPath = "C:\\Users\\johnn\\CLionProjects\\DsProject\\Snapshot" + suffix + ".bin";
+    string journalPath = "C:\\Users\\johnn\\CLionProjects\\DsProject\\Journal" + suffix + ".bin";
+// a data directory without them starts from the enrollments saved to Enrollment.txt by option 13, a shard only
+// holds some of the students and starts from its own files
+    int imported = !shardSuffix.empty() ? 0 : registry.importEnrollments(
+            "C:\\Users\\johnn\\CLionProjects\\DsProject\\Enrollment" + term.fileSuffix + ".txt", snapshotPath,
+            journalPath);
+    if (imported > 0)
+        cout << imported << " enrollments of term " << term.name << " were imported from its Enrollment file." << endl;
+    if (!registry.recover(snapshotPath, journalPath, thread::hardware_concurrency())) {
+        cerr << "The enrollments of term " << term.name << " can't be restored, the program will end." << endl;
+        exit(1);
+    }
+    const RecoveryStats &recovery = registry.getRecoveryStats();
+    cout << "Term " << term.name << " recovered in " << recovery.milliseconds << " ms: " << recovery.snapshotEnrollments
+         << " enrollments from the snapshot and " << recovery.journalRecords << " journal records replayed on "
+         << recovery.threads << " threads." << endl;
 }
 
 
@@ -825,7 +1378,15 @@ int displayMenuAndTakeOption(ostream &out, istream &in) {
             << "7. Display the information related to a specific student." << endl
             << "8. Register a student." << endl
             << "9. Choose a student to add/drop a course for him/her." << endl
-            << "10. Quit the application." << endl << endl;
+            << "10. Quit the application." << endl
+            << "11. Open a registration window from a requests file." << endl
+            << "12. Write a checkpoint of the enrollments in the background." << endl
+            << "13. Save the students, courses and enrollments back to the data files." << endl
+            << "14. Compact the journal into a fresh snapshot in the background." << endl
+            << "15. Reload the course catalog from Course.txt." << endl
+            << "16. Switch to another term." << endl
+            << "17. Archive a closed term, or summarize an archived term." << endl
+            << "18. Find students or courses by their fields." << endl << endl;
 
     int option;
 
@@ -834,12 +1395,12 @@ int displayMenuAndTakeOption(ostream &out, istream &in) {
         out << "Enter your choice: ";
         in >> option;
 
-        if (in.fail() || option < 1 || option > 10) {
+        if (in.fail() || option < 1 || option > NUMBER_OF_OPTIONS) {
             in.clear();  // Clear error flags
             in.ignore(numeric_limits<streamsize>::max(), '\n'); // Consume invalid input
-            cerr << "Invalid choice. Please enter a number between 1 and 10." << endl;
+            cerr << "Invalid choice. Please enter a number between 1 and " << NUMBER_OF_OPTIONS << "." << endl;
         }
-    } while (in.fail() || option < 1 || option > 10);
+    } while (in.fail() || option < 1 || option > NUMBER_OF_OPTIONS);
 
     out << endl << endl << endl;
 
@@ -848,12 +1409,18 @@ int displayMenuAndTakeOption(ostream &out, istream &in) {
 
 
 
-vector<string> readFileAndParseContent(string title, const string &filename) {
+vector<string> readFileAndParseContent(string title, const string &filename, bool optional) {
     vector<string> content;
 
     try {
         ifstream inputFile(filename);
 
+        // the files added after the first version, eg: Prerequisite.txt, may not exist in older data directories
+        if (!inputFile.is_open() && optional) {
+            cout << endl << "No " << title << " file at " << filename << ", none was read." << endl;
+            return content;
+        }
+
         if (!inputFile.is_open()) {
             throw runtime_error(
                     "Failed to open the file.\nPlease double-check if the file exists or if there "
@@ -866,7 +1433,9 @@ vector<string> readFileAndParseContent(string title, const string &filename) {
         content.resize(arraySize);
 
         for (int i = 0; i < arraySize && getline(inputFile, content[i]); i++) {
-            content[i];
+            // remove the carriage return left by files saved with Windows line endings
+            if (!content[i].empty() && content[i][content[i].length() - 1] == '\r')
+                content[i].erase(content[i].length() - 1);
         }
 
         cout << endl << content.size() << " " << title << (content.size() > 1 ? "s" : "")
@@ -889,4 +1458,80 @@ vector<string> readFileAndParseContent(string title, const string &filename) {
 }
 
 
+bool writeTermFile(const TermDirectory &terms, const string &path) {
+    vector<string> names;
+    terms.forEach([&names](const Term &term) {
+        if (term.name != "CURRENT")
+            names.push_back(term.name);
+    });
 
+    BufferedTextFile file(path);
+    file.writeInteger(names.size());
+    file.write('\n');
+    for (const string &name: names) {
+        file.write(name);
+        file.write('\n');
+    }
+    return file.commit();
+}
+
+
+template<typename Element, typename Record, template<typename> class List>
+void openMappedRecords(List<Mapped<Record>> &records, const string &title, const string &textPath,
+                       const string &mapPath) {
+    struct stat textStatus, mapStatus;
+    bool mapExists = stat(mapPath.c_str(), &mapStatus) == 0;
+    bool textChanged = stat(textPath.c_str(), &textStatus) == 0 &&
+                       (!mapExists || textStatus.st_mtim.tv_sec > mapStatus.st_mtim.tv_sec ||
+                        (textStatus.st_mtim.tv_sec == mapStatus.st_mtim.tv_sec &&
+                         textStatus.st_mtim.tv_nsec > mapStatus.st_mtim.tv_nsec));
+
+    if (!records.open(mapPath)) {
+        cerr << "The " << title << "s can't be kept in " << mapPath << ", the program will end." << endl;
+        exit(1);
+    }
+
+    if (records.isEmpty() || textChanged) {
+        vector<string> lines = readFileAndParseContent(title, textPath);
+        records.clear();
+        Record record;
+        for (const string &line: lines) {
+            // a value longer than its field would be cut and differ from the data file, the line is refused
+            if (Element(line).toRecord(record))
+                records.insertAtEnd(record);
+            else
+                cerr << "The " << title << " \"" << line << "\" is invalid or has a value longer than " << mapPath
+                     << " can hold and was skipped." << endl;
+        }
+        records.sync();
+    } else {
+        cout << endl << records.getSize() << " " << title << (records.getSize() > 1 ? "s" : "")
+             << "  have been mapped from the file " << mapPath << endl;
+    }
+}
+
+
+int serveTerms(TermDirectory &terms, const string &address, bool replicas) {
+    RegistrationServer server(terms);
+    bool listening = address.find_first_not_of("0123456789") == string::npos ? server.listenTcp(stoi(address))
+                                                                             : server.listenUnix(address);
+    if (!listening)
+        return 1;
+    if (replicas && !server.openReplicas())
+        return 1;
+
+    cout << "Serving the registry on " << address << ", stop with Ctrl+C." << endl;
+    server.run(cout);
+    const ServerStats &stats = server.getStats();
+    const LatencyHistogram &latencies = server.getLatencies();
+    cout << stats.requests << " requests answered on " << stats.accepted << " connections, "
+         << stats.deferred << " after waiting for the journal. Latency p50 " << llround(latencies.percentile(50))
+         << " us, p99 " << llround(latencies.percentile(99)) << " us, p99.9 "
+         << llround(latencies.percentile(99.9)) << " us." << endl;
+    const AdmissionStats &admission = server.getAdmission();
+    cout << admission.admitted << " registrations let in, " << admission.shed << " shed with a retry-after, at most "
+         << admission.maximumDepth << " waiting for the journal (limit " << admission.limit << ")." << endl;
+
+    terms.forEach([](Term &term) { term.registry->saveSnapshot(term.registry->getSnapshotPath()); });
+    return 0;
+}